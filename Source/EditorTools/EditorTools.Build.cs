@@ -46,6 +46,9 @@ public class EditorTools : ModuleRules
 				"RawMesh",
 				"AssetRegistry",
 				"UnrealEd",
+				"EditorSubsystem",
+				"DeveloperToolSettings",
+				"EngineSettings",
 				"AssetTools",
 				"ToolMenus",
 				"Persona",
@@ -0,0 +1,148 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Analysis/EditorToolsMaterialStatsCache.h"
+#include "MaterialShared.h"
+#include "MeshMaterialShader.h"
+#include "Misc/ScopeRWLock.h"
+
+FEditorToolsMaterialStatsCache* FEditorToolsMaterialStatsCache::Instance = nullptr;
+
+namespace
+{
+	static int32 GetInstructionCount(const FShader* Shader)
+	{
+		return Shader ? (int32)Shader->GetNumInstructions() : 0;
+	}
+
+	/** 读取表面材质的基础通道 VS/PS（FLocalVertexFactory + 无光照贴图），与材质编辑器 Stats 面板的“Base pass shader”一致 */
+	static bool GatherSurfaceShaderStats(const FMaterialShaderMap& ShaderMap, FEditorToolsMaterialShaderStats& OutStats)
+	{
+		static const FHashedName LocalVertexFactoryName(TEXT("FLocalVertexFactory"));
+		static const FHashedName BasePassVSName(TEXT("TBasePassVSFNoLightMapPolicy"));
+		static const FHashedName BasePassPSName(TEXT("TBasePassPSFNoLightMapPolicy"));
+
+		const FMeshMaterialShaderMap* MeshShaderMap = ShaderMap.GetMeshShaderMap(LocalVertexFactoryName);
+		if (!MeshShaderMap)
+		{
+			return false;
+		}
+
+		const FShader* PixelShader = MeshShaderMap->GetShader(BasePassPSName);
+		if (!PixelShader)
+		{
+			return false;
+		}
+
+		OutStats.PixelShaderInstructionCount = GetInstructionCount(PixelShader);
+		OutStats.VertexShaderInstructionCount = GetInstructionCount(MeshShaderMap->GetShader(BasePassVSName));
+		return true;
+	}
+
+	/** 读取后处理材质的 VS/PS */
+	static bool GatherPostProcessShaderStats(const FMaterialShaderMap& ShaderMap, FEditorToolsMaterialShaderStats& OutStats)
+	{
+		static const FHashedName PostProcessVSName(TEXT("FPostProcessMaterialVS"));
+		static const FHashedName PostProcessPSName(TEXT("FPostProcessMaterialPS"));
+
+		const FShader* PixelShader = ShaderMap.GetContent()->GetShader(PostProcessPSName);
+		if (!PixelShader)
+		{
+			return false;
+		}
+
+		OutStats.PixelShaderInstructionCount = GetInstructionCount(PixelShader);
+		OutStats.VertexShaderInstructionCount = GetInstructionCount(ShaderMap.GetContent()->GetShader(PostProcessVSName));
+		return true;
+	}
+}
+
+void FEditorToolsMaterialStatsCache::Initialize()
+{
+	if (!Instance)
+	{
+		Instance = new FEditorToolsMaterialStatsCache();
+	}
+}
+
+void FEditorToolsMaterialStatsCache::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FEditorToolsMaterialStatsCache& FEditorToolsMaterialStatsCache::Get()
+{
+	if (!Instance)
+	{
+		check(IsInGameThread());
+		Initialize();
+	}
+	return *Instance;
+}
+
+FEditorToolsMaterialShaderStatsPtr FEditorToolsMaterialStatsCache::GetShaderMapStats(const FMaterialShaderMap* ShaderMap)
+{
+	if (!ShaderMap)
+	{
+		return nullptr;
+	}
+
+	const FShaderMapKey Key = MakeKey(ShaderMap);
+	if (FEditorToolsMaterialShaderStatsPtr Existing = FindEntry(Key))
+	{
+		return Existing;
+	}
+
+	FEditorToolsMaterialShaderStats Stats;
+	Stats.bHasRepresentativeShaders = GatherSurfaceShaderStats(*ShaderMap, Stats) || GatherPostProcessShaderStats(*ShaderMap, Stats);
+
+	const FMaterialCompilationOutput& CompilationOutput = ShaderMap->GetMaterialCompilationOutput();
+	Stats.VertexTextureSampleCount = CompilationOutput.EstimatedNumTextureSamplesVS;
+	Stats.PixelTextureSampleCount = CompilationOutput.EstimatedNumTextureSamplesPS;
+
+	return AddEntry(Key, MoveTemp(Stats));
+}
+
+void FEditorToolsMaterialStatsCache::Reset()
+{
+	FWriteScopeLock WriteLock(EntriesLock);
+	Entries.Reset();
+}
+
+int32 FEditorToolsMaterialStatsCache::Num() const
+{
+	FReadScopeLock ReadLock(EntriesLock);
+	return Entries.Num();
+}
+
+FEditorToolsMaterialStatsCache::FShaderMapKey FEditorToolsMaterialStatsCache::MakeKey(const FMaterialShaderMap* ShaderMap)
+{
+	// 材质哈希包含静态参数、特性等级和质量等级，平台单独作为键的一部分
+	FSHAHash MaterialHash;
+	ShaderMap->GetShaderMapId().GetMaterialHash(MaterialHash);
+	return FShaderMapKey(MaterialHash, ShaderMap->GetShaderPlatform());
+}
+
+FEditorToolsMaterialShaderStatsPtr FEditorToolsMaterialStatsCache::FindEntry(const FShaderMapKey& Key) const
+{
+	FReadScopeLock ReadLock(EntriesLock);
+	if (const FEditorToolsMaterialShaderStatsPtr* Found = Entries.Find(Key))
+	{
+		return *Found;
+	}
+	return nullptr;
+}
+
+FEditorToolsMaterialShaderStatsPtr FEditorToolsMaterialStatsCache::AddEntry(const FShaderMapKey& Key, FEditorToolsMaterialShaderStats&& Stats)
+{
+	FEditorToolsMaterialShaderStatsPtr NewEntry = MakeShared<const FEditorToolsMaterialShaderStats, ESPMode::ThreadSafe>(MoveTemp(Stats));
+
+	FWriteScopeLock WriteLock(EntriesLock);
+	// 其他线程可能已经先写入了同一个着色器图，保留先写入的结果
+	if (const FEditorToolsMaterialShaderStatsPtr* Found = Entries.Find(Key))
+	{
+		return *Found;
+	}
+	Entries.Add(Key, NewEntry);
+	return NewEntry;
+}
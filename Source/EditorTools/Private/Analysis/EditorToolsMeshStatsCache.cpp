@@ -0,0 +1,171 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Analysis/EditorToolsMeshStatsCache.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "StaticMeshResources.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "UObject/UObjectGlobals.h"
+#include "Misc/ScopeRWLock.h"
+
+FEditorToolsMeshStatsCache* FEditorToolsMeshStatsCache::Instance = nullptr;
+
+void FEditorToolsMeshStatsCache::Initialize()
+{
+	if (!Instance)
+	{
+		Instance = new FEditorToolsMeshStatsCache();
+	}
+}
+
+void FEditorToolsMeshStatsCache::Shutdown()
+{
+	delete Instance;
+	Instance = nullptr;
+}
+
+FEditorToolsMeshStatsCache& FEditorToolsMeshStatsCache::Get()
+{
+	if (!Instance)
+	{
+		check(IsInGameThread());
+		Initialize();
+	}
+	return *Instance;
+}
+
+FEditorToolsMeshStatsCache::FEditorToolsMeshStatsCache()
+{
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FEditorToolsMeshStatsCache::OnObjectPropertyChanged);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FEditorToolsMeshStatsCache::OnPostGarbageCollect);
+}
+
+FEditorToolsMeshStatsCache::~FEditorToolsMeshStatsCache()
+{
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+}
+
+FEditorToolsMeshStatsPtr FEditorToolsMeshStatsCache::GetStaticMeshStats(const UStaticMesh* StaticMesh)
+{
+	if (!StaticMesh)
+	{
+		return nullptr;
+	}
+
+	if (FEditorToolsMeshStatsPtr Existing = FindEntry(StaticMesh))
+	{
+		return Existing;
+	}
+
+	const FStaticMeshRenderData* RenderData = StaticMesh->GetRenderData();
+	if (!RenderData)
+	{
+		return nullptr;
+	}
+
+	FEditorToolsMeshStats Stats;
+	Stats.LODs.Reserve(RenderData->LODResources.Num());
+	for (const FStaticMeshLODResources& LODResources : RenderData->LODResources)
+	{
+		FEditorToolsMeshLODStats& LODStats = Stats.LODs.AddDefaulted_GetRef();
+		LODStats.SectionCount = LODResources.Sections.Num();
+		for (const FStaticMeshSection& Section : LODResources.Sections)
+		{
+			LODStats.TriangleCount += Section.NumTriangles;
+		}
+	}
+
+	return AddEntry(StaticMesh, MoveTemp(Stats));
+}
+
+FEditorToolsMeshStatsPtr FEditorToolsMeshStatsCache::GetSkeletalMeshStats(const USkeletalMesh* SkeletalMesh)
+{
+	if (!SkeletalMesh)
+	{
+		return nullptr;
+	}
+
+	if (FEditorToolsMeshStatsPtr Existing = FindEntry(SkeletalMesh))
+	{
+		return Existing;
+	}
+
+	const FSkeletalMeshRenderData* RenderData = SkeletalMesh->GetResourceForRendering();
+	if (!RenderData)
+	{
+		return nullptr;
+	}
+
+	FEditorToolsMeshStats Stats;
+	Stats.LODs.Reserve(RenderData->LODRenderData.Num());
+	for (const FSkeletalMeshLODRenderData& LODData : RenderData->LODRenderData)
+	{
+		FEditorToolsMeshLODStats& LODStats = Stats.LODs.AddDefaulted_GetRef();
+		LODStats.SectionCount = LODData.RenderSections.Num();
+		for (const FSkelMeshRenderSection& Section : LODData.RenderSections)
+		{
+			LODStats.TriangleCount += Section.NumTriangles;
+		}
+	}
+
+	return AddEntry(SkeletalMesh, MoveTemp(Stats));
+}
+
+void FEditorToolsMeshStatsCache::Invalidate(const UObject* Mesh)
+{
+	FWriteScopeLock WriteLock(EntriesLock);
+	Entries.Remove(FObjectKey(Mesh));
+}
+
+void FEditorToolsMeshStatsCache::Reset()
+{
+	FWriteScopeLock WriteLock(EntriesLock);
+	Entries.Reset();
+}
+
+FEditorToolsMeshStatsPtr FEditorToolsMeshStatsCache::FindEntry(const UObject* Mesh) const
+{
+	FReadScopeLock ReadLock(EntriesLock);
+	if (const FEditorToolsMeshStatsPtr* Found = Entries.Find(FObjectKey(Mesh)))
+	{
+		return *Found;
+	}
+	return nullptr;
+}
+
+FEditorToolsMeshStatsPtr FEditorToolsMeshStatsCache::AddEntry(const UObject* Mesh, FEditorToolsMeshStats&& Stats)
+{
+	FEditorToolsMeshStatsPtr NewEntry = MakeShared<const FEditorToolsMeshStats, ESPMode::ThreadSafe>(MoveTemp(Stats));
+
+	FWriteScopeLock WriteLock(EntriesLock);
+	// 其他线程可能已经先写入了同一个网格体，保留先写入的结果
+	if (const FEditorToolsMeshStatsPtr* Found = Entries.Find(FObjectKey(Mesh)))
+	{
+		return *Found;
+	}
+	Entries.Add(FObjectKey(Mesh), NewEntry);
+	return NewEntry;
+}
+
+void FEditorToolsMeshStatsCache::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// 网格体的 PostEditChange（包括重新导入、LOD设置修改）都会经过这里
+	if (Object && (Object->IsA<UStaticMesh>() || Object->IsA<USkeletalMesh>()))
+	{
+		Invalidate(Object);
+	}
+}
+
+void FEditorToolsMeshStatsCache::OnPostGarbageCollect()
+{
+	FWriteScopeLock WriteLock(EntriesLock);
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,361 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Analysis/EditorToolsSceneIndexSubsystem.h"
+#include "Logging/EditorToolsLog.h"
+#include "Editor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/LightComponent.h"
+#include "UObject/UObjectGlobals.h"
+
+void UEditorToolsSceneIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (GEngine)
+	{
+		LevelActorAddedHandle = GEngine->OnLevelActorAdded().AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLevelActorAdded);
+		LevelActorDeletedHandle = GEngine->OnLevelActorDeleted().AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLevelActorDeleted);
+	}
+
+	ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnObjectModified);
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnObjectPropertyChanged);
+	ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnObjectsReplaced);
+	LevelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLevelChanged);
+	LevelRemovedFromWorldHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLevelChanged);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnWorldCleanup);
+	PostUndoRedoHandle = FEditorDelegates::PostUndoRedo.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnPostUndoRedo);
+	MapChangeHandle = FEditorDelegates::MapChange.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnMapChange);
+}
+
+void UEditorToolsSceneIndexSubsystem::Deinitialize()
+{
+	if (GEngine)
+	{
+		GEngine->OnLevelActorAdded().Remove(LevelActorAddedHandle);
+		GEngine->OnLevelActorDeleted().Remove(LevelActorDeletedHandle);
+	}
+
+	FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(ObjectsReplacedHandle);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedToWorldHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedFromWorldHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	FEditorDelegates::PostUndoRedo.Remove(PostUndoRedoHandle);
+	FEditorDelegates::MapChange.Remove(MapChangeHandle);
+
+	for (TPair<FObjectKey, FWorldSceneIndex>& Pair : WorldIndices)
+	{
+		UnbindLoadedActorEvents(Pair.Value);
+	}
+	WorldIndices.Empty();
+	TransientIndex = FWorldSceneIndex();
+
+	Super::Deinitialize();
+}
+
+const TArray<FEditorToolsSceneActorEntry>& UEditorToolsSceneIndexSubsystem::GetActorEntries(UWorld* World)
+{
+	check(IsInGameThread());
+
+	if (GEditor)
+	{
+		if (UEditorToolsSceneIndexSubsystem* Subsystem = GEditor->GetEditorSubsystem<UEditorToolsSceneIndexSubsystem>())
+		{
+			return Subsystem->GetOrUpdateEntries(World);
+		}
+	}
+
+	// 子系统不可用时（如编辑器尚未完成初始化）退回到临时构建
+	static FWorldSceneIndex FallbackIndex;
+	FallbackIndex = FWorldSceneIndex();
+	BuildFullIndex(World, FallbackIndex);
+	return FallbackIndex.Entries;
+}
+
+void UEditorToolsSceneIndexSubsystem::InvalidateWorld(UWorld* World)
+{
+	RemoveWorldIndex(World);
+}
+
+const TArray<FEditorToolsSceneActorEntry>& UEditorToolsSceneIndexSubsystem::GetOrUpdateEntries(UWorld* World)
+{
+	if (!World || World->WorldType != EWorldType::Editor)
+	{
+		TransientIndex = FWorldSceneIndex();
+		BuildFullIndex(World, TransientIndex);
+		return TransientIndex.Entries;
+	}
+
+	FWorldSceneIndex& Index = FindOrAddWorldIndex(World);
+	if (Index.bNeedsFullRebuild)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		BuildFullIndex(World, Index);
+		UE_LOG(LogEditorTools, Verbose, TEXT("场景索引全量构建完成：%s，%d 个Actor，耗时 %.2f ms"),
+			*World->GetName(), Index.Entries.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+	else
+	{
+		ApplyPendingActors(Index);
+	}
+
+	return Index.Entries;
+}
+
+UEditorToolsSceneIndexSubsystem::FWorldSceneIndex& UEditorToolsSceneIndexSubsystem::FindOrAddWorldIndex(UWorld* World)
+{
+	const FObjectKey WorldKey(World);
+	if (FWorldSceneIndex* Index = WorldIndices.Find(WorldKey))
+	{
+		return *Index;
+	}
+
+	FWorldSceneIndex& Index = WorldIndices.Add(WorldKey);
+
+	// World Partition 按区域加载/卸载Actor时只通知持久关卡
+	if (World->IsPartitionedWorld() && World->PersistentLevel)
+	{
+		Index.PartitionedLevel = World->PersistentLevel;
+		Index.LoadedActorAddedHandle = World->PersistentLevel->OnLoadedActorAddedToLevelEvent.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLoadedActorAdded);
+		Index.LoadedActorRemovedHandle = World->PersistentLevel->OnLoadedActorRemovedFromLevelEvent.AddUObject(this, &UEditorToolsSceneIndexSubsystem::OnLoadedActorRemoved);
+	}
+	return Index;
+}
+
+void UEditorToolsSceneIndexSubsystem::RemoveWorldIndex(UWorld* World)
+{
+	const FObjectKey WorldKey(World);
+	if (FWorldSceneIndex* Index = WorldIndices.Find(WorldKey))
+	{
+		UnbindLoadedActorEvents(*Index);
+		WorldIndices.Remove(WorldKey);
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::UnbindLoadedActorEvents(FWorldSceneIndex& Index)
+{
+	if (ULevel* Level = Index.PartitionedLevel.Get())
+	{
+		Level->OnLoadedActorAddedToLevelEvent.Remove(Index.LoadedActorAddedHandle);
+		Level->OnLoadedActorRemovedFromLevelEvent.Remove(Index.LoadedActorRemovedHandle);
+	}
+	Index.PartitionedLevel.Reset();
+	Index.LoadedActorAddedHandle.Reset();
+	Index.LoadedActorRemovedHandle.Reset();
+}
+
+void UEditorToolsSceneIndexSubsystem::BuildFullIndex(UWorld* World, FWorldSceneIndex& Index)
+{
+	Index.Entries.Reset();
+	Index.EntryIndexByActor.Reset();
+	Index.PendingActors.Reset();
+	Index.bNeedsFullRebuild = false;
+
+	if (!World)
+	{
+		return;
+	}
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		UpsertActor(Index, *It);
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::ApplyPendingActors(FWorldSceneIndex& Index)
+{
+	for (const TPair<FObjectKey, TWeakObjectPtr<AActor>>& Pending : Index.PendingActors)
+	{
+		AActor* Actor = Pending.Value.Get();
+		if (IsValid(Actor))
+		{
+			UpsertActor(Index, Actor);
+		}
+		else if (const int32* EntryIndex = Index.EntryIndexByActor.Find(Pending.Key))
+		{
+			RemoveEntryAt(Index, *EntryIndex);
+		}
+	}
+	Index.PendingActors.Reset();
+}
+
+void UEditorToolsSceneIndexSubsystem::UpsertActor(FWorldSceneIndex& Index, AActor* Actor)
+{
+	if (!IsValid(Actor))
+	{
+		return;
+	}
+
+	const FObjectKey ActorKey(Actor);
+	FEditorToolsSceneActorEntry NewEntry;
+	const bool bRelevant = BuildActorEntry(Actor, NewEntry);
+
+	if (const int32* ExistingIndex = Index.EntryIndexByActor.Find(ActorKey))
+	{
+		if (bRelevant)
+		{
+			Index.Entries[*ExistingIndex] = MoveTemp(NewEntry);
+		}
+		else
+		{
+			RemoveEntryAt(Index, *ExistingIndex);
+		}
+	}
+	else if (bRelevant)
+	{
+		Index.EntryIndexByActor.Add(ActorKey, Index.Entries.Add(MoveTemp(NewEntry)));
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::RemoveEntryAt(FWorldSceneIndex& Index, int32 EntryIndex)
+{
+	const int32 LastIndex = Index.Entries.Num() - 1;
+	Index.EntryIndexByActor.Remove(Index.Entries[EntryIndex].ActorKey);
+	if (EntryIndex != LastIndex)
+	{
+		Index.EntryIndexByActor.Add(Index.Entries[LastIndex].ActorKey, EntryIndex);
+	}
+	Index.Entries.RemoveAtSwap(EntryIndex, 1, EAllowShrinking::No);
+}
+
+bool UEditorToolsSceneIndexSubsystem::BuildActorEntry(AActor* Actor, FEditorToolsSceneActorEntry& OutEntry)
+{
+	OutEntry = FEditorToolsSceneActorEntry();
+	OutEntry.Actor = Actor;
+	OutEntry.ActorKey = FObjectKey(Actor);
+
+	TInlineComponentArray<UActorComponent*> Components(Actor);
+	for (UActorComponent* Component : Components)
+	{
+		if (UStaticMeshComponent* StaticMeshComponent = Cast<UStaticMeshComponent>(Component))
+		{
+			OutEntry.StaticMeshComponents.Add(StaticMeshComponent);
+		}
+		else if (USkeletalMeshComponent* SkeletalMeshComponent = Cast<USkeletalMeshComponent>(Component))
+		{
+			OutEntry.SkeletalMeshComponents.Add(SkeletalMeshComponent);
+		}
+		else if (ULightComponent* LightComponent = Cast<ULightComponent>(Component))
+		{
+			OutEntry.LightComponents.Add(LightComponent);
+		}
+	}
+
+	return OutEntry.StaticMeshComponents.Num() > 0
+		|| OutEntry.SkeletalMeshComponents.Num() > 0
+		|| OutEntry.LightComponents.Num() > 0;
+}
+
+UEditorToolsSceneIndexSubsystem::FWorldSceneIndex* UEditorToolsSceneIndexSubsystem::FindIndexForActor(const AActor* Actor)
+{
+	UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+	if (!World || World->WorldType != EWorldType::Editor)
+	{
+		return nullptr;
+	}
+
+	FWorldSceneIndex* Index = WorldIndices.Find(FObjectKey(World));
+	return (Index && !Index->bNeedsFullRebuild) ? Index : nullptr;
+}
+
+void UEditorToolsSceneIndexSubsystem::MarkActorDirty(AActor* Actor)
+{
+	if (FWorldSceneIndex* Index = FindIndexForActor(Actor))
+	{
+		Index->PendingActors.Add(FObjectKey(Actor), Actor);
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::MarkAllWorldsForRebuild()
+{
+	for (TPair<FObjectKey, FWorldSceneIndex>& Pair : WorldIndices)
+	{
+		Pair.Value.bNeedsFullRebuild = true;
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::OnLevelActorAdded(AActor* Actor)
+{
+	MarkActorDirty(Actor);
+}
+
+void UEditorToolsSceneIndexSubsystem::OnLevelActorDeleted(AActor* Actor)
+{
+	if (FWorldSceneIndex* Index = FindIndexForActor(Actor))
+	{
+		const FObjectKey ActorKey(Actor);
+		Index->PendingActors.Remove(ActorKey);
+		if (const int32* EntryIndex = Index->EntryIndexByActor.Find(ActorKey))
+		{
+			RemoveEntryAt(*Index, *EntryIndex);
+		}
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::OnLoadedActorAdded(AActor& Actor)
+{
+	MarkActorDirty(&Actor);
+}
+
+void UEditorToolsSceneIndexSubsystem::OnLoadedActorRemoved(AActor& Actor)
+{
+	OnLevelActorDeleted(&Actor);
+}
+
+void UEditorToolsSceneIndexSubsystem::OnObjectModified(UObject* Object)
+{
+	// Modify 在修改之前触发，这里只记录待更新，查询时再读取修改后的状态
+	if (AActor* Actor = Cast<AActor>(Object))
+	{
+		MarkActorDirty(Actor);
+	}
+	else if (UActorComponent* Component = Cast<UActorComponent>(Object))
+	{
+		MarkActorDirty(Component->GetOwner());
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	OnObjectModified(Object);
+}
+
+void UEditorToolsSceneIndexSubsystem::OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap)
+{
+	// 蓝图重新编译会替换Actor和组件而不触发修改事件，替换后的对象所属Actor需要重新读取
+	for (const TPair<UObject*, UObject*>& Pair : ReplacementMap)
+	{
+		OnObjectModified(Pair.Value);
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::OnLevelChanged(ULevel* Level, UWorld* World)
+{
+	if (FWorldSceneIndex* Index = WorldIndices.Find(FObjectKey(World)))
+	{
+		Index->bNeedsFullRebuild = true;
+	}
+}
+
+void UEditorToolsSceneIndexSubsystem::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	RemoveWorldIndex(World);
+}
+
+void UEditorToolsSceneIndexSubsystem::OnPostUndoRedo()
+{
+	// 撤销/重做可能恢复或移除任意数量的Actor，直接全量重建
+	MarkAllWorldsForRebuild();
+}
+
+void UEditorToolsSceneIndexSubsystem::OnMapChange(uint32 MapChangeFlags)
+{
+	MarkAllWorldsForRebuild();
+}
@@ -0,0 +1,490 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/AssetReferenceGraph.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetRegistry/AssetData.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/Package.h"
+#include "UObject/ObjectSaveContext.h"
+#include <atomic>
+
+ENUM_CLASS_FLAGS(FAssetReferenceGraph::EPackageFlags);
+
+namespace
+{
+	FCriticalSection GSnapshotLock;
+	TSharedPtr<const FAssetReferenceGraph, ESPMode::ThreadSafe> GSnapshot;
+	std::atomic<bool> GSnapshotDirty(true);
+
+	// 自上次获取快照以来变化的包，回调在游戏线程，读取可能在工作线程
+	FCriticalSection GChangedPackagesLock;
+	TSet<FName> GChangedPackages;
+
+	// 变化的包超过总数的这个比例时，逐包查询不比完整构建快
+	constexpr int32 PatchedBuildMaxChangedFraction = 4;
+
+	// 构建时每查询多少个包的依赖检查一次取消请求
+	constexpr int32 BuildCancelCheckInterval = 1024;
+
+	static void MarkPackageChanged(FName PackageName)
+	{
+		FScopeLock Lock(&GChangedPackagesLock);
+		GChangedPackages.Add(PackageName);
+	}
+
+	FDelegateHandle GAssetAddedHandle;
+	FDelegateHandle GAssetRemovedHandle;
+	FDelegateHandle GAssetRenamedHandle;
+	FDelegateHandle GAssetUpdatedHandle;
+	FDelegateHandle GPackageSavedHandle;
+
+	static void OnRegistryAssetChanged(const FAssetData& AssetData)
+	{
+		MarkPackageChanged(AssetData.PackageName);
+	}
+
+	static void OnRegistryAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+	{
+		MarkPackageChanged(AssetData.PackageName);
+		MarkPackageChanged(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+	}
+
+	static void OnPackageSaved(const FString& PackageFileName, UPackage* Package, FObjectPostSaveContext ObjectSaveContext)
+	{
+		// 保存会改变包的依赖列表
+		if (Package)
+		{
+			MarkPackageChanged(Package->GetFName());
+		}
+	}
+
+	// 脚本包不参与资产引用分析
+	static bool IsScriptPackage(FName PackageName)
+	{
+		TCHAR NameBuffer[FName::StringBufferSize];
+		PackageName.ToString(NameBuffer);
+		return FCString::Strncmp(NameBuffer, TEXT("/Script/"), 8) == 0;
+	}
+}
+
+void FAssetReferenceGraph::Initialize()
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	GAssetAddedHandle = AssetRegistry.OnAssetAdded().AddStatic(&OnRegistryAssetChanged);
+	GAssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddStatic(&OnRegistryAssetChanged);
+	GAssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddStatic(&OnRegistryAssetRenamed);
+	GAssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddStatic(&OnRegistryAssetChanged);
+	GPackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddStatic(&OnPackageSaved);
+}
+
+void FAssetReferenceGraph::Shutdown()
+{
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().Remove(GAssetAddedHandle);
+		AssetRegistry.OnAssetRemoved().Remove(GAssetRemovedHandle);
+		AssetRegistry.OnAssetRenamed().Remove(GAssetRenamedHandle);
+		AssetRegistry.OnAssetUpdated().Remove(GAssetUpdatedHandle);
+	}
+	UPackage::PackageSavedWithContextEvent.Remove(GPackageSavedHandle);
+
+	FScopeLock Lock(&GSnapshotLock);
+	GSnapshot.Reset();
+	GSnapshotDirty = true;
+
+	FScopeLock ChangedLock(&GChangedPackagesLock);
+	GChangedPackages.Empty();
+}
+
+FAssetReferenceGraphRef FAssetReferenceGraph::GetSnapshot()
+{
+	return GetSnapshot([]() { return false; }).ToSharedRef();
+}
+
+FAssetReferenceGraphPtr FAssetReferenceGraph::GetSnapshot(TFunctionRef<bool()> ShouldCancel)
+{
+	FScopeLock Lock(&GSnapshotLock);
+
+	TSet<FName> ChangedPackages;
+	{
+		FScopeLock ChangedLock(&GChangedPackagesLock);
+		ChangedPackages = MoveTemp(GChangedPackages);
+		GChangedPackages.Reset();
+	}
+
+	const bool bFullRebuild = GSnapshotDirty.exchange(false);
+	FAssetReferenceGraphPtr NewSnapshot = GSnapshot;
+	if (!GSnapshot.IsValid() || bFullRebuild || ChangedPackages.Num() > GSnapshot->NumPackages() / PatchedBuildMaxChangedFraction)
+	{
+		NewSnapshot = Build(IAssetRegistry::GetChecked(), ShouldCancel);
+	}
+	else if (ChangedPackages.Num() > 0)
+	{
+		// 保存少量包后不必在调用线程上重新查询整个注册表
+		NewSnapshot = BuildPatched(*GSnapshot, ChangedPackages, IAssetRegistry::GetChecked(), ShouldCancel);
+	}
+
+	if (!NewSnapshot.IsValid())
+	{
+		// 已取消：把取走的变化放回去，下次获取时照常重建
+		if (bFullRebuild)
+		{
+			GSnapshotDirty = true;
+		}
+		FScopeLock ChangedLock(&GChangedPackagesLock);
+		GChangedPackages.Append(ChangedPackages);
+		return nullptr;
+	}
+
+	GSnapshot = NewSnapshot;
+	return GSnapshot;
+}
+
+void FAssetReferenceGraph::InvalidateSnapshot()
+{
+	GSnapshotDirty = true;
+}
+
+FAssetReferenceGraphPtr FAssetReferenceGraph::Build(const IAssetRegistry& AssetRegistry, TFunctionRef<bool()> ShouldCancel)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedRef<FAssetReferenceGraph, ESPMode::ThreadSafe> Graph = MakeShareable(new FAssetReferenceGraph());
+
+	// 1. 节点：注册表中所有磁盘上的资产包
+	TArray<FAssetData> AllAssets;
+	AssetRegistry.GetAllAssets(AllAssets, true);
+
+	const FTopLevelAssetPath WorldClassPath = UWorld::StaticClass()->GetClassPathName();
+	Graph->PackageNames.Reserve(AllAssets.Num());
+	Graph->PackageFlags.Reserve(AllAssets.Num());
+	Graph->PackageIndexByName.Reserve(AllAssets.Num());
+
+	for (const FAssetData& AssetData : AllAssets)
+	{
+		const int32 PackageIndex = Graph->AddPackage(AssetData.PackageName);
+		Graph->MarkAssetPackage(PackageIndex, AssetData.AssetClassPath == WorldClassPath);
+	}
+	AllAssets.Empty();
+
+	// 2. 边：每个包的依赖（硬引用和软引用都算）
+	TArray<TPair<int32, int32>> Edges;
+	TArray<FName> PackageDependencies;
+	const int32 NumAssetPackages = Graph->PackageNames.Num();
+	for (int32 PackageIndex = 0; PackageIndex < NumAssetPackages; ++PackageIndex)
+	{
+		if (PackageIndex % BuildCancelCheckInterval == 0 && ShouldCancel())
+		{
+			UE_LOG_EDITORTOOLS_INFO(TEXT("资产引用图构建已取消：已查询 %d / %d 个包"), PackageIndex, NumAssetPackages);
+			return nullptr;
+		}
+
+		PackageDependencies.Reset();
+		AssetRegistry.GetDependencies(Graph->PackageNames[PackageIndex], PackageDependencies);
+		Graph->AddDependencyEdges(PackageIndex, PackageDependencies, Edges);
+	}
+
+	Graph->AddEdges(Edges);
+
+	UE_LOG_EDITORTOOLS_INFO(TEXT("资产引用图构建完成：%d 个包，%d 条依赖，耗时 %.2f 秒"),
+		Graph->NumPackages(), Edges.Num(), FPlatformTime::Seconds() - StartTime);
+
+	return Graph;
+}
+
+FAssetReferenceGraphPtr FAssetReferenceGraph::BuildPatched(const FAssetReferenceGraph& Previous, const TSet<FName>& ChangedPackages, const IAssetRegistry& AssetRegistry, TFunctionRef<bool()> ShouldCancel)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedRef<FAssetReferenceGraph, ESPMode::ThreadSafe> Graph = MakeShareable(new FAssetReferenceGraph());
+	Graph->PackageNames.Reserve(Previous.NumPackages());
+	Graph->PackageFlags.Reserve(Previous.NumPackages());
+	Graph->PackageIndexByName.Reserve(Previous.NumPackages());
+
+	// 1. 未变化的资产包：节点和依赖直接从旧快照复制，只依赖旧快照的节点不会被带过来
+	TArray<TPair<int32, int32>> Edges;
+	Edges.Reserve(Previous.Dependencies.Num());
+	for (int32 PreviousIndex = 0; PreviousIndex < Previous.NumPackages(); ++PreviousIndex)
+	{
+		const FName PackageName = Previous.PackageNames[PreviousIndex];
+		if (!EnumHasAnyFlags(Previous.PackageFlags[PreviousIndex], EPackageFlags::Asset) || ChangedPackages.Contains(PackageName))
+		{
+			continue;
+		}
+
+		const int32 PackageIndex = Graph->AddPackage(PackageName);
+		Graph->MarkAssetPackage(PackageIndex, Previous.IsMapPackage(PreviousIndex));
+
+		for (int32 PreviousDependencyIndex : Previous.GetDependencies(PreviousIndex))
+		{
+			Edges.Emplace(PackageIndex, Graph->AddPackage(Previous.PackageNames[PreviousDependencyIndex]));
+		}
+	}
+
+	// 2. 变化的包：重新查询注册表；已删除或改名前的包没有资产，只在仍被引用时作为依赖节点存在
+	const FTopLevelAssetPath WorldClassPath = UWorld::StaticClass()->GetClassPathName();
+	TArray<FAssetData> PackageAssets;
+	TArray<FName> PackageDependencies;
+	int32 NumQueriedPackages = 0;
+	for (const FName& PackageName : ChangedPackages)
+	{
+		if (NumQueriedPackages++ % BuildCancelCheckInterval == 0 && ShouldCancel())
+		{
+			UE_LOG_EDITORTOOLS_INFO(TEXT("资产引用图增量更新已取消"));
+			return nullptr;
+		}
+
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets, true);
+		if (PackageAssets.Num() == 0)
+		{
+			continue;
+		}
+
+		const bool bIsMap = PackageAssets.ContainsByPredicate([&WorldClassPath](const FAssetData& AssetData)
+		{
+			return AssetData.AssetClassPath == WorldClassPath;
+		});
+
+		const int32 PackageIndex = Graph->AddPackage(PackageName);
+		Graph->MarkAssetPackage(PackageIndex, bIsMap);
+
+		PackageDependencies.Reset();
+		AssetRegistry.GetDependencies(PackageName, PackageDependencies);
+		Graph->AddDependencyEdges(PackageIndex, PackageDependencies, Edges);
+	}
+
+	Graph->AddEdges(Edges);
+
+	UE_LOG_EDITORTOOLS_INFO(TEXT("资产引用图增量更新完成：%d 个变化的包，%d 个包，%d 条依赖，耗时 %.2f ms"),
+		ChangedPackages.Num(), Graph->NumPackages(), Edges.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	return Graph;
+}
+
+int32 FAssetReferenceGraph::AddPackage(FName PackageName)
+{
+	if (const int32* Existing = PackageIndexByName.Find(PackageName))
+	{
+		return *Existing;
+	}
+
+	const int32 NewIndex = PackageNames.Add(PackageName);
+	PackageIndexByName.Add(PackageName, NewIndex);
+
+	// 项目标记只在建图时做一次字符串比较，查询时不再比较
+	TCHAR NameBuffer[FName::StringBufferSize];
+	PackageName.ToString(NameBuffer);
+	const bool bIsProject = FCString::Strncmp(NameBuffer, TEXT("/Game/"), 6) == 0;
+	PackageFlags.Add(bIsProject ? EPackageFlags::Project : EPackageFlags::None);
+	return NewIndex;
+}
+
+void FAssetReferenceGraph::MarkAssetPackage(int32 PackageIndex, bool bIsMap)
+{
+	PackageFlags[PackageIndex] |= EPackageFlags::Asset;
+	if (bIsMap && !EnumHasAnyFlags(PackageFlags[PackageIndex], EPackageFlags::Map))
+	{
+		PackageFlags[PackageIndex] |= EPackageFlags::Map;
+		MapPackageIndices.Add(PackageIndex);
+	}
+}
+
+void FAssetReferenceGraph::AddDependencyEdges(int32 PackageIndex, const TArray<FName>& DependencyNames, TArray<TPair<int32, int32>>& InOutEdges)
+{
+	for (const FName& DependencyName : DependencyNames)
+	{
+		if (DependencyName == PackageNames[PackageIndex] || IsScriptPackage(DependencyName))
+		{
+			continue;
+		}
+
+		InOutEdges.Emplace(PackageIndex, AddPackage(DependencyName));
+	}
+}
+
+void FAssetReferenceGraph::AddEdges(const TArray<TPair<int32, int32>>& Edges)
+{
+	const int32 NumNodes = PackageNames.Num();
+
+	// 计数排序生成两个方向的 CSR
+	DependencyOffsets.SetNumZeroed(NumNodes + 1);
+	ReferencerOffsets.SetNumZeroed(NumNodes + 1);
+	for (const TPair<int32, int32>& Edge : Edges)
+	{
+		DependencyOffsets[Edge.Key + 1]++;
+		ReferencerOffsets[Edge.Value + 1]++;
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		DependencyOffsets[NodeIndex + 1] += DependencyOffsets[NodeIndex];
+		ReferencerOffsets[NodeIndex + 1] += ReferencerOffsets[NodeIndex];
+	}
+
+	Dependencies.SetNumUninitialized(Edges.Num());
+	Referencers.SetNumUninitialized(Edges.Num());
+
+	TArray<int32> DependencyCursor(DependencyOffsets.GetData(), NumNodes);
+	TArray<int32> ReferencerCursor(ReferencerOffsets.GetData(), NumNodes);
+	for (const TPair<int32, int32>& Edge : Edges)
+	{
+		Dependencies[DependencyCursor[Edge.Key]++] = Edge.Value;
+		Referencers[ReferencerCursor[Edge.Value]++] = Edge.Key;
+	}
+}
+
+int32 FAssetReferenceGraph::FindPackageIndex(FName PackageName) const
+{
+	const int32* Found = PackageIndexByName.Find(PackageName);
+	return Found ? *Found : INDEX_NONE;
+}
+
+TConstArrayView<int32> FAssetReferenceGraph::GetDependencies(int32 PackageIndex) const
+{
+	const int32 Begin = DependencyOffsets[PackageIndex];
+	return TConstArrayView<int32>(Dependencies.GetData() + Begin, DependencyOffsets[PackageIndex + 1] - Begin);
+}
+
+TConstArrayView<int32> FAssetReferenceGraph::GetReferencers(int32 PackageIndex) const
+{
+	const int32 Begin = ReferencerOffsets[PackageIndex];
+	return TConstArrayView<int32>(Referencers.GetData() + Begin, ReferencerOffsets[PackageIndex + 1] - Begin);
+}
+
+bool FAssetReferenceGraph::IsReferencedByProjectPackage(int32 PackageIndex) const
+{
+	for (int32 ReferencerIndex : GetReferencers(PackageIndex))
+	{
+		if (IsProjectPackage(ReferencerIndex))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FAssetReferenceGraph::MarkReachable(TConstArrayView<int32> RootIndices, TBitArray<>& OutReachable) const
+{
+	OutReachable.Init(false, NumPackages());
+
+	TArray<int32> Stack;
+	Stack.Reserve(RootIndices.Num());
+	for (int32 RootIndex : RootIndices)
+	{
+		if (RootIndex != INDEX_NONE && !OutReachable[RootIndex])
+		{
+			OutReachable[RootIndex] = true;
+			Stack.Add(RootIndex);
+		}
+	}
+
+	while (Stack.Num() > 0)
+	{
+		const int32 PackageIndex = Stack.Pop(EAllowShrinking::No);
+		for (int32 DependencyIndex : GetDependencies(PackageIndex))
+		{
+			if (!OutReachable[DependencyIndex])
+			{
+				OutReachable[DependencyIndex] = true;
+				Stack.Add(DependencyIndex);
+			}
+		}
+	}
+}
+
+void FAssetReferenceGraph::FindOrphanClusters(TArray<TArray<int32>>& OutClusters) const
+{
+	const int32 NumNodes = NumPackages();
+
+	// 并查集（路径减半），只连接项目内非关卡包之间的边
+	TArray<int32> Parent;
+	Parent.SetNumUninitialized(NumNodes);
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		Parent[NodeIndex] = NodeIndex;
+	}
+
+	auto FindRoot = [&Parent](int32 NodeIndex)
+	{
+		while (Parent[NodeIndex] != NodeIndex)
+		{
+			Parent[NodeIndex] = Parent[Parent[NodeIndex]];
+			NodeIndex = Parent[NodeIndex];
+		}
+		return NodeIndex;
+	};
+
+	auto IsClusterCandidate = [this](int32 NodeIndex)
+	{
+		return IsProjectPackage(NodeIndex) && !IsMapPackage(NodeIndex);
+	};
+
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		if (!IsClusterCandidate(NodeIndex))
+		{
+			continue;
+		}
+
+		for (int32 DependencyIndex : GetDependencies(NodeIndex))
+		{
+			if (IsClusterCandidate(DependencyIndex))
+			{
+				const int32 RootA = FindRoot(NodeIndex);
+				const int32 RootB = FindRoot(DependencyIndex);
+				if (RootA != RootB)
+				{
+					Parent[RootB] = RootA;
+				}
+			}
+		}
+	}
+
+	// 连通分量中任意成员被分量外的项目包（包括关卡）引用，则整个分量都不是孤立的
+	TBitArray<> LiveRoots(false, NumNodes);
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		if (!IsClusterCandidate(NodeIndex))
+		{
+			continue;
+		}
+
+		const int32 Root = FindRoot(NodeIndex);
+		for (int32 ReferencerIndex : GetReferencers(NodeIndex))
+		{
+			if (IsProjectPackage(ReferencerIndex) && (!IsClusterCandidate(ReferencerIndex) || FindRoot(ReferencerIndex) != Root))
+			{
+				LiveRoots[Root] = true;
+				break;
+			}
+		}
+	}
+
+	TMap<int32, int32> ClusterIndexByRoot;
+	for (int32 NodeIndex = 0; NodeIndex < NumNodes; ++NodeIndex)
+	{
+		if (!IsClusterCandidate(NodeIndex))
+		{
+			continue;
+		}
+
+		const int32 Root = FindRoot(NodeIndex);
+		if (LiveRoots[Root])
+		{
+			continue;
+		}
+
+		int32& ClusterIndex = ClusterIndexByRoot.FindOrAdd(Root, INDEX_NONE);
+		if (ClusterIndex == INDEX_NONE)
+		{
+			ClusterIndex = OutClusters.AddDefaulted();
+		}
+		OutClusters[ClusterIndex].Add(NodeIndex);
+	}
+}
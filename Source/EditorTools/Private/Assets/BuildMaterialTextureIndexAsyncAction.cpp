@@ -0,0 +1,306 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/BuildMaterialTextureIndexAsyncAction.h"
+#include "Assets/MaterialTextureIndex.h"
+#include "EditorToolsUtilities.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/AsyncTaskNotification.h"
+
+#define LOCTEXT_NAMESPACE "BuildMaterialTextureIndexAsyncAction"
+
+namespace
+{
+	// 每批异步加载的材质数量，处理完一批才释放并加载下一批
+	constexpr int32 MaterialLoadBatchSize = 256;
+
+	static IAssetRegistry& GetAssetRegistry()
+	{
+		return FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	}
+
+	static bool ResolveMaterialFolderPaths(const TArray<FString>& FolderPaths, TArray<FString>& OutFolderPaths)
+	{
+		OutFolderPaths = FolderPaths;
+
+		// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
+		if (OutFolderPaths.Num() == 0)
+		{
+			FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+			ContentBrowserModule.Get().GetSelectedFolders(OutFolderPaths);
+		}
+
+		if (OutFolderPaths.Num() == 0)
+		{
+			UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+				LOCTEXT("FolderPathEmpty", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“获取材质纹理绑定”。")
+			);
+			return false;
+		}
+		return true;
+	}
+
+	static void CollectMaterials(const TArray<FString>& FolderPaths, TArray<FAssetData>& OutMaterials)
+	{
+		IAssetRegistry& AssetRegistry = GetAssetRegistry();
+
+		// 多个文件夹可能互相嵌套，按包名去重
+		TSet<FName> SeenPackages;
+		for (const FString& FolderPath : FolderPaths)
+		{
+			FString SearchPath = UEditorToolsUtilities::NormalizeFolderPath(FolderPath);
+			SearchPath.RemoveFromEnd(TEXT("/"));
+
+			TArray<FAssetData> FolderAssets;
+			AssetRegistry.GetAssetsByPath(FName(*SearchPath), FolderAssets, true);
+			for (FAssetData& AssetData : FolderAssets)
+			{
+				if (!AssetData.IsInstanceOf(UMaterialInterface::StaticClass()))
+				{
+					continue;
+				}
+
+				bool bAlreadySeen = false;
+				SeenPackages.Add(AssetData.PackageName, &bAlreadySeen);
+				if (!bAlreadySeen)
+				{
+					OutMaterials.Add(MoveTemp(AssetData));
+				}
+			}
+		}
+	}
+}
+
+UBuildMaterialTextureIndexAsyncAction* UBuildMaterialTextureIndexAsyncAction::GetMaterialTextureBindingsInFoldersAsync(const TArray<FString>& FolderPaths)
+{
+	UBuildMaterialTextureIndexAsyncAction* Action = NewObject<UBuildMaterialTextureIndexAsyncAction>();
+	Action->FolderPaths = FolderPaths;
+
+	// 编辑器工具没有 GameInstance 可注册，自行保持存活直到回调结束
+	Action->AddToRoot();
+	return Action;
+}
+
+void UBuildMaterialTextureIndexAsyncAction::Activate()
+{
+	TArray<FString> EffectiveFolderPaths;
+	if (!ResolveMaterialFolderPaths(FolderPaths, EffectiveFolderPaths))
+	{
+		Finish(true);
+		return;
+	}
+	FolderPaths = MoveTemp(EffectiveFolderPaths);
+
+	// 游戏线程：只读取注册表数据，能确定结果的材质不会进入加载队列
+	CollectMaterials(FolderPaths, Targets);
+	for (const FAssetData& AssetData : Targets)
+	{
+		EnqueueMaterial(AssetData);
+	}
+
+	if (LoadQueue.Num() == 0)
+	{
+		Finish(false);
+		return;
+	}
+
+	FAsyncTaskNotificationConfig NotificationConfig;
+	NotificationConfig.TitleText = LOCTEXT("IndexTitle", "正在建立材质纹理索引");
+	NotificationConfig.ProgressText = FText::Format(LOCTEXT("IndexProgress", "0 / {0}"), FText::AsNumber(LoadQueue.Num()));
+	NotificationConfig.bCanCancel = true;
+	NotificationConfig.bKeepOpenOnFailure = false;
+	NotificationConfig.LogCategory = &LogEditorTools;
+	Notification = MakeShared<FAsyncTaskNotification>(NotificationConfig);
+
+	LoadNextBatch();
+}
+
+void UBuildMaterialTextureIndexAsyncAction::Cancel()
+{
+	bCancelRequested = true;
+}
+
+void UBuildMaterialTextureIndexAsyncAction::EnqueueMaterial(const FAssetData& AssetData)
+{
+	bool bAlreadyVisited = false;
+	VisitedPackages.Add(AssetData.PackageName, &bAlreadyVisited);
+	if (bAlreadyVisited)
+	{
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = GetAssetRegistry();
+	FMaterialTextureIndex& Index = FMaterialTextureIndex::Get();
+	const FIoHash PackageSavedHash = FMaterialTextureIndex::GetPackageSavedHash(AssetRegistry, AssetData.PackageName);
+
+	if (Index.IsUpToDate(AssetData.PackageName, PackageSavedHash))
+	{
+		++NumFromIndex;
+		EnqueueParent(Index.FindEntry(AssetData.PackageName)->ParentPath);
+		return;
+	}
+
+	FMaterialTextureIndex::FEntry Entry;
+	if (FMaterialTextureIndex::TryMakeEntryFromRegistry(AssetRegistry, AssetData, PackageSavedHash, Entry))
+	{
+		++NumFromRegistry;
+		const FSoftObjectPath ParentPath = Entry.ParentPath;
+		Index.SetEntry(AssetData.PackageName, MoveTemp(Entry));
+		EnqueueParent(ParentPath);
+		return;
+	}
+
+	// 旧条目已经过期，加载失败或取消时不能再用它解析绑定
+	Index.RemoveEntry(AssetData.PackageName);
+	LoadQueue.Add(AssetData.GetSoftObjectPath());
+}
+
+void UBuildMaterialTextureIndexAsyncAction::EnqueueParent(const FSoftObjectPath& ParentPath)
+{
+	if (ParentPath.IsNull() || VisitedPackages.Contains(ParentPath.GetLongPackageFName()))
+	{
+		return;
+	}
+
+	// 父材质可能在扫描的文件夹之外，材质实例的有效绑定需要整条父材质链
+	const FAssetData ParentAssetData = GetAssetRegistry().GetAssetByObjectPath(ParentPath);
+	if (ParentAssetData.IsValid())
+	{
+		EnqueueMaterial(ParentAssetData);
+	}
+}
+
+void UBuildMaterialTextureIndexAsyncAction::LoadNextBatch()
+{
+	if (Notification.IsValid() && Notification->GetPromptAction() == EAsyncTaskNotificationPromptAction::Cancel)
+	{
+		bCancelRequested = true;
+	}
+
+	if (bCancelRequested || NextLoadIndex >= LoadQueue.Num())
+	{
+		Finish(bCancelRequested);
+		return;
+	}
+
+	const int32 BatchSize = FMath::Min(MaterialLoadBatchSize, LoadQueue.Num() - NextLoadIndex);
+	CurrentBatch = TArray<FSoftObjectPath>(LoadQueue.GetData() + NextLoadIndex, BatchSize);
+	NextLoadIndex += BatchSize;
+
+	// 先挂起再启动，保证全部已加载时同步触发的回调也能拿到句柄
+	LoadHandle = StreamableManager.RequestAsyncLoad(CurrentBatch,
+		FStreamableDelegate::CreateUObject(this, &UBuildMaterialTextureIndexAsyncAction::OnBatchLoaded),
+		FStreamableManager::DefaultAsyncLoadPriority, false, true, TEXT("BuildMaterialTextureIndex"));
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->StartStalledHandle();
+	}
+	else
+	{
+		OnBatchLoaded();
+	}
+}
+
+void UBuildMaterialTextureIndexAsyncAction::OnBatchLoaded()
+{
+	IAssetRegistry& AssetRegistry = GetAssetRegistry();
+	FMaterialTextureIndex& Index = FMaterialTextureIndex::Get();
+
+	for (const FSoftObjectPath& MaterialPath : CurrentBatch)
+	{
+		const UMaterialInterface* Material = Cast<UMaterialInterface>(MaterialPath.ResolveObject());
+		if (!Material)
+		{
+			UE_LOG(LogEditorTools, Warning, TEXT("无法加载材质：%s"), *MaterialPath.ToString());
+			continue;
+		}
+
+		const FName PackageName = MaterialPath.GetLongPackageFName();
+		FMaterialTextureIndex::FEntry Entry = FMaterialTextureIndex::MakeEntry(Material, FMaterialTextureIndex::GetPackageSavedHash(AssetRegistry, PackageName));
+		const FSoftObjectPath ParentPath = Entry.ParentPath;
+		Index.SetEntry(PackageName, MoveTemp(Entry));
+
+		// 新发现的父材质可能还需要加载，追加到队列末尾
+		EnqueueParent(ParentPath);
+	}
+	CurrentBatch.Reset();
+
+	// 释放本批材质，下次 GC 时可以回收
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->ReleaseHandle();
+		LoadHandle.Reset();
+	}
+
+	if (Notification.IsValid())
+	{
+		Notification->SetProgressText(FText::Format(LOCTEXT("IndexProgressCount", "{0} / {1}"),
+			FText::AsNumber(NextLoadIndex), FText::AsNumber(LoadQueue.Num())));
+	}
+
+	LoadNextBatch();
+}
+
+void UBuildMaterialTextureIndexAsyncAction::Finish(bool bWasCancelled)
+{
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->CancelHandle();
+		LoadHandle.Reset();
+	}
+
+	// 取消时已经读取的条目同样有效，一并写回磁盘
+	FMaterialTextureIndex& Index = FMaterialTextureIndex::Get();
+	Index.Save();
+
+	TArray<FMaterialTextureBindings> Results;
+	Results.Reserve(Targets.Num());
+	for (const FAssetData& AssetData : Targets)
+	{
+		FMaterialTextureBindings Bindings;
+		if (Index.ResolveBindings(AssetData.PackageName, Bindings.Bindings))
+		{
+			Bindings.Material = AssetData.GetSoftObjectPath();
+			Results.Add(MoveTemp(Bindings));
+		}
+	}
+
+	UE_LOG(LogEditorTools, Log, TEXT("材质纹理索引：%d 个材质，索引命中 %d，注册表推断 %d，加载 %d"),
+		Targets.Num(), NumFromIndex, NumFromRegistry, NextLoadIndex);
+
+	if (Notification.IsValid())
+	{
+		if (bWasCancelled)
+		{
+			Notification->SetComplete(LOCTEXT("IndexCancelled", "已取消建立材质纹理索引"), FText::GetEmpty(), false);
+		}
+		else
+		{
+			Notification->SetComplete(
+				LOCTEXT("IndexCompleted", "材质纹理索引建立完成"),
+				FText::Format(LOCTEXT("IndexCompletedCount", "{0} 个材质，加载了 {1} 个"), FText::AsNumber(Results.Num()), FText::AsNumber(NextLoadIndex)),
+				true);
+		}
+		Notification.Reset();
+	}
+
+	if (bWasCancelled)
+	{
+		OnCancelled.Broadcast(Results);
+	}
+	else
+	{
+		OnCompleted.Broadcast(Results);
+	}
+
+	Targets.Empty();
+	LoadQueue.Empty();
+	SetReadyToDestroy();
+	RemoveFromRoot();
+}
+
+#undef LOCTEXT_NAMESPACE
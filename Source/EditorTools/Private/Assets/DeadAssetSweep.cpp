@@ -0,0 +1,194 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/DeadAssetSweep.h"
+#include "Assets/AssetReferenceGraph.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "ExternalPackageHelper.h"
+#include "GameMapsSettings.h"
+#include "Settings/ProjectPackagingSettings.h"
+#include "Misc/PackageName.h"
+#include "Misc/PackagePath.h"
+
+namespace
+{
+	static void AddRootPackage(const FString& PackageOrObjectPath, TSet<FName>& InOutRoots)
+	{
+		if (PackageOrObjectPath.IsEmpty())
+		{
+			return;
+		}
+
+		// 设置里可能是包路径（/Game/Maps/Main）也可能是对象路径（/Game/Maps/Main.Main）
+		const FString PackageName = FPackageName::ObjectPathToPackageName(PackageOrObjectPath);
+		if (FPackageName::IsValidLongPackageName(PackageName))
+		{
+			InOutRoots.Add(FName(*PackageName));
+		}
+	}
+
+	static void AddPackagesUnderPath(IAssetRegistry& AssetRegistry, const FString& ContentPath, TSet<FName>& InOutRoots)
+	{
+		FString SearchPath = ContentPath;
+		SearchPath.RemoveFromEnd(TEXT("/"));
+		if (SearchPath.IsEmpty())
+		{
+			return;
+		}
+
+		TArray<FAssetData> AssetsUnderPath;
+		AssetRegistry.GetAssetsByPath(FName(*SearchPath), AssetsUnderPath, true, true);
+		for (const FAssetData& AssetData : AssetsUnderPath)
+		{
+			InOutRoots.Add(AssetData.PackageName);
+		}
+	}
+
+	// 一个 Actor 一个文件的关卡（World Partition）与其外部包之间没有注册表依赖，由外部包单独记录对资源的引用
+	static bool IsExternalPackage(const FString& PackageName)
+	{
+		return PackageName.Contains(FString::Printf(TEXT("/%s/"), FPackagePath::GetExternalActorsFolderName()))
+			|| PackageName.Contains(FString::Printf(TEXT("/%s/"), FPackagePath::GetExternalObjectsFolderName()));
+	}
+}
+
+void FDeadAssetSweep::CollectProjectRoots(TArray<FName>& OutRootPackages)
+{
+	check(IsInGameThread());
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	const UProjectPackagingSettings* PackagingSettings = GetDefault<UProjectPackagingSettings>();
+
+	TSet<FName> Roots;
+
+	TArray<FAssetData> MapAssets;
+	AssetRegistry.GetAssetsByClass(UWorld::StaticClass()->GetClassPathName(), MapAssets);
+
+	// 关卡：显式配置的 MapsToCook，没有配置时烘焙会包含项目内所有关卡
+	for (const FFilePath& MapPath : PackagingSettings->MapsToCook)
+	{
+		AddRootPackage(MapPath.FilePath, Roots);
+	}
+
+	if (PackagingSettings->MapsToCook.Num() == 0)
+	{
+		for (const FAssetData& MapAsset : MapAssets)
+		{
+			if (MapAsset.PackageName.ToString().StartsWith(TEXT("/Game/")))
+			{
+				Roots.Add(MapAsset.PackageName);
+			}
+		}
+	}
+
+	AddRootPackage(UGameMapsSettings::GetGameDefaultMap(), Roots);
+
+	// 主资产（AssetManager 扫描规则中的类型）
+	if (UAssetManager::IsInitialized())
+	{
+		UAssetManager& AssetManager = UAssetManager::Get();
+
+		TArray<FPrimaryAssetTypeInfo> PrimaryAssetTypes;
+		AssetManager.GetPrimaryAssetTypeInfoList(PrimaryAssetTypes);
+
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		for (const FPrimaryAssetTypeInfo& TypeInfo : PrimaryAssetTypes)
+		{
+			PrimaryAssetIds.Reset();
+			AssetManager.GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, PrimaryAssetIds);
+
+			for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+			{
+				if (AssetManager.GetPrimaryAssetRules(PrimaryAssetId).CookRule == EPrimaryAssetCookRule::NeverCook)
+				{
+					continue;
+				}
+
+				AddRootPackage(AssetManager.GetPrimaryAssetPath(PrimaryAssetId).ToString(), Roots);
+			}
+		}
+	}
+
+	// 始终烘焙的目录
+	for (const FDirectoryPath& Directory : PackagingSettings->DirectoriesToAlwaysCook)
+	{
+		AddPackagesUnderPath(AssetRegistry, Directory.Path, Roots);
+	}
+
+	// 根关卡的外部 Actor 和外部对象包随关卡一起烘焙
+	for (const FAssetData& MapAsset : MapAssets)
+	{
+		if (Roots.Contains(MapAsset.PackageName))
+		{
+			const FString MapPackageName = MapAsset.PackageName.ToString();
+			AddPackagesUnderPath(AssetRegistry, ULevel::GetExternalActorsPath(MapPackageName), Roots);
+			AddPackagesUnderPath(AssetRegistry, FExternalPackageHelper::GetExternalObjectsPath(MapPackageName), Roots);
+		}
+	}
+
+	OutRootPackages = Roots.Array();
+}
+
+void FDeadAssetSweep::FindDeadPackages(const FAssetReferenceGraph& Graph, const TArray<FName>& RootPackages, const TArray<FString>& PackagePathPrefixes, TArray<FName>& OutDeadPackages, int32& OutNumCheckedPackages)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TArray<int32> RootIndices;
+	RootIndices.Reserve(RootPackages.Num());
+	for (const FName& RootPackage : RootPackages)
+	{
+		const int32 RootIndex = Graph.FindPackageIndex(RootPackage);
+		if (RootIndex != INDEX_NONE)
+		{
+			RootIndices.Add(RootIndex);
+		}
+	}
+
+	// 标记：每个包一位
+	TBitArray<> Reachable;
+	Graph.MarkReachable(RootIndices, Reachable);
+
+	// 清除：未被标记的项目包
+	OutNumCheckedPackages = 0;
+	for (int32 PackageIndex = 0; PackageIndex < Graph.NumPackages(); ++PackageIndex)
+	{
+		if (!Graph.IsProjectPackage(PackageIndex))
+		{
+			continue;
+		}
+
+		const FName PackageName = Graph.GetPackageName(PackageIndex);
+		const FString PackageNameString = PackageName.ToString();
+
+		// 外部包属于所在关卡，不单独作为无用资源报告
+		if (IsExternalPackage(PackageNameString))
+		{
+			continue;
+		}
+
+		if (PackagePathPrefixes.Num() > 0)
+		{
+			const bool bInRequestedFolder = PackagePathPrefixes.ContainsByPredicate([&PackageNameString](const FString& Prefix)
+			{
+				return PackageNameString.StartsWith(Prefix);
+			});
+			if (!bInRequestedFolder)
+			{
+				continue;
+			}
+		}
+
+		++OutNumCheckedPackages;
+		if (!Reachable[PackageIndex])
+		{
+			OutDeadPackages.Add(PackageName);
+		}
+	}
+
+	UE_LOG_EDITORTOOLS_INFO(TEXT("无用资源标记-清除完成：%d 个根包，检查 %d 个包，%d 个不可达包，耗时 %.2f ms"),
+		RootIndices.Num(), OutNumCheckedPackages, OutDeadPackages.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
@@ -0,0 +1,393 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/DuplicateMaterialInstanceScanner.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/ParallelFor.h"
+#include "Hash/xxhash.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/ScopedSlowTask.h"
+#include "ObjectTools.h"
+#include "Serialization/MemoryWriter.h"
+#include "StaticParameterSet.h"
+
+#define LOCTEXT_NAMESPACE "FDuplicateMaterialInstanceScanner"
+
+namespace
+{
+	// 父材质链的最大深度，防止异常数据形成环
+	constexpr int32 MaxInstanceDepth = 32;
+
+	/** 纹理、虚拟纹理、稀疏体积纹理和字体参数统一按对象路径比较 */
+	struct FObjectParameterOverride
+	{
+		uint8 Kind = 0;
+		FMaterialParameterInfo ParameterInfo;
+		FString Value;
+	};
+
+	/** 游戏线程从材质实例复制出的覆盖值，签名在工作线程中只读取这份数据 */
+	struct FInstanceSnapshot
+	{
+		FSoftObjectPath Path;
+		FSoftObjectPath ParentPath;
+
+		/** 父材质也在扫描范围内时的下标 */
+		int32 ParentIndex = INDEX_NONE;
+		int32 Depth = 0;
+
+		/** 使用材质图层的实例不参与比较 */
+		bool bComparable = true;
+
+		TArray<FScalarParameterValue> Scalars;
+		TArray<FVectorParameterValue> Vectors;
+		TArray<FDoubleVectorParameterValue> DoubleVectors;
+		TArray<FObjectParameterOverride> Objects;
+		TArray<FStaticSwitchParameter> StaticSwitches;
+		TArray<FStaticComponentMaskParameter> ComponentMasks;
+		FString PropertyOverrides;
+
+		/** 父材质的身份：父材质在扫描范围内时为其所在组的保留实例 */
+		FString ParentIdentity;
+		TArray<uint8> Signature;
+		uint64 SignatureHash = 0;
+		int32 GroupIndex = INDEX_NONE;
+	};
+
+	struct FInstanceGroup
+	{
+		TArray<int32> Members;
+		int32 KeptMember = INDEX_NONE;
+	};
+
+	static bool ParameterInfoLess(const FMaterialParameterInfo& A, const FMaterialParameterInfo& B)
+	{
+		if (A.Name != B.Name)
+		{
+			return A.Name.Compare(B.Name) < 0;
+		}
+		if (A.Association != B.Association)
+		{
+			return A.Association < B.Association;
+		}
+		return A.Index < B.Index;
+	}
+
+	static void WriteParameterInfo(FArchive& Ar, const FMaterialParameterInfo& ParameterInfo)
+	{
+		FString Name = ParameterInfo.Name.ToString();
+		uint8 Association = (uint8)ParameterInfo.Association;
+		int32 Index = ParameterInfo.Index;
+		Ar << Name << Association << Index;
+	}
+
+	/** 按参数排序后写入，覆盖值在数组中的顺序不影响签名 */
+	template <typename ParameterType, typename WriteValueType>
+	static void WriteParameters(FArchive& Ar, TArray<ParameterType>& Parameters, WriteValueType WriteValue)
+	{
+		Parameters.Sort([](const ParameterType& A, const ParameterType& B)
+		{
+			return ParameterInfoLess(A.ParameterInfo, B.ParameterInfo);
+		});
+
+		int32 NumParameters = Parameters.Num();
+		Ar << NumParameters;
+		for (ParameterType& Parameter : Parameters)
+		{
+			WriteParameterInfo(Ar, Parameter.ParameterInfo);
+			WriteValue(Ar, Parameter);
+		}
+	}
+
+	static void AddObjectParameter(FInstanceSnapshot& Snapshot, uint8 Kind, const FMaterialParameterInfo& ParameterInfo, const UObject* Value, const FString& Suffix = FString())
+	{
+		FObjectParameterOverride& Override = Snapshot.Objects.AddDefaulted_GetRef();
+		Override.Kind = Kind;
+		Override.ParameterInfo = ParameterInfo;
+		Override.Value = FSoftObjectPath(Value).ToString() + Suffix;
+	}
+
+	static FInstanceSnapshot MakeSnapshot(const UMaterialInstanceConstant* Instance)
+	{
+		FInstanceSnapshot Snapshot;
+		Snapshot.Path = FSoftObjectPath(Instance);
+		Snapshot.ParentPath = FSoftObjectPath(Instance->Parent);
+
+		const FStaticParameterSet StaticParameters = Instance->GetStaticParameters();
+		if (StaticParameters.bHasMaterialLayers)
+		{
+			Snapshot.bComparable = false;
+			return Snapshot;
+		}
+
+		Snapshot.Scalars = Instance->ScalarParameterValues;
+		Snapshot.Vectors = Instance->VectorParameterValues;
+		Snapshot.DoubleVectors = Instance->DoubleVectorParameterValues;
+
+		for (const FTextureParameterValue& Value : Instance->TextureParameterValues)
+		{
+			AddObjectParameter(Snapshot, 0, Value.ParameterInfo, Value.ParameterValue);
+		}
+		for (const FRuntimeVirtualTextureParameterValue& Value : Instance->RuntimeVirtualTextureParameterValues)
+		{
+			AddObjectParameter(Snapshot, 1, Value.ParameterInfo, Value.ParameterValue);
+		}
+		for (const FSparseVolumeTextureParameterValue& Value : Instance->SparseVolumeTextureParameterValues)
+		{
+			AddObjectParameter(Snapshot, 2, Value.ParameterInfo, Value.ParameterValue);
+		}
+		for (const FFontParameterValue& Value : Instance->FontParameterValues)
+		{
+			AddObjectParameter(Snapshot, 3, Value.ParameterInfo, Value.FontValue, FString::Printf(TEXT("#%d"), Value.FontPage));
+		}
+
+		// 未勾选覆盖的静态参数与父材质一致，不写入签名
+		for (const FStaticSwitchParameter& Parameter : StaticParameters.StaticSwitchParameters)
+		{
+			if (Parameter.bOverride)
+			{
+				Snapshot.StaticSwitches.Add(Parameter);
+			}
+		}
+		for (const FStaticComponentMaskParameter& Parameter : StaticParameters.EditorOnly.StaticComponentMaskParameters)
+		{
+			if (Parameter.bOverride)
+			{
+				Snapshot.ComponentMasks.Add(Parameter);
+			}
+		}
+
+		// 混合模式、双面等基础属性覆盖以及物理材质、次表面配置
+		FMaterialInstanceBasePropertyOverrides::StaticStruct()->ExportText(Snapshot.PropertyOverrides, &Instance->BasePropertyOverrides, nullptr, nullptr, PPF_None, nullptr);
+		Snapshot.PropertyOverrides += FString::Printf(TEXT("|%s|%d|%s"),
+			*FSoftObjectPath(Instance->PhysMaterial).ToString(),
+			Instance->bOverrideSubsurfaceProfile ? 1 : 0,
+			*FSoftObjectPath(Instance->bOverrideSubsurfaceProfile ? Instance->SubsurfaceProfile : nullptr).ToString());
+
+		return Snapshot;
+	}
+
+	/** 工作线程：序列化签名并计算哈希 */
+	static void BuildSignature(FInstanceSnapshot& Snapshot)
+	{
+		FMemoryWriter Writer(Snapshot.Signature);
+		Writer << Snapshot.ParentIdentity;
+		Writer << Snapshot.PropertyOverrides;
+
+		WriteParameters(Writer, Snapshot.Scalars, [](FArchive& Ar, FScalarParameterValue& Parameter) { Ar << Parameter.ParameterValue; });
+		WriteParameters(Writer, Snapshot.Vectors, [](FArchive& Ar, FVectorParameterValue& Parameter) { Ar << Parameter.ParameterValue; });
+		WriteParameters(Writer, Snapshot.DoubleVectors, [](FArchive& Ar, FDoubleVectorParameterValue& Parameter) { Ar << Parameter.ParameterValue; });
+		WriteParameters(Writer, Snapshot.Objects, [](FArchive& Ar, FObjectParameterOverride& Parameter) { Ar << Parameter.Kind << Parameter.Value; });
+		WriteParameters(Writer, Snapshot.StaticSwitches, [](FArchive& Ar, FStaticSwitchParameter& Parameter)
+		{
+			uint8 Value = Parameter.Value ? 1 : 0;
+			Ar << Value;
+		});
+		WriteParameters(Writer, Snapshot.ComponentMasks, [](FArchive& Ar, FStaticComponentMaskParameter& Parameter)
+		{
+			uint8 Mask = (Parameter.R ? 1 : 0) | (Parameter.G ? 2 : 0) | (Parameter.B ? 4 : 0) | (Parameter.A ? 8 : 0);
+			Ar << Mask;
+		});
+
+		Snapshot.SignatureHash = FXxHash64::HashBuffer(Snapshot.Signature.GetData(), Snapshot.Signature.Num()).Hash;
+	}
+
+	/** 保留被引用最多的实例，需要修改的引用最少；数量相同时取路径最小的，保证结果稳定 */
+	static int32 ChooseKeptMember(const IAssetRegistry& AssetRegistry, const TArray<FInstanceSnapshot>& Snapshots, const TArray<int32>& Members)
+	{
+		int32 KeptMember = Members[0];
+		int32 KeptReferencerCount = -1;
+		for (int32 Member : Members)
+		{
+			TArray<FName> Referencers;
+			AssetRegistry.GetReferencers(Snapshots[Member].Path.GetLongPackageFName(), Referencers);
+			const bool bBetter = Referencers.Num() > KeptReferencerCount
+				|| (Referencers.Num() == KeptReferencerCount && Snapshots[Member].Path.ToString() < Snapshots[KeptMember].Path.ToString());
+			if (bBetter)
+			{
+				KeptMember = Member;
+				KeptReferencerCount = Referencers.Num();
+			}
+		}
+		return KeptMember;
+	}
+}
+
+void FDuplicateMaterialInstanceScanner::FindDuplicates(const TArray<UMaterialInstanceConstant*>& Instances, TArray<FDuplicateMaterialInstanceGroup>& OutGroups)
+{
+	check(IsInGameThread());
+	OutGroups.Reset();
+
+	// 游戏线程：复制覆盖值，之后不再访问 UObject
+	TArray<FInstanceSnapshot> Snapshots;
+	Snapshots.Reserve(Instances.Num());
+	TMap<FSoftObjectPath, int32> SnapshotIndices;
+	for (const UMaterialInstanceConstant* Instance : Instances)
+	{
+		if (Instance && !SnapshotIndices.Contains(FSoftObjectPath(Instance)))
+		{
+			SnapshotIndices.Add(FSoftObjectPath(Instance), Snapshots.Num());
+			Snapshots.Add(MakeSnapshot(Instance));
+		}
+	}
+
+	// 按父材质链分层，父材质所在的组先确定
+	int32 MaxDepth = 0;
+	for (FInstanceSnapshot& Snapshot : Snapshots)
+	{
+		if (const int32* ParentIndex = SnapshotIndices.Find(Snapshot.ParentPath))
+		{
+			Snapshot.ParentIndex = *ParentIndex;
+		}
+	}
+	for (FInstanceSnapshot& Snapshot : Snapshots)
+	{
+		for (int32 Ancestor = Snapshot.ParentIndex; Ancestor != INDEX_NONE && Snapshot.Depth < MaxInstanceDepth; Ancestor = Snapshots[Ancestor].ParentIndex)
+		{
+			++Snapshot.Depth;
+		}
+		MaxDepth = FMath::Max(MaxDepth, Snapshot.Depth);
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FInstanceGroup> Groups;
+	for (int32 Depth = 0; Depth <= MaxDepth; ++Depth)
+	{
+		TArray<int32> LevelIndices;
+		for (int32 Index = 0; Index < Snapshots.Num(); ++Index)
+		{
+			FInstanceSnapshot& Snapshot = Snapshots[Index];
+			if (Snapshot.Depth != Depth)
+			{
+				continue;
+			}
+
+			if (!Snapshot.bComparable)
+			{
+				// 不参与比较的实例单独成组，子实例以它自身作为父材质身份
+				Snapshot.GroupIndex = Groups.Num();
+				FInstanceGroup& Group = Groups.AddDefaulted_GetRef();
+				Group.Members.Add(Index);
+				Group.KeptMember = Index;
+				continue;
+			}
+
+			Snapshot.ParentIdentity = Snapshot.ParentIndex != INDEX_NONE
+				? Snapshots[Groups[Snapshots[Snapshot.ParentIndex].GroupIndex].KeptMember].Path.ToString()
+				: Snapshot.ParentPath.ToString();
+			LevelIndices.Add(Index);
+		}
+
+		ParallelFor(LevelIndices.Num(), [&Snapshots, &LevelIndices](int32 LevelIndex)
+		{
+			BuildSignature(Snapshots[LevelIndices[LevelIndex]]);
+		});
+
+		// 哈希相同的再逐字节比较，避免哈希碰撞误合并
+		TMap<uint64, TArray<int32>> GroupsByHash;
+		const int32 FirstLevelGroup = Groups.Num();
+		for (int32 Index : LevelIndices)
+		{
+			FInstanceSnapshot& Snapshot = Snapshots[Index];
+			TArray<int32>& Candidates = GroupsByHash.FindOrAdd(Snapshot.SignatureHash);
+			for (int32 Candidate : Candidates)
+			{
+				if (Snapshots[Groups[Candidate].Members[0]].Signature == Snapshot.Signature)
+				{
+					Snapshot.GroupIndex = Candidate;
+					break;
+				}
+			}
+
+			if (Snapshot.GroupIndex == INDEX_NONE)
+			{
+				Snapshot.GroupIndex = Groups.Num();
+				Candidates.Add(Snapshot.GroupIndex);
+				Groups.AddDefaulted();
+			}
+			Groups[Snapshot.GroupIndex].Members.Add(Index);
+		}
+
+		for (int32 GroupIndex = FirstLevelGroup; GroupIndex < Groups.Num(); ++GroupIndex)
+		{
+			FInstanceGroup& Group = Groups[GroupIndex];
+			Group.KeptMember = Group.Members.Num() > 1 ? ChooseKeptMember(AssetRegistry, Snapshots, Group.Members) : Group.Members[0];
+		}
+	}
+
+	for (const FInstanceGroup& Group : Groups)
+	{
+		if (Group.Members.Num() < 2)
+		{
+			continue;
+		}
+
+		FDuplicateMaterialInstanceGroup& OutGroup = OutGroups.AddDefaulted_GetRef();
+		OutGroup.KeptInstance = Snapshots[Group.KeptMember].Path;
+		for (int32 Member : Group.Members)
+		{
+			if (Member != Group.KeptMember)
+			{
+				OutGroup.Duplicates.Add(Snapshots[Member].Path);
+			}
+		}
+		OutGroup.Duplicates.Sort([](const FSoftObjectPath& A, const FSoftObjectPath& B) { return A.ToString() < B.ToString(); });
+	}
+
+	OutGroups.StableSort([](const FDuplicateMaterialInstanceGroup& A, const FDuplicateMaterialInstanceGroup& B)
+	{
+		return A.Duplicates.Num() > B.Duplicates.Num();
+	});
+}
+
+int32 FDuplicateMaterialInstanceScanner::ConsolidateDuplicates(const TArray<FDuplicateMaterialInstanceGroup>& Groups)
+{
+	check(IsInGameThread());
+
+	int32 NumConsolidated = 0;
+	FScopedSlowTask SlowTask(Groups.Num(), LOCTEXT("ConsolidatingInstances", "正在合并重复的材质实例..."));
+	SlowTask.MakeDialog();
+
+	for (const FDuplicateMaterialInstanceGroup& Group : Groups)
+	{
+		SlowTask.EnterProgressFrame();
+
+		// 每组单独加载：合并会删除对象并触发 GC，不能跨组持有指针
+		UMaterialInstanceConstant* KeptInstance = Cast<UMaterialInstanceConstant>(Group.KeptInstance.TryLoad());
+		if (!KeptInstance)
+		{
+			UE_LOG(LogEditorTools, Warning, TEXT("合并重复材质实例：无法加载保留实例 %s"), *Group.KeptInstance.ToString());
+			continue;
+		}
+
+		TArray<UObject*> ObjectsToConsolidate;
+		for (const FSoftObjectPath& DuplicatePath : Group.Duplicates)
+		{
+			UMaterialInstanceConstant* Duplicate = Cast<UMaterialInstanceConstant>(DuplicatePath.TryLoad());
+			if (Duplicate && Duplicate != KeptInstance)
+			{
+				ObjectsToConsolidate.Add(Duplicate);
+			}
+		}
+
+		if (ObjectsToConsolidate.Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 NumRequested = ObjectsToConsolidate.Num();
+		const ObjectTools::FConsolidationResults Results = ObjectTools::ConsolidateObjects(KeptInstance, ObjectsToConsolidate, false);
+		const int32 NumFailed = Results.FailedConsolidationObjs.Num() + Results.InvalidConsolidationObjs.Num();
+		NumConsolidated += NumRequested - NumFailed;
+
+		if (NumFailed > 0)
+		{
+			UE_LOG(LogEditorTools, Warning, TEXT("合并重复材质实例：%d 个实例无法合并到 %s"), NumFailed, *Group.KeptInstance.ToString());
+		}
+	}
+
+	return NumConsolidated;
+}
+
+#undef LOCTEXT_NAMESPACE
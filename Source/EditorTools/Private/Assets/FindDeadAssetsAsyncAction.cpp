@@ -0,0 +1,133 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/FindDeadAssetsAsyncAction.h"
+#include "Assets/AssetReferenceGraph.h"
+#include "Assets/DeadAssetSweep.h"
+#include "Assets/UnusedAssetScanner.h"
+#include "EditorToolsUtilities.h"
+#include "Logging/EditorToolsLog.h"
+#include "Logging/EditorToolsMessageLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+#include "Misc/AsyncTaskNotification.h"
+
+#define LOCTEXT_NAMESPACE "FindDeadAssetsAsyncAction"
+
+UFindDeadAssetsAsyncAction* UFindDeadAssetsAsyncAction::FindUnreachableAssetsAsync(const TArray<FString>& FolderPaths)
+{
+	UFindDeadAssetsAsyncAction* Action = NewObject<UFindDeadAssetsAsyncAction>();
+	Action->FolderPaths = FolderPaths;
+
+	// 编辑器工具没有 GameInstance 可注册，自行保持存活直到回调结束
+	Action->AddToRoot();
+	return Action;
+}
+
+void UFindDeadAssetsAsyncAction::Activate()
+{
+	for (const FString& FolderPath : FolderPaths)
+	{
+		PackagePathPrefixes.Add(UEditorToolsUtilities::NormalizeFolderPath(FolderPath));
+	}
+
+	// 游戏线程：读取项目设置和 AssetManager 收集根包
+	TArray<FName> RootPackages;
+	FDeadAssetSweep::CollectProjectRoots(RootPackages);
+
+	FAsyncTaskNotificationConfig NotificationConfig;
+	NotificationConfig.TitleText = LOCTEXT("SweepTitle", "正在查找不可达的资源");
+	NotificationConfig.ProgressText = FText::Format(LOCTEXT("SweepRoots", "{0} 个根包"), FText::AsNumber(RootPackages.Num()));
+	NotificationConfig.bCanCancel = true;
+	NotificationConfig.bKeepOpenOnFailure = false;
+	NotificationConfig.LogCategory = &LogEditorTools;
+	Notification = MakeShared<FAsyncTaskNotification>(NotificationConfig);
+
+	TWeakObjectPtr<UFindDeadAssetsAsyncAction> WeakThis(this);
+	TSharedPtr<FAsyncTaskNotification> TaskNotification = Notification;
+	Async(EAsyncExecution::ThreadPool, [WeakThis, TaskNotification, RootPackages = MoveTemp(RootPackages), Prefixes = PackagePathPrefixes]()
+	{
+		// 标记-清除本身是线性的，耗时主要在引用图构建，只在构建期间响应取消
+		const FAssetReferenceGraphPtr Graph = FAssetReferenceGraph::GetSnapshot([&TaskNotification]()
+		{
+			return TaskNotification->GetPromptAction() == EAsyncTaskNotificationPromptAction::Cancel;
+		});
+
+		TArray<FName> DeadPackages;
+		int32 NumCheckedPackages = 0;
+		const bool bWasCancelled = !Graph.IsValid();
+		if (!bWasCancelled)
+		{
+			FDeadAssetSweep::FindDeadPackages(*Graph, RootPackages, Prefixes, DeadPackages, NumCheckedPackages);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, DeadPackages = MoveTemp(DeadPackages), NumCheckedPackages, bWasCancelled]() mutable
+		{
+			if (UFindDeadAssetsAsyncAction* Action = WeakThis.Get())
+			{
+				Action->OnSweepFinished(MoveTemp(DeadPackages), NumCheckedPackages, bWasCancelled);
+			}
+		});
+	});
+}
+
+void UFindDeadAssetsAsyncAction::OnSweepFinished(TArray<FName>&& DeadPackages, int32 NumCheckedPackages, bool bWasCancelled)
+{
+	if (bWasCancelled)
+	{
+		if (Notification.IsValid())
+		{
+			Notification->SetComplete(LOCTEXT("SweepCancelled", "已取消查找不可达的资源"), FText::GetEmpty(), false);
+			Notification.Reset();
+		}
+
+		OnCancelled.Broadcast(TArray<FUnusedAssetInfo>());
+
+		SetReadyToDestroy();
+		RemoveFromRoot();
+		return;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// 只读取注册表数据生成结果，不加载资源
+	TArray<FUnusedAssetInfo> DeadAssets;
+	TArray<FAssetData> PackageAssets;
+	for (const FName& PackageName : DeadPackages)
+	{
+		PackageAssets.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssets, true);
+		for (const FAssetData& AssetData : PackageAssets)
+		{
+			DeadAssets.Add(FUnusedAssetScanner::MakeUnusedAssetInfo(AssetData));
+		}
+	}
+
+	DeadAssets.Sort([](const FUnusedAssetInfo& A, const FUnusedAssetInfo& B)
+	{
+		return A.AssetPath == B.AssetPath ? A.AssetName < B.AssetName : A.AssetPath < B.AssetPath;
+	});
+
+	if (Notification.IsValid())
+	{
+		Notification->SetComplete(
+			LOCTEXT("SweepCompleted", "查找不可达的资源完成"),
+			FText::Format(LOCTEXT("SweepCompletedCount", "发现 {0} 个不可达的资源"), FText::AsNumber(DeadAssets.Num())),
+			true);
+		Notification.Reset();
+	}
+
+	TArray<FString> ReportFolders = PackagePathPrefixes;
+	if (ReportFolders.Num() == 0)
+	{
+		ReportFolders.Add(TEXT("/Game/"));
+	}
+	FEditorToolsMessageLog::ShowUnusedAssetsReport(TEXT("资源"), ReportFolders, DeadAssets, NumCheckedPackages);
+
+	OnCompleted.Broadcast(DeadAssets);
+
+	SetReadyToDestroy();
+	RemoveFromRoot();
+}
+
+#undef LOCTEXT_NAMESPACE
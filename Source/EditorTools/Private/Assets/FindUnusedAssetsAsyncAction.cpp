@@ -0,0 +1,169 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/FindUnusedAssetsAsyncAction.h"
+#include "Assets/UnusedAssetScanner.h"
+#include "Logging/EditorToolsLog.h"
+#include "Logging/EditorToolsMessageLog.h"
+#include "Assets/AssetReferenceGraph.h"
+#include "Async/Async.h"
+#include "Misc/AsyncTaskNotification.h"
+
+#define LOCTEXT_NAMESPACE "FindUnusedAssetsAsyncAction"
+
+namespace
+{
+	// 每检查多少个资源更新一次进度（同时检查取消请求）
+	constexpr int32 UnusedAssetProgressInterval = 64;
+}
+
+UFindUnusedAssetsAsyncAction* UFindUnusedAssetsAsyncAction::FindUnusedAssetsInFolderAsync(EUnusedAssetCategory Category, const TArray<FString>& FolderPaths)
+{
+	UFindUnusedAssetsAsyncAction* Action = NewObject<UFindUnusedAssetsAsyncAction>();
+	Action->Category = Category;
+	Action->FolderPaths = FolderPaths;
+
+	// 编辑器工具没有 GameInstance 可注册，自行保持存活直到回调结束
+	Action->AddToRoot();
+	return Action;
+}
+
+void UFindUnusedAssetsAsyncAction::Activate()
+{
+	TArray<FString> EffectiveFolderPaths;
+	if (!FUnusedAssetScanner::ResolveFolderPaths(FUnusedAssetScanner::GetCategoryDisplayName(Category), FolderPaths, EffectiveFolderPaths))
+	{
+		Finish(TArray<FUnusedAssetInfo>(), true);
+		return;
+	}
+	FolderPaths = MoveTemp(EffectiveFolderPaths);
+
+	// 游戏线程：从注册表收集候选资源（只读取注册表数据，不加载资源）
+	FUnusedAssetScanner::CollectCandidates(MakeArrayView(&Category, 1), FolderPaths, Candidates);
+
+	const FText CategoryText = FText::FromString(FUnusedAssetScanner::GetCategoryDisplayName(Category));
+	FAsyncTaskNotificationConfig NotificationConfig;
+	NotificationConfig.TitleText = FText::Format(LOCTEXT("ScanTitle", "正在检查未使用的{0}"), CategoryText);
+	NotificationConfig.ProgressText = FText::Format(LOCTEXT("ScanProgress", "0 / {0}"), FText::AsNumber(Candidates.Num()));
+	NotificationConfig.bCanCancel = true;
+	NotificationConfig.bKeepOpenOnFailure = false;
+	NotificationConfig.LogCategory = &LogEditorTools;
+	Notification = MakeShared<FAsyncTaskNotification>(NotificationConfig);
+
+	CancelRequested = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+
+	// 工作线程只读访问候选包名和通知，结果通过索引交回游戏线程
+	TArray<FName> PackageNames;
+	PackageNames.Reserve(Candidates.Num());
+	for (const FAssetData& AssetData : Candidates)
+	{
+		PackageNames.Add(AssetData.PackageName);
+	}
+
+	TWeakObjectPtr<UFindUnusedAssetsAsyncAction> WeakThis(this);
+	TSharedPtr<FAsyncTaskNotification> TaskNotification = Notification;
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> CancelFlag = CancelRequested;
+
+	Async(EAsyncExecution::ThreadPool, [WeakThis, TaskNotification, CancelFlag, PackageNames = MoveTemp(PackageNames)]()
+	{
+		auto ShouldCancel = [&CancelFlag, &TaskNotification]()
+		{
+			return CancelFlag->load() || TaskNotification->GetPromptAction() == EAsyncTaskNotificationPromptAction::Cancel;
+		};
+
+		// 引用图快照在工作线程构建或复用，游戏线程不会被整个注册表的依赖遍历卡住；构建期间同样响应取消
+		const FAssetReferenceGraphPtr Graph = FAssetReferenceGraph::GetSnapshot(ShouldCancel);
+
+		TArray<int32> UnusedCandidateIndices;
+		bool bWasCancelled = !Graph.IsValid();
+		for (int32 Index = 0; !bWasCancelled && Index < PackageNames.Num(); ++Index)
+		{
+			if (Index % UnusedAssetProgressInterval == 0)
+			{
+				if (ShouldCancel())
+				{
+					bWasCancelled = true;
+					break;
+				}
+
+				TaskNotification->SetProgressText(FText::Format(LOCTEXT("ScanProgressCount", "{0} / {1}"),
+					FText::AsNumber(Index), FText::AsNumber(PackageNames.Num())));
+			}
+
+			if (!FUnusedAssetScanner::IsReferencedByProject(*Graph, PackageNames[Index]))
+			{
+				UnusedCandidateIndices.Add(Index);
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, bWasCancelled, UnusedCandidateIndices = MoveTemp(UnusedCandidateIndices)]() mutable
+		{
+			if (UFindUnusedAssetsAsyncAction* Action = WeakThis.Get())
+			{
+				Action->OnScanFinished(MoveTemp(UnusedCandidateIndices), bWasCancelled);
+			}
+		});
+	});
+}
+
+void UFindUnusedAssetsAsyncAction::Cancel()
+{
+	if (CancelRequested.IsValid())
+	{
+		CancelRequested->store(true);
+	}
+}
+
+void UFindUnusedAssetsAsyncAction::OnScanFinished(TArray<int32>&& UnusedCandidateIndices, bool bWasCancelled)
+{
+	TArray<FUnusedAssetInfo> UnusedAssets;
+	UnusedAssets.Reserve(UnusedCandidateIndices.Num());
+	for (int32 CandidateIndex : UnusedCandidateIndices)
+	{
+		UnusedAssets.Add(FUnusedAssetScanner::MakeUnusedAssetInfo(Candidates[CandidateIndex]));
+	}
+
+	const FText CategoryText = FText::FromString(FUnusedAssetScanner::GetCategoryDisplayName(Category));
+	if (Notification.IsValid())
+	{
+		if (bWasCancelled)
+		{
+			Notification->SetComplete(
+				FText::Format(LOCTEXT("ScanCancelled", "已取消检查未使用的{0}"), CategoryText),
+				FText::GetEmpty(),
+				false);
+		}
+		else
+		{
+			Notification->SetComplete(
+				FText::Format(LOCTEXT("ScanCompleted", "检查未使用的{0}完成"), CategoryText),
+				FText::Format(LOCTEXT("ScanCompletedCount", "发现 {0} 个未使用的资源"), FText::AsNumber(UnusedAssets.Num())),
+				true);
+		}
+		Notification.Reset();
+	}
+
+	if (!bWasCancelled)
+	{
+		FEditorToolsMessageLog::ShowUnusedAssetsReport(FUnusedAssetScanner::GetCategoryDisplayName(Category), FolderPaths, UnusedAssets, Candidates.Num());
+	}
+
+	Finish(UnusedAssets, bWasCancelled);
+}
+
+void UFindUnusedAssetsAsyncAction::Finish(const TArray<FUnusedAssetInfo>& UnusedAssets, bool bWasCancelled)
+{
+	if (bWasCancelled)
+	{
+		OnCancelled.Broadcast(UnusedAssets);
+	}
+	else
+	{
+		OnCompleted.Broadcast(UnusedAssets);
+	}
+
+	Candidates.Empty();
+	SetReadyToDestroy();
+	RemoveFromRoot();
+}
+
+#undef LOCTEXT_NAMESPACE
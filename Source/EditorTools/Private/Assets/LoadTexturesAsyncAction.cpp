@@ -0,0 +1,136 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/LoadTexturesAsyncAction.h"
+#include "EditorToolsUtilities.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Texture.h"
+#include "Misc/PackageName.h"
+
+namespace
+{
+	/**
+	 * 通过注册表把路径和文件名解析为纹理的对象路径，不加载资源
+	 * 对象名与包名不一致时退回到包内的第一个纹理
+	 */
+	static FSoftObjectPath ResolveTexturePath(const IAssetRegistry& AssetRegistry, const FString& AssetPath, const FString& AssetName)
+	{
+		if (AssetPath.IsEmpty() || AssetName.IsEmpty())
+		{
+			return FSoftObjectPath();
+		}
+
+		const FString AssetReference = UEditorToolsUtilities::MakeAssetObjectPath(AssetPath, AssetName);
+		const FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(AssetReference));
+		if (AssetData.IsValid())
+		{
+			return AssetData.IsInstanceOf(UTexture::StaticClass()) ? AssetData.GetSoftObjectPath() : FSoftObjectPath();
+		}
+
+		TArray<FAssetData> PackageAssets;
+		AssetRegistry.GetAssetsByPackageName(FName(*FPackageName::ObjectPathToPackageName(AssetReference)), PackageAssets);
+		for (const FAssetData& PackageAsset : PackageAssets)
+		{
+			if (PackageAsset.IsInstanceOf(UTexture::StaticClass()))
+			{
+				return PackageAsset.GetSoftObjectPath();
+			}
+		}
+		return FSoftObjectPath();
+	}
+}
+
+ULoadTexturesAsyncAction* ULoadTexturesAsyncAction::LoadTexturesFromPathsAsync(const TArray<FString>& AssetPaths, const TArray<FString>& AssetNames)
+{
+	ULoadTexturesAsyncAction* Action = NewObject<ULoadTexturesAsyncAction>();
+	Action->AssetPaths = AssetPaths;
+	Action->AssetNames = AssetNames;
+
+	// 编辑器工具没有 GameInstance 可注册，自行保持存活直到回调结束
+	Action->AddToRoot();
+	return Action;
+}
+
+void ULoadTexturesAsyncAction::Activate()
+{
+	if (AssetPaths.Num() != 1 && AssetPaths.Num() != AssetNames.Num())
+	{
+		UE_LOG(LogEditorTools, Error, TEXT("LoadTexturesFromPathsAsync: AssetPaths 数量 (%d) 必须为 1 或与 AssetNames 数量 (%d) 一致"),
+			AssetPaths.Num(), AssetNames.Num());
+		AssetNames.Reset();
+		Finish();
+		return;
+	}
+
+	// 游戏线程：只查询注册表，同一纹理出现多次时只请求一次
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	TArray<FSoftObjectPath> PathsToLoad;
+	TSet<FSoftObjectPath> SeenPaths;
+	ResolvedPaths.SetNum(AssetNames.Num());
+	for (int32 Index = 0; Index < AssetNames.Num(); ++Index)
+	{
+		const FString& AssetPath = AssetPaths.Num() == 1 ? AssetPaths[0] : AssetPaths[Index];
+		ResolvedPaths[Index] = ResolveTexturePath(AssetRegistry, AssetPath, AssetNames[Index]);
+		if (ResolvedPaths[Index].IsNull())
+		{
+			UE_LOG(LogEditorTools, Warning, TEXT("LoadTexturesFromPathsAsync: 找不到纹理 %s"),
+				*UEditorToolsUtilities::MakeAssetObjectPath(AssetPath, AssetNames[Index]));
+			continue;
+		}
+
+		bool bAlreadySeen = false;
+		SeenPaths.Add(ResolvedPaths[Index], &bAlreadySeen);
+		if (!bAlreadySeen)
+		{
+			PathsToLoad.Add(ResolvedPaths[Index]);
+		}
+	}
+
+	if (PathsToLoad.Num() == 0)
+	{
+		Finish();
+		return;
+	}
+
+	// 先挂起再启动，保证全部已加载时同步触发的回调也能拿到句柄
+	LoadHandle = StreamableManager.RequestAsyncLoad(MoveTemp(PathsToLoad),
+		FStreamableDelegate::CreateUObject(this, &ULoadTexturesAsyncAction::Finish),
+		FStreamableManager::DefaultAsyncLoadPriority, false, true, TEXT("LoadTexturesFromPathsAsync"));
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->StartStalledHandle();
+	}
+	else
+	{
+		Finish();
+	}
+}
+
+void ULoadTexturesAsyncAction::Finish()
+{
+	TArray<UTexture*> Textures;
+	Textures.Reserve(AssetNames.Num());
+	int32 NumLoaded = 0;
+	for (int32 Index = 0; Index < AssetNames.Num(); ++Index)
+	{
+		UTexture* Texture = ResolvedPaths.IsValidIndex(Index) ? Cast<UTexture>(ResolvedPaths[Index].ResolveObject()) : nullptr;
+		NumLoaded += Texture ? 1 : 0;
+		Textures.Add(Texture);
+	}
+
+	UE_LOG(LogEditorTools, Log, TEXT("LoadTexturesFromPathsAsync: 加载了 %d / %d 个纹理"), NumLoaded, AssetNames.Num());
+
+	OnCompleted.Broadcast(Textures);
+
+	// 回调中已经拿到纹理引用，之后由调用方决定是否继续持有
+	if (LoadHandle.IsValid())
+	{
+		LoadHandle->ReleaseHandle();
+		LoadHandle.Reset();
+	}
+
+	ResolvedPaths.Empty();
+	SetReadyToDestroy();
+	RemoveFromRoot();
+}
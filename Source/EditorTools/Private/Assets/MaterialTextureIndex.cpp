@@ -0,0 +1,316 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/MaterialTextureIndex.h"
+#include "Logging/EditorToolsLog.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Texture.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstance.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+FMaterialTextureIndex* FMaterialTextureIndex::Instance = nullptr;
+
+namespace
+{
+	// 文件格式变化时递增，旧文件会被丢弃
+	constexpr uint32 MaterialTextureIndexMagic = 0x4D544958; // "MTIX"
+	constexpr int32 MaterialTextureIndexVersion = 1;
+
+	// 父材质链的最大深度，防止损坏的数据形成环
+	constexpr int32 MaxParentChainDepth = 32;
+
+	static void SerializeSoftObjectPath(FArchive& Ar, FSoftObjectPath& Path)
+	{
+		FString PathString = Ar.IsSaving() ? Path.ToString() : FString();
+		Ar << PathString;
+		if (Ar.IsLoading())
+		{
+			Path = FSoftObjectPath(PathString);
+		}
+	}
+
+	static void SerializeEntry(FArchive& Ar, FName& PackageName, FMaterialTextureIndex::FEntry& Entry)
+	{
+		FString PackageNameString = Ar.IsSaving() ? PackageName.ToString() : FString();
+		Ar << PackageNameString;
+		Ar << Entry.PackageSavedHash;
+		SerializeSoftObjectPath(Ar, Entry.MaterialPath);
+		SerializeSoftObjectPath(Ar, Entry.ParentPath);
+
+		int32 NumTextures = Entry.Textures.Num();
+		Ar << NumTextures;
+		if (Ar.IsLoading())
+		{
+			PackageName = FName(*PackageNameString);
+			Entry.Textures.SetNum(Ar.IsError() ? 0 : FMath::Max(NumTextures, 0));
+		}
+
+		for (FMaterialTextureBinding& Binding : Entry.Textures)
+		{
+			FString ParameterName = Ar.IsSaving() ? Binding.ParameterName.ToString() : FString();
+			Ar << ParameterName;
+			SerializeSoftObjectPath(Ar, Binding.Texture);
+			if (Ar.IsLoading())
+			{
+				Binding.ParameterName = FName(*ParameterName);
+			}
+		}
+	}
+}
+
+FMaterialTextureIndex& FMaterialTextureIndex::Get()
+{
+	check(IsInGameThread());
+	if (!Instance)
+	{
+		Instance = new FMaterialTextureIndex();
+		Instance->Load();
+	}
+	return *Instance;
+}
+
+void FMaterialTextureIndex::Shutdown()
+{
+	if (Instance)
+	{
+		Instance->Save();
+	}
+	delete Instance;
+	Instance = nullptr;
+}
+
+FString FMaterialTextureIndex::GetCacheFilename()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("EditorTools"), TEXT("MaterialTextureIndex.bin"));
+}
+
+FIoHash FMaterialTextureIndex::GetPackageSavedHash(const IAssetRegistry& AssetRegistry, FName PackageName)
+{
+	const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+	return PackageData.IsSet() ? PackageData->GetPackageSavedHash() : FIoHash::Zero;
+}
+
+bool FMaterialTextureIndex::TryMakeEntryFromRegistry(const IAssetRegistry& AssetRegistry, const FAssetData& AssetData, const FIoHash& PackageSavedHash, FEntry& OutEntry)
+{
+	// 依赖了任何纹理都需要加载才能知道参数名
+	TArray<FName> Dependencies;
+	AssetRegistry.GetDependencies(AssetData.PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+	for (const FName& Dependency : Dependencies)
+	{
+		TArray<FAssetData> DependencyAssets;
+		AssetRegistry.GetAssetsByPackageName(Dependency, DependencyAssets, true);
+		for (const FAssetData& DependencyAsset : DependencyAssets)
+		{
+			if (DependencyAsset.IsInstanceOf(UTexture::StaticClass()))
+			{
+				return false;
+			}
+		}
+	}
+
+	OutEntry = FEntry();
+	OutEntry.PackageSavedHash = PackageSavedHash;
+	OutEntry.MaterialPath = AssetData.GetSoftObjectPath();
+
+	if (AssetData.IsInstanceOf(UMaterialInstance::StaticClass()))
+	{
+		// 材质实例没有纹理覆盖，有效绑定完全来自父材质
+		FString ParentTag;
+		if (!AssetData.GetTagValue(GET_MEMBER_NAME_CHECKED(UMaterialInstance, Parent), ParentTag) || ParentTag.IsEmpty() || ParentTag == TEXT("None"))
+		{
+			return false;
+		}
+		OutEntry.ParentPath = FSoftObjectPath(FPackageName::ExportTextPathToObjectPath(ParentTag));
+	}
+	return true;
+}
+
+FMaterialTextureIndex::FEntry FMaterialTextureIndex::MakeEntry(const UMaterialInterface* Material, const FIoHash& PackageSavedHash)
+{
+	FEntry Entry;
+	Entry.PackageSavedHash = PackageSavedHash;
+	Entry.MaterialPath = FSoftObjectPath(Material);
+
+	if (const UMaterialInstance* MaterialInstance = Cast<UMaterialInstance>(Material))
+	{
+		Entry.ParentPath = FSoftObjectPath(MaterialInstance->Parent);
+		for (const FTextureParameterValue& Value : MaterialInstance->TextureParameterValues)
+		{
+			Entry.Textures.Emplace(Value.ParameterInfo.Name, FSoftObjectPath(Value.ParameterValue));
+		}
+		return Entry;
+	}
+
+	TArray<FMaterialParameterInfo> ParameterInfos;
+	TArray<FGuid> ParameterIds;
+	Material->GetAllTextureParameterInfo(ParameterInfos, ParameterIds);
+	for (const FMaterialParameterInfo& ParameterInfo : ParameterInfos)
+	{
+		UTexture* Texture = nullptr;
+		Material->GetTextureParameterValue(ParameterInfo, Texture);
+		Entry.Textures.Emplace(ParameterInfo.Name, FSoftObjectPath(Texture));
+	}
+	return Entry;
+}
+
+bool FMaterialTextureIndex::IsUpToDate(FName PackageName, const FIoHash& PackageSavedHash) const
+{
+	const FEntry* Entry = Entries.Find(PackageName);
+	return Entry && !PackageSavedHash.IsZero() && Entry->PackageSavedHash == PackageSavedHash;
+}
+
+void FMaterialTextureIndex::SetEntry(FName PackageName, FEntry&& Entry)
+{
+	Entries.Add(PackageName, MoveTemp(Entry));
+	bDirty = true;
+}
+
+void FMaterialTextureIndex::RemoveEntry(FName PackageName)
+{
+	if (Entries.Remove(PackageName) > 0)
+	{
+		bDirty = true;
+	}
+}
+
+bool FMaterialTextureIndex::ResolveBindings(FName PackageName, TArray<FMaterialTextureBinding>& OutBindings) const
+{
+	OutBindings.Reset();
+	if (!ResolveBindingsRecursive(PackageName, 0, OutBindings))
+	{
+		return false;
+	}
+
+	OutBindings.Sort([](const FMaterialTextureBinding& A, const FMaterialTextureBinding& B)
+	{
+		return A.ParameterName.LexicalLess(B.ParameterName);
+	});
+	return true;
+}
+
+bool FMaterialTextureIndex::ResolveBindingsRecursive(FName PackageName, int32 Depth, TArray<FMaterialTextureBinding>& OutBindings) const
+{
+	const FEntry* Entry = Entries.Find(PackageName);
+	if (!Entry || Depth > MaxParentChainDepth)
+	{
+		return false;
+	}
+
+	if (!Entry->ParentPath.IsNull())
+	{
+		ResolveBindingsRecursive(Entry->ParentPath.GetLongPackageFName(), Depth + 1, OutBindings);
+	}
+
+	// 子实例的覆盖值替换父材质链上的同名参数
+	for (const FMaterialTextureBinding& Binding : Entry->Textures)
+	{
+		if (FMaterialTextureBinding* Existing = OutBindings.FindByPredicate([&Binding](const FMaterialTextureBinding& Other) { return Other.ParameterName == Binding.ParameterName; }))
+		{
+			Existing->Texture = Binding.Texture;
+		}
+		else
+		{
+			OutBindings.Add(Binding);
+		}
+	}
+	return true;
+}
+
+bool FMaterialTextureIndex::Load()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *GetCacheFilename(), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 NumEntries = 0;
+	Reader << Magic << Version << NumEntries;
+	if (Reader.IsError() || Magic != MaterialTextureIndexMagic || Version != MaterialTextureIndexVersion || NumEntries < 0)
+	{
+		UE_LOG(LogEditorTools, Log, TEXT("材质纹理索引缓存格式不匹配，将重新建立"));
+		return false;
+	}
+
+	Entries.Reserve(NumEntries);
+	for (int32 Index = 0; Index < NumEntries && !Reader.IsError(); ++Index)
+	{
+		FName PackageName;
+		FEntry Entry;
+		SerializeEntry(Reader, PackageName, Entry);
+		Entries.Add(PackageName, MoveTemp(Entry));
+	}
+
+	if (Reader.IsError())
+	{
+		UE_LOG(LogEditorTools, Warning, TEXT("材质纹理索引缓存已损坏，将重新建立：%s"), *GetCacheFilename());
+		Entries.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FMaterialTextureIndex::PruneMissingPackages()
+{
+	// 注册表还在扫描时包可能只是尚未发现，等扫描完成后再清理
+	const IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+	if (!AssetRegistry || AssetRegistry->IsLoadingAssets())
+	{
+		return;
+	}
+
+	// 已删除或重命名的包查不到保存哈希，它们的条目永远不会再命中
+	const int32 NumEntriesBefore = Entries.Num();
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		if (GetPackageSavedHash(*AssetRegistry, It.Key()).IsZero())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (Entries.Num() != NumEntriesBefore)
+	{
+		UE_LOG(LogEditorTools, Log, TEXT("材质纹理索引：移除了 %d 个已不存在的包"), NumEntriesBefore - Entries.Num());
+		bDirty = true;
+	}
+}
+
+bool FMaterialTextureIndex::Save()
+{
+	PruneMissingPackages();
+
+	if (!bDirty)
+	{
+		return true;
+	}
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	uint32 Magic = MaterialTextureIndexMagic;
+	int32 Version = MaterialTextureIndexVersion;
+	int32 NumEntries = Entries.Num();
+	Writer << Magic << Version << NumEntries;
+	for (TPair<FName, FEntry>& Pair : Entries)
+	{
+		FName PackageName = Pair.Key;
+		SerializeEntry(Writer, PackageName, Pair.Value);
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Data, *GetCacheFilename()))
+	{
+		UE_LOG(LogEditorTools, Warning, TEXT("无法写入材质纹理索引缓存：%s"), *GetCacheFilename());
+		return false;
+	}
+
+	bDirty = false;
+	return true;
+}
@@ -0,0 +1,179 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Assets/UnusedAssetScanner.h"
+#include "EditorToolsUtilities.h"
+#include "Logging/EditorToolsMessageLog.h"
+#include "Assets/AssetReferenceGraph.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "ContentBrowserModule.h"
+#include "IContentBrowserSingleton.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/SkeletalMesh.h"
+#include "Algo/AnyOf.h"
+
+#define LOCTEXT_NAMESPACE "FUnusedAssetScanner"
+
+namespace
+{
+	static bool MatchesCategory(const FAssetData& AssetData, EUnusedAssetCategory Category)
+	{
+		switch (Category)
+		{
+		case EUnusedAssetCategory::Mesh:
+			return AssetData.AssetClassPath == UStaticMesh::StaticClass()->GetClassPathName()
+				|| AssetData.AssetClassPath == USkeletalMesh::StaticClass()->GetClassPathName();
+		case EUnusedAssetCategory::Material:
+			return AssetData.AssetClassPath.GetAssetName().ToString().Contains(TEXT("Material"));
+		case EUnusedAssetCategory::Texture:
+			return AssetData.AssetClassPath.GetAssetName().ToString().Contains(TEXT("Texture"));
+		default:
+			return false;
+		}
+	}
+}
+
+FString FUnusedAssetScanner::GetCategoryDisplayName(EUnusedAssetCategory Category)
+{
+	switch (Category)
+	{
+	case EUnusedAssetCategory::Mesh:
+		return TEXT("模型");
+	case EUnusedAssetCategory::Material:
+		return TEXT("材质");
+	case EUnusedAssetCategory::Texture:
+		return TEXT("贴图");
+	default:
+		return TEXT("资源");
+	}
+}
+
+FString FUnusedAssetScanner::GetCategoryDisplayName(TConstArrayView<EUnusedAssetCategory> Categories)
+{
+	return Categories.Num() == 1 ? GetCategoryDisplayName(Categories[0]) : FString(TEXT("资源"));
+}
+
+bool FUnusedAssetScanner::ResolveFolderPaths(const FString& DisplayName, const TArray<FString>& FolderPaths, TArray<FString>& OutFolderPaths)
+{
+	OutFolderPaths = FolderPaths;
+
+#if WITH_EDITOR
+	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
+	if (OutFolderPaths.Num() == 0)
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().GetSelectedFolders(OutFolderPaths);
+	}
+
+	if (OutFolderPaths.Num() == 0)
+	{
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			FText::Format(LOCTEXT("FolderPathEmpty", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查未使用的{0}”。"),
+				FText::FromString(DisplayName))
+		);
+		return false;
+	}
+#endif
+
+	return OutFolderPaths.Num() > 0;
+}
+
+void FUnusedAssetScanner::CollectCandidates(TConstArrayView<EUnusedAssetCategory> Categories, const TArray<FString>& FolderPaths, TArray<FAssetData>& OutCandidates)
+{
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// 多个文件夹可能互相嵌套，按包名去重
+	TSet<FName> SeenPackages;
+	for (const FString& FolderPath : FolderPaths)
+	{
+		// 注册表中的包路径不带结尾的 /
+		FString SearchPath = UEditorToolsUtilities::NormalizeFolderPath(FolderPath);
+		SearchPath.RemoveFromEnd(TEXT("/"));
+
+		// 递归查询已经限定在该文件夹内，无需再按路径前缀过滤
+		TArray<FAssetData> FolderAssets;
+		AssetRegistry.GetAssetsByPath(FName(*SearchPath), FolderAssets, true);
+
+		for (FAssetData& AssetData : FolderAssets)
+		{
+			const bool bMatchesAnyCategory = Algo::AnyOf(Categories, [&AssetData](EUnusedAssetCategory Category)
+			{
+				return MatchesCategory(AssetData, Category);
+			});
+			if (!bMatchesAnyCategory)
+			{
+				continue;
+			}
+
+			bool bAlreadySeen = false;
+			SeenPackages.Add(AssetData.PackageName, &bAlreadySeen);
+			if (!bAlreadySeen)
+			{
+				OutCandidates.Add(MoveTemp(AssetData));
+			}
+		}
+	}
+}
+
+bool FUnusedAssetScanner::IsReferencedByProject(const FAssetReferenceGraph& Graph, FName PackageName)
+{
+	const int32 PackageIndex = Graph.FindPackageIndex(PackageName);
+	return PackageIndex != INDEX_NONE && Graph.IsReferencedByProjectPackage(PackageIndex);
+}
+
+FUnusedAssetInfo FUnusedAssetScanner::MakeUnusedAssetInfo(const FAssetData& AssetData)
+{
+	FUnusedAssetInfo Info;
+	Info.AssetPath = AssetData.PackagePath.ToString();
+	Info.AssetName = AssetData.AssetName.ToString();
+	Info.AssetType = AssetData.AssetClassPath.GetAssetName().ToString();
+	Info.AssetSoftPath = AssetData.GetSoftObjectPath();
+	Info.AssetObject = AssetData.FastGetAsset(false);
+
+	AssetData.TagsAndValues.ForEach([&Info](const TPair<FName, FAssetTagValueRef>& TagPair)
+	{
+		Info.AssetTags.Add(TagPair.Key, TagPair.Value.AsString());
+	});
+
+	return Info;
+}
+
+TArray<FUnusedAssetInfo> FUnusedAssetScanner::FindUnusedAssets(EUnusedAssetCategory Category, const TArray<FString>& FolderPaths)
+{
+	return FindUnusedAssets(MakeArrayView(&Category, 1), FolderPaths);
+}
+
+TArray<FUnusedAssetInfo> FUnusedAssetScanner::FindUnusedAssets(TConstArrayView<EUnusedAssetCategory> Categories, const TArray<FString>& FolderPaths)
+{
+	TArray<FUnusedAssetInfo> UnusedAssets;
+
+#if WITH_EDITOR
+	const FString DisplayName = GetCategoryDisplayName(Categories);
+
+	TArray<FString> EffectiveFolderPaths;
+	if (!ResolveFolderPaths(DisplayName, FolderPaths, EffectiveFolderPaths))
+	{
+		return UnusedAssets;
+	}
+
+	TArray<FAssetData> Candidates;
+	CollectCandidates(Categories, EffectiveFolderPaths, Candidates);
+
+	// 检查每个资源是否被引用（引用图快照在注册表没有变化时会复用）
+	const FAssetReferenceGraphRef Graph = FAssetReferenceGraph::GetSnapshot();
+	for (const FAssetData& AssetData : Candidates)
+	{
+		if (!IsReferencedByProject(*Graph, AssetData.PackageName))
+		{
+			UnusedAssets.Add(MakeUnusedAssetInfo(AssetData));
+		}
+	}
+
+	// 显示可点击的消息日志
+	FEditorToolsMessageLog::ShowUnusedAssetsReport(DisplayName, EffectiveFolderPaths, UnusedAssets, Candidates.Num());
+#endif
+
+	return UnusedAssets;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -3,6 +3,10 @@
 #include "EditorTools.h"
 #include "EditorToolsStyle.h"
 #include "Logging/EditorToolsMessageLog.h"
+#include "Analysis/EditorToolsMeshStatsCache.h"
+#include "Analysis/EditorToolsMaterialStatsCache.h"
+#include "Assets/AssetReferenceGraph.h"
+#include "Assets/MaterialTextureIndex.h"
 
 #include "Interfaces/IPluginManager.h"
 #include "ToolMenus.h"
@@ -24,6 +28,15 @@ void FEditorToolsModule::StartupModule()
 	
 	// 初始化消息日志系统
 	FEditorToolsMessageLog::Initialize();
+
+	// 初始化网格体统计缓存
+	FEditorToolsMeshStatsCache::Initialize();
+
+	// 初始化材质着色器统计缓存
+	FEditorToolsMaterialStatsCache::Initialize();
+
+	// 注册资产引用图快照的失效回调
+	FAssetReferenceGraph::Initialize();
 	
 	// 注册菜单扩展（延迟到 ToolMenus 系统初始化后）
 	UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FEditorToolsModule::RegisterMenuExtensions));
@@ -35,6 +48,18 @@ void FEditorToolsModule::ShutdownModule()
 	UToolMenus::UnRegisterStartupCallback(this);
 	UToolMenus::UnregisterOwner(this);
 	
+	// 释放资产引用图快照
+	FAssetReferenceGraph::Shutdown();
+
+	// 保存并释放材质纹理索引
+	FMaterialTextureIndex::Shutdown();
+
+	// 关闭材质着色器统计缓存
+	FEditorToolsMaterialStatsCache::Shutdown();
+
+	// 关闭网格体统计缓存
+	FEditorToolsMeshStatsCache::Shutdown();
+
 	// 关闭自定义样式
 	FEditorToolsStyle::Shutdown();
 }
@@ -10,9 +10,6 @@
 #include "Logging/TokenizedMessage.h"
 #include "Logging/MessageLog.h"
 #include "Logging/DisplayNameUtils.h"
-#include "AssetToolsModule.h"
-#include "IAssetTools.h"
-#include "Factories/MaterialInstanceConstantFactoryNew.h"
 #include "Materials/Material.h"
 #include "Misc/PackageName.h"
 #include "UObject/SavePackage.h"
@@ -70,6 +67,13 @@
 #include "RendererInterface.h"
 #include "RenderingThread.h"
 #include "StaticMeshBatch.h"
+#include "Async/ParallelFor.h"
+#include "Analysis/EditorToolsMeshStatsCache.h"
+#include "Analysis/EditorToolsMaterialStatsCache.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Analysis/EditorToolsSceneIndexSubsystem.h"
+#include "Assets/UnusedAssetScanner.h"
+#include "Assets/DuplicateMaterialInstanceScanner.h"
 
 
 #define LOCTEXT_NAMESPACE "FEditorToolsBPFLibrary"
@@ -128,13 +132,15 @@ namespace
 
 				StaticMeshActor->Modify();
 				MeshComp->Modify();
-				MeshComp->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
-				MeshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+				// 通过组件接口修改，物理过滤数据和导航数据会随 OnComponentCollisionSettingsChanged 更新；
+				// NoCollision 配置本身就关闭了碰撞，这里先跳过重叠更新，改完后按Actor统一更新一次
 				MeshComp->SetGenerateOverlapEvents(false);
+				MeshComp->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName, false);
 				MeshComp->SetNotifyRigidBodyCollision(false);
-				MeshComp->UpdateCollisionProfile();
 				MeshComp->MarkRenderStateDirty();
-				StaticMeshActor->ReregisterAllComponents();
+
+				StaticMeshActor->UpdateOverlaps();
 			}
 		}
 
@@ -188,9 +194,9 @@ namespace
 
 				StaticMeshActor->Modify();
 				MeshComp->Modify();
+
+				// SetCastShadow 只标记渲染状态脏，帧末统一重建场景代理，不再重新注册整个Actor
 				MeshComp->SetCastShadow(false);
-				MeshComp->MarkRenderStateDirty();
-				StaticMeshActor->ReregisterAllComponents();
 			}
 		}
 
@@ -211,6 +217,12 @@ namespace
 	{
 		FActorDrawCallInfo* TargetInfo = nullptr;
 		TArray<FPrimitiveSceneProxy*> SceneProxies;
+
+		// 与 SceneProxies 一一对应：代理没有缓存静态网格批次（走动态绘制路径）时使用的保底DrawCall数
+		TArray<int32> FallbackDrawCalls;
+
+		// 由渲染线程写入：LOD0 网格批次元素数量
+		int32 LOD0MeshBatchElements = 0;
 	};
 
 	static FString BuildMeshTypeLabel(const AActor* Actor)
@@ -252,6 +264,229 @@ namespace
 
 		return true;
 	}
+
+	static void FillDrawCallActorFields(AActor* Actor, FActorDrawCallInfo& Info)
+	{
+		Info.Actor = Actor;
+		Info.ActorName = Actor->GetActorLabel();
+		Info.ActorClass = Actor->GetClass()->GetName();
+		Info.ActorLocation = Actor->GetActorLocation();
+		Info.MeshTypeText = BuildMeshTypeLabel(Actor);
+	}
+
+	/**
+	 * 逐Actor隐藏/显示并对比 GNumDrawCallsRHI（每个Actor需要两次完整重绘）
+	 */
+	static void GatherDrawCallsByAblation(const TArray<AActor*>& Actors, TArray<FActorDrawCallInfo>& OutResults)
+	{
+		// 准备环境：关闭遮挡剔除
+		static const auto CVarAllowOcclusionCulling = IConsoleManager::Get().FindConsoleVariable(TEXT("r.AllowOcclusionCulling"));
+		const int32 OldAllowOcclusionCulling = CVarAllowOcclusionCulling ? CVarAllowOcclusionCulling->GetInt() : 1;
+
+		if (CVarAllowOcclusionCulling)
+		{
+			CVarAllowOcclusionCulling->Set(0, ECVF_SetByCode);
+		}
+
+		// 强制重绘
+		if (GEditor) GEditor->RedrawAllViewports();
+		FlushRenderingCommands();
+
+		// 逐个分析Actor (Hybrid: Ablation + Estimation)
+		FScopedSlowTask SlowTask(Actors.Num(), LOCTEXT("CalculatingDrawCalls", "正在计算Actor Draw Calls... (这可能需要一些时间)"));
+		SlowTask.MakeDialog();
+
+		for (AActor* Actor : Actors)
+		{
+			SlowTask.EnterProgressFrame(1.f, FText::FromString(FString::Printf(TEXT("分析: %s"), *Actor->GetActorLabel())));
+
+			if (!IsValid(Actor)) continue;
+
+			// --- 估算部分 (Estimation) ---
+			// 统计组件和材质槽作为保底值
+			int32 ActiveComponentCount = 0;
+			int32 TotalMaterialSlots = 0;
+			TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor);
+			for (UPrimitiveComponent* PrimComp : PrimitiveComponents)
+			{
+				if (ShouldIncludePrimitiveComponent(PrimComp, 0.f))
+				{
+					ActiveComponentCount++;
+					TotalMaterialSlots += PrimComp->GetNumMaterials();
+				}
+			}
+
+			// --- 测量部分 (Ablation) ---
+			int32 AblationDrawCalls = 0;
+
+			// 步骤 A: 测量 "可见" 状态
+			bool bOriginalHidden = Actor->IsHidden();
+			Actor->SetActorHiddenInGame(false);
+			Actor->SetIsTemporarilyHiddenInEditor(false);
+
+			if (GEditor) GEditor->RedrawAllViewports();
+			FlushRenderingCommands();
+			const uint32 VisibleDrawCalls = *GNumDrawCallsRHI;
+
+			// 步骤 B: 测量 "隐藏" 状态
+			Actor->SetActorHiddenInGame(true);
+			Actor->SetIsTemporarilyHiddenInEditor(true);
+
+			if (GEditor) GEditor->RedrawAllViewports();
+			FlushRenderingCommands();
+			const uint32 HiddenDrawCalls = *GNumDrawCallsRHI;
+
+			// 步骤 C: 恢复状态
+			Actor->SetActorHiddenInGame(bOriginalHidden);
+			Actor->SetIsTemporarilyHiddenInEditor(false);
+
+			AblationDrawCalls = (int32)VisibleDrawCalls - (int32)HiddenDrawCalls;
+
+			// --- 混合结果 (Hybrid) ---
+			// 如果Ablation失败(<=0)，使用材质数量作为保底估计
+			// 即使Ablation成功，如果它小于材质数(不太可能，除非被完全遮挡且我们没关掉遮挡剔除)，也取最大值比较安全
+			int32 FinalDrawCalls = FMath::Max(AblationDrawCalls, TotalMaterialSlots);
+
+			// 只有在真的有东西画的时候才记录
+			if (FinalDrawCalls > 0)
+			{
+				FActorDrawCallInfo& Info = OutResults.AddDefaulted_GetRef();
+				FillDrawCallActorFields(Actor, Info);
+				Info.TotalDrawCalls = FinalDrawCalls;
+				Info.LOD0DrawCalls = FinalDrawCalls;
+				Info.ComponentCount = ActiveComponentCount;
+				Info.TotalMaterialSlots = TotalMaterialSlots;
+
+				// 详细日志用于调试
+				UE_LOG(LogEditorTools, Verbose, TEXT("Actor: %s | Ablation: %d | Materials: %d | Final: %d"),
+					*Info.ActorName, AblationDrawCalls, TotalMaterialSlots, FinalDrawCalls);
+			}
+		}
+
+		// 恢复环境
+		if (CVarAllowOcclusionCulling)
+		{
+			CVarAllowOcclusionCulling->Set(OldAllowOcclusionCulling, ECVF_SetByCode);
+		}
+
+		// 恢复场景状态
+		if (GEditor) GEditor->RedrawAllViewports();
+		FlushRenderingCommands();
+	}
+
+	/**
+	 * 在游戏线程收集每个Actor的场景代理，然后在渲染线程一次性遍历 FPrimitiveSceneInfo::StaticMeshes 统计LOD0网格批次
+	 * 整个过程只需要一帧，不需要隐藏/显示Actor
+	 */
+	static void GatherDrawCallsBySceneProxies(const TArray<AActor*>& Actors, TArray<FActorDrawCallInfo>& OutResults)
+	{
+		// 先渲染一帧，保证新注册组件的 PrimitiveSceneInfo 与静态网格批次已在渲染线程创建
+		if (GEditor) GEditor->RedrawAllViewports();
+		FlushRenderingCommands();
+
+		// 预先分配好结果，渲染线程通过 TargetInfo 指针回写，期间数组不能扩容
+		TArray<FActorDrawCallInfo> Infos;
+		Infos.SetNum(Actors.Num());
+
+		TArray<FActorDrawCallRenderRequest> Requests;
+		Requests.Reserve(Actors.Num());
+
+		for (int32 ActorIndex = 0; ActorIndex < Actors.Num(); ++ActorIndex)
+		{
+			AActor* Actor = Actors[ActorIndex];
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			FActorDrawCallInfo& Info = Infos[ActorIndex];
+			FillDrawCallActorFields(Actor, Info);
+
+			FActorDrawCallRenderRequest& Request = Requests.AddDefaulted_GetRef();
+			Request.TargetInfo = &Info;
+
+			TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor);
+			for (UPrimitiveComponent* PrimComp : PrimitiveComponents)
+			{
+				if (!ShouldIncludePrimitiveComponent(PrimComp, 0.f))
+				{
+					continue;
+				}
+
+				const int32 NumMaterials = PrimComp->GetNumMaterials();
+				Info.ComponentCount++;
+				Info.TotalMaterialSlots += NumMaterials;
+
+				if (PrimComp->SceneProxy)
+				{
+					// 动态路径的保底值优先使用网格体LOD0的实际分段数，取不到时再退回材质槽数
+					FEditorToolsMeshStatsPtr MeshStats;
+					if (const UStaticMeshComponent* StaticMeshComp = Cast<UStaticMeshComponent>(PrimComp))
+					{
+						MeshStats = FEditorToolsMeshStatsCache::Get().GetStaticMeshStats(StaticMeshComp->GetStaticMesh());
+					}
+					else if (const USkinnedMeshComponent* SkinnedMeshComp = Cast<USkinnedMeshComponent>(PrimComp))
+					{
+						MeshStats = FEditorToolsMeshStatsCache::Get().GetSkeletalMeshStats(Cast<USkeletalMesh>(SkinnedMeshComp->GetSkinnedAsset()));
+					}
+
+					const int32 LOD0Sections = MeshStats.IsValid() ? MeshStats->GetSectionCount(0) : 0;
+					Request.SceneProxies.Add(PrimComp->SceneProxy);
+					Request.FallbackDrawCalls.Add(LOD0Sections > 0 ? LOD0Sections : NumMaterials);
+				}
+			}
+		}
+
+		// 游戏线程在 FlushRenderingCommands 返回前一直阻塞，场景代理在此期间不会被销毁
+		ENQUEUE_RENDER_COMMAND(EditorToolsCountActorMeshBatches)(
+			[&Requests](FRHICommandListImmediate& RHICmdList)
+			{
+				for (FActorDrawCallRenderRequest& Request : Requests)
+				{
+					for (int32 ProxyIndex = 0; ProxyIndex < Request.SceneProxies.Num(); ++ProxyIndex)
+					{
+						const FPrimitiveSceneInfo* SceneInfo = Request.SceneProxies[ProxyIndex]->GetPrimitiveSceneInfo();
+
+						int32 LOD0Elements = 0;
+						if (SceneInfo)
+						{
+							for (const FStaticMeshBatch& MeshBatch : SceneInfo->StaticMeshes)
+							{
+								if (MeshBatch.LODIndex == 0)
+								{
+									LOD0Elements += MeshBatch.Elements.Num();
+								}
+							}
+						}
+
+						// 没有缓存的静态批次说明走 GetDynamicMeshElements 动态路径（如骨骼网格体），使用LOD0分段数保底
+						if (LOD0Elements == 0)
+						{
+							LOD0Elements = Request.FallbackDrawCalls[ProxyIndex];
+						}
+
+						Request.LOD0MeshBatchElements += LOD0Elements;
+					}
+				}
+			});
+		FlushRenderingCommands();
+
+		for (const FActorDrawCallRenderRequest& Request : Requests)
+		{
+			// 只有在真的有东西画的时候才记录
+			if (Request.LOD0MeshBatchElements <= 0)
+			{
+				continue;
+			}
+
+			FActorDrawCallInfo& Info = OutResults.Add_GetRef(*Request.TargetInfo);
+			Info.TotalDrawCalls = Request.LOD0MeshBatchElements;
+			Info.LOD0DrawCalls = Request.LOD0MeshBatchElements;
+
+			UE_LOG(LogEditorTools, Verbose, TEXT("Actor: %s | MeshBatches: %d | Materials: %d"),
+				*Info.ActorName, Info.TotalDrawCalls, Info.TotalMaterialSlots);
+		}
+	}
 }
 #endif
 
@@ -276,6 +511,153 @@ TArray<UMaterialInterface*> UEditorToolsBPFLibrary::GetStaticMeshMaterials(UStat
 	return Materials;
 }
 
+namespace
+{
+	/** 把保存路径拆成包路径和资源名：不含 / 时整体作为包路径并使用默认名称，包路径总是补全到 /Game/ 下 */
+	static void SplitMaterialInstanceSavePath(const FString& SavePath, FString& OutPackagePath, FString& OutAssetName)
+	{
+		// 如果路径包含资源名称，则分离；否则使用默认名称
+		if (SavePath.Contains(TEXT("/")))
+		{
+			int32 LastSlashIndex;
+			SavePath.FindLastChar(TEXT('/'), LastSlashIndex);
+			OutPackagePath = SavePath.Left(LastSlashIndex);
+			OutAssetName = SavePath.Mid(LastSlashIndex + 1);
+		}
+		else
+		{
+			OutPackagePath = SavePath;
+			OutAssetName = TEXT("MI_NewMaterialInstance");
+		}
+
+		// 确保路径以 /Game/ 开头
+		if (!OutPackagePath.StartsWith(TEXT("/Game/")))
+		{
+			if (OutPackagePath.StartsWith(TEXT("/")))
+			{
+				OutPackagePath = TEXT("/Game") + OutPackagePath;
+			}
+			else
+			{
+				OutPackagePath = TEXT("/Game/") + OutPackagePath;
+			}
+		}
+	}
+
+	/**
+	 * 创建材质实例（同路径已有材质实例时复用）并应用纹理参数，不保存
+	 * 父材质和全部参数设置完成后只调用一次 PostEditChange，着色器和统一表达式只重新缓存一次
+	 */
+	static UMaterialInstanceConstant* CreateOrUpdateMaterialInstance(const FMaterialInstanceBatchRow& Row)
+	{
+		FString PackagePath;
+		FString AssetName;
+		SplitMaterialInstanceSavePath(Row.SavePath, PackagePath, AssetName);
+
+		const FString PackageName = PackagePath + TEXT("/") + AssetName;
+		FText Reason;
+		if (!FPackageName::IsValidLongPackageName(PackageName, false, &Reason))
+		{
+			UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstancesBatch: Invalid package name %s (%s)"), *PackageName, *Reason.ToString());
+			return nullptr;
+		}
+
+		// 包已存在于磁盘时 FullyLoad 会把它加载进来，这样可以复用其中的材质实例
+		UPackage* Package = CreatePackage(*PackageName);
+		Package->FullyLoad();
+
+		UMaterialInstanceConstant* MaterialInstance = FindObject<UMaterialInstanceConstant>(Package, *AssetName);
+		const bool bCreated = MaterialInstance == nullptr;
+		if (bCreated)
+		{
+			if (FindObject<UObject>(Package, *AssetName))
+			{
+				UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstancesBatch: %s already exists and is not a material instance"), *PackageName);
+				return nullptr;
+			}
+			MaterialInstance = NewObject<UMaterialInstanceConstant>(Package, FName(*AssetName), RF_Public | RF_Standalone | RF_Transactional);
+		}
+
+		MaterialInstance->SetParentEditorOnly(Row.Parent, false);
+		for (const TPair<FName, UTexture*>& TextureParameter : Row.TextureParameters)
+		{
+			if (TextureParameter.Value)
+			{
+				MaterialInstance->SetTextureParameterValueEditorOnly(FMaterialParameterInfo(TextureParameter.Key), TextureParameter.Value);
+			}
+		}
+		MaterialInstance->PostEditChange();
+		MaterialInstance->MarkPackageDirty();
+
+		if (bCreated)
+		{
+			FAssetRegistryModule::AssetCreated(MaterialInstance);
+		}
+		return MaterialInstance;
+	}
+
+	/** 一次并发保存所有材质实例所在的包，返回保存成功的数量 */
+	static int32 SaveMaterialInstancePackages(const TArray<UMaterialInstanceConstant*>& MaterialInstances)
+	{
+		TArray<FPackageSaveInfo> SaveInfos;
+		SaveInfos.Reserve(MaterialInstances.Num());
+
+		// 多行使用同一个 SavePath 时得到的是同一个包，SaveConcurrent 不能重复保存同一个包
+		TSet<UPackage*> PackagesToSave;
+		PackagesToSave.Reserve(MaterialInstances.Num());
+		for (int32 RowIndex = 0; RowIndex < MaterialInstances.Num(); ++RowIndex)
+		{
+			UMaterialInstanceConstant* MaterialInstance = MaterialInstances[RowIndex];
+			if (!MaterialInstance)
+			{
+				continue;
+			}
+
+			UPackage* Package = MaterialInstance->GetOutermost();
+			bool bAlreadyInSet = false;
+			PackagesToSave.Add(Package, &bAlreadyInSet);
+			if (bAlreadyInSet)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("CreateMaterialInstancesBatch: Row %d uses the same SavePath as an earlier row (%s), the package is saved once"), RowIndex, *Package->GetName());
+				continue;
+			}
+
+			FPackageSaveInfo& SaveInfo = SaveInfos.AddDefaulted_GetRef();
+			SaveInfo.Package = Package;
+			SaveInfo.Asset = MaterialInstance;
+			SaveInfo.Filename = FPackageName::LongPackageNameToFilename(SaveInfo.Package->GetName(), FPackageName::GetAssetPackageExtension());
+		}
+
+		if (SaveInfos.Num() == 0)
+		{
+			return 0;
+		}
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
+		SaveArgs.Error = GError;
+		SaveArgs.bWarnOfLongFilename = true;
+		SaveArgs.SaveFlags = SAVE_NoError;
+
+		TArray<FSavePackageResultStruct> SaveResults;
+		UPackage::SaveConcurrent(SaveInfos, SaveArgs, SaveResults);
+
+		int32 SavedCount = 0;
+		for (int32 Index = 0; Index < SaveResults.Num(); ++Index)
+		{
+			if (SaveResults[Index].Result == ESavePackageResult::Success)
+			{
+				SavedCount++;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstancesBatch: Failed to save %s"), *SaveInfos[Index].Filename);
+			}
+		}
+		return SavedCount;
+	}
+}
+
 UMaterialInstanceConstant* UEditorToolsBPFLibrary::CreateMaterialInstanceFromBase(UMaterialInterface* BaseMaterial, const FString& SavePath)
 {
 	// 检查基础材质是否有效
@@ -292,81 +674,52 @@ UMaterialInstanceConstant* UEditorToolsBPFLibrary::CreateMaterialInstanceFromBas
 		return nullptr;
 	}
 
-	// 分离路径和资源名称
-	FString PackagePath;
-	FString AssetName;
-	
-	// 如果路径包含资源名称，则分离；否则使用默认名称
-	if (SavePath.Contains(TEXT("/")))
-	{
-		int32 LastSlashIndex;
-		SavePath.FindLastChar(TEXT('/'), LastSlashIndex);
-		PackagePath = SavePath.Left(LastSlashIndex);
-		AssetName = SavePath.Mid(LastSlashIndex + 1);
-	}
-	else
-	{
-		PackagePath = SavePath;
-		AssetName = TEXT("MI_NewMaterialInstance");
-	}
+	// 单个实例就是只有一行的批量创建
+	FMaterialInstanceBatchRow Row;
+	Row.Parent = BaseMaterial;
+	Row.SavePath = SavePath;
+	return CreateMaterialInstancesBatch({ Row }, true)[0];
+}
+
+TArray<UMaterialInstanceConstant*> UEditorToolsBPFLibrary::CreateMaterialInstancesBatch(const TArray<FMaterialInstanceBatchRow>& Rows, bool bSavePackages)
+{
+	TArray<UMaterialInstanceConstant*> MaterialInstances;
+	MaterialInstances.Reserve(Rows.Num());
 
-	// 确保路径以 /Game/ 开头
-	if (!PackagePath.StartsWith(TEXT("/Game/")))
+	int32 CreatedCount = 0;
 	{
-		if (PackagePath.StartsWith(TEXT("/")))
-		{
-			PackagePath = TEXT("/Game") + PackagePath;
-		}
-		else
-		{
-			PackagePath = TEXT("/Game/") + PackagePath;
-		}
-	}
+		FScopedSlowTask SlowTask(Rows.Num(), LOCTEXT("CreatingMaterialInstances", "正在创建材质实例..."));
+		SlowTask.MakeDialogDelayed(1.0f);
 
-	// 获取 AssetTools 模块
-	FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools");
-	IAssetTools& AssetTools = AssetToolsModule.Get();
+		for (const FMaterialInstanceBatchRow& Row : Rows)
+		{
+			SlowTask.EnterProgressFrame();
 
-	// 创建材质实例工厂
-	UMaterialInstanceConstantFactoryNew* Factory = NewObject<UMaterialInstanceConstantFactoryNew>();
-	Factory->InitialParent = BaseMaterial;
+			UMaterialInstanceConstant* MaterialInstance = nullptr;
+			if (!Row.Parent)
+			{
+				UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstancesBatch: Parent is null for %s"), *Row.SavePath);
+			}
+			else if (Row.SavePath.IsEmpty())
+			{
+				UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstancesBatch: SavePath is empty for parent %s"), *Row.Parent->GetName());
+			}
+			else
+			{
+				MaterialInstance = CreateOrUpdateMaterialInstance(Row);
+			}
 
-	// 创建资源
-	UObject* NewAsset = AssetTools.CreateAsset(AssetName, PackagePath, UMaterialInstanceConstant::StaticClass(), Factory);
-	
-	UMaterialInstanceConstant* NewMaterialInstance = Cast<UMaterialInstanceConstant>(NewAsset);
-	
-	if (NewMaterialInstance)
-	{
-		// 标记为已修改
-		NewMaterialInstance->MarkPackageDirty();
-		
-		// 保存资源包
-		FString PackageName = PackagePath + TEXT("/") + AssetName;
-		UPackage* Package = NewMaterialInstance->GetOutermost();
-		if (Package)
-		{
-			Package->SetDirtyFlag(true);
-			FString PackageFilename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
-			
-			FSavePackageArgs SaveArgs;
-			SaveArgs.TopLevelFlags = EObjectFlags::RF_Public | EObjectFlags::RF_Standalone;
-			SaveArgs.Error = GError;
-			SaveArgs.bForceByteSwapping = true;
-			SaveArgs.bWarnOfLongFilename = true;
-			SaveArgs.SaveFlags = SAVE_NoError;
-			
-			UPackage::SavePackage(Package, NewMaterialInstance, *PackageFilename, SaveArgs);
+			CreatedCount += MaterialInstance ? 1 : 0;
+			MaterialInstances.Add(MaterialInstance);
 		}
-		
-		UE_LOG(LogTemp, Log, TEXT("CreateMaterialInstanceFromBase: Successfully created material instance at %s"), *PackageName);
-	}
-	else
-	{
-		UE_LOG(LogTemp, Error, TEXT("CreateMaterialInstanceFromBase: Failed to create material instance"));
 	}
 
-	return NewMaterialInstance;
+	// 所有实例都创建完后统一保存，避免逐个同步写盘
+	const int32 SavedCount = bSavePackages ? SaveMaterialInstancePackages(MaterialInstances) : 0;
+
+	UE_LOG(LogTemp, Log, TEXT("CreateMaterialInstancesBatch: Created %d of %d material instances, saved %d packages"), CreatedCount, Rows.Num(), SavedCount);
+
+	return MaterialInstances;
 }
 
 void UEditorToolsBPFLibrary::SetMICTexture(UMaterialInterface* MaterialInterface, FName ParamName, UTexture* NewTexture)
@@ -517,69 +870,9 @@ UTexture* UEditorToolsBPFLibrary::LoadTextureFromPath(const FString& AssetPath,
 		return nullptr;
 	}
 
-	// 构建完整的资源路径
-	FString FullPath = AssetPath;
-	
-	// 确保路径以 /Game/ 开头
-	if (!FullPath.StartsWith(TEXT("/Game/")))
-	{
-		if (FullPath.StartsWith(TEXT("/")))
-		{
-			FullPath = TEXT("/Game") + FullPath;
-		}
-		else if (FullPath.StartsWith(TEXT("Game/")))
-		{
-			FullPath = TEXT("/") + FullPath;
-		}
-		else
-		{
-			FullPath = TEXT("/Game/") + FullPath;
-		}
-	}
-
-	// 移除路径末尾的斜杠（如果有）
-	if (FullPath.EndsWith(TEXT("/")))
-	{
-		FullPath = FullPath.Left(FullPath.Len() - 1);
-	}
-
-	// 组合完整路径
-	FullPath = FullPath + TEXT("/") + AssetName;
-
-	// 移除文件扩展名（如果用户提供了）
-	FString CleanAssetName = AssetName;
-	if (CleanAssetName.Contains(TEXT(".")))
-	{
-		int32 DotIndex;
-		CleanAssetName.FindLastChar(TEXT('.'), DotIndex);
-		CleanAssetName = CleanAssetName.Left(DotIndex);
-		
-		// 重新构建路径
-		FullPath = AssetPath;
-		if (!FullPath.StartsWith(TEXT("/Game/")))
-		{
-			if (FullPath.StartsWith(TEXT("/")))
-			{
-				FullPath = TEXT("/Game") + FullPath;
-			}
-			else if (FullPath.StartsWith(TEXT("Game/")))
-			{
-				FullPath = TEXT("/") + FullPath;
-			}
-			else
-			{
-				FullPath = TEXT("/Game/") + FullPath;
-			}
-		}
-		if (FullPath.EndsWith(TEXT("/")))
-		{
-			FullPath = FullPath.Left(FullPath.Len() - 1);
-		}
-		FullPath = FullPath + TEXT("/") + CleanAssetName;
-	}
-
-	// 添加资源引用格式（ObjectPath.ObjectName）
-	FString AssetReference = FullPath + TEXT(".") + (CleanAssetName.IsEmpty() ? AssetName : CleanAssetName);
+	// 构建资源引用（PackagePath.ObjectName）和包路径
+	const FString AssetReference = UEditorToolsUtilities::MakeAssetObjectPath(AssetPath, AssetName);
+	const FString FullPath = FPackageName::ObjectPathToPackageName(AssetReference);
 
 	// 尝试加载纹理
 	UTexture* LoadedTexture = LoadObject<UTexture>(nullptr, *AssetReference);
@@ -733,23 +1026,15 @@ int32 UEditorToolsBPFLibrary::GetStaticMeshTriangleCount(UStaticMesh* StaticMesh
 		return 0;
 	}
 
-	// 获取渲染数据
-	if (!StaticMesh->GetRenderData())
+	// 从共享缓存获取逐LOD统计（未命中时从渲染数据计算）
+	const FEditorToolsMeshStatsPtr MeshStats = FEditorToolsMeshStatsCache::Get().GetStaticMeshStats(StaticMesh);
+	if (!MeshStats.IsValid())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("GetStaticMeshTriangleCount: No render data for mesh '%s'"), *StaticMesh->GetName());
 		return 0;
 	}
 
-	// 获取指定LOD的渲染数据
-	const FStaticMeshLODResources& LODResources = StaticMesh->GetRenderData()->LODResources[LODIndex];
-	
-	// 计算总三角形数
-	int32 TotalTriangles = 0;
-	for (int32 SectionIndex = 0; SectionIndex < LODResources.Sections.Num(); ++SectionIndex)
-	{
-		const FStaticMeshSection& Section = LODResources.Sections[SectionIndex];
-		TotalTriangles += Section.NumTriangles;
-	}
+	const int32 TotalTriangles = MeshStats->GetTriangleCount(LODIndex);
 
 	UE_LOG(LogTemp, Log, TEXT("GetStaticMeshTriangleCount: Mesh '%s' LOD %d has %d triangles"), 
 		*StaticMesh->GetName(), LODIndex, TotalTriangles);
@@ -757,6 +1042,23 @@ int32 UEditorToolsBPFLibrary::GetStaticMeshTriangleCount(UStaticMesh* StaticMesh
 	return TotalTriangles;
 }
 
+namespace
+{
+	/** 将场景索引中的组件弱引用解析为裸指针数组，跳过已销毁的组件 */
+	template <typename ComponentType, typename WeakAllocatorType, typename AllocatorType>
+	static void ResolveSceneIndexComponents(const TArray<TWeakObjectPtr<ComponentType>, WeakAllocatorType>& WeakComponents, TArray<ComponentType*, AllocatorType>& OutComponents)
+	{
+		OutComponents.Reset(WeakComponents.Num());
+		for (const TWeakObjectPtr<ComponentType>& WeakComponent : WeakComponents)
+		{
+			if (ComponentType* Component = WeakComponent.Get())
+			{
+				OutComponents.Add(Component);
+			}
+		}
+	}
+}
+
 TArray<FActorLightingInfo> UEditorToolsBPFLibrary::GetActorsWithInvalidLighting(UObject* WorldContextObject, bool bIncludeOnlyStatic)
 {
 	TArray<FActorLightingInfo> ActorsWithInvalidLighting;
@@ -777,18 +1079,18 @@ TArray<FActorLightingInfo> UEditorToolsBPFLibrary::GetActorsWithInvalidLighting(
 	int32 TotalActorsChecked = 0;
 	int32 ActorsWithProblems = 0;
 
-	// 遍历世界中的所有Actor（不输出详细日志）
-	for (TActorIterator<AActor> It(World); It; ++It)
+	// 遍历场景索引中的Actor（增量维护，不再每次完整遍历世界）
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
 	{
-		AActor* Actor = *It;
+		AActor* Actor = Entry.Actor.Get();
 		if (!Actor)
 		{
 			continue;
 		}
 
 		// 获取Actor上的所有静态网格体组件
-		TArray<UStaticMeshComponent*> StaticMeshComponents;
-		Actor->GetComponents<UStaticMeshComponent>(StaticMeshComponents);
+		TArray<UStaticMeshComponent*, TInlineAllocator<8>> StaticMeshComponents;
+		ResolveSceneIndexComponents(Entry.StaticMeshComponents, StaticMeshComponents);
 
 		if (StaticMeshComponents.Num() == 0)
 		{
@@ -1081,14 +1383,73 @@ TArray<FActorLightingInfo> UEditorToolsBPFLibrary::GetActorsWithInvalidLighting(
 
 
 
-TArray<FActorMeshComplexityInfo> UEditorToolsBPFLibrary::GetHighPolyActorsInScene(UObject* WorldContextObject, int32 TriangleThreshold)
+namespace
 {
-	TArray<FActorMeshComplexityInfo> HighPolyActors;
+	// 并行统计时每个任务处理的连续Actor数量
+	constexpr int32 HighPolyScanChunkSize = 256;
+
+	/**
+	 * 单个Actor的网格体快照（游戏线程采集，工作线程只读）
+	 */
+	struct FHighPolyActorSnapshot
+	{
+		AActor* Actor = nullptr;
+		TArray<const UStaticMesh*, TInlineAllocator<4>> StaticMeshes;
+		TArray<const USkeletalMesh*, TInlineAllocator<2>> SkeletalMeshes;
+		int32 StaticMeshComponentCount = 0;
+		int32 SkeletalMeshComponentCount = 0;
+	};
 
-	if (!WorldContextObject)
+	/**
+	 * 单个Actor的三角面统计结果（由工作线程写入）
+	 */
+	struct FHighPolyActorTriangleResult
 	{
-		UE_LOG(LogTemp, Warning, TEXT("GetHighPolyActorsInScene: WorldContextObject is null"));
-		return HighPolyActors;
+		int32 LOD0Triangles = 0;
+		int32 LODNTriangles = 0;
+		int32 MaxLODCount = 0;
+	};
+
+	static void AccumulateHighPolyMeshStats(const FEditorToolsMeshStatsPtr& MeshStats, FHighPolyActorTriangleResult& OutResult)
+	{
+		const int32 NumLODs = MeshStats.IsValid() ? MeshStats->GetNumLODs() : 0;
+		if (NumLODs == 0)
+		{
+			return;
+		}
+
+		OutResult.MaxLODCount = FMath::Max(OutResult.MaxLODCount, NumLODs);
+		OutResult.LOD0Triangles += MeshStats->GetTriangleCount(0);
+		if (NumLODs > 1)
+		{
+			OutResult.LODNTriangles += MeshStats->GetTriangleCount(NumLODs - 1);
+		}
+	}
+
+	static void ReduceHighPolyActorTriangles(const FHighPolyActorSnapshot& Snapshot, FHighPolyActorTriangleResult& OutResult)
+	{
+		FEditorToolsMeshStatsCache& MeshStatsCache = FEditorToolsMeshStatsCache::Get();
+
+		for (const UStaticMesh* StaticMesh : Snapshot.StaticMeshes)
+		{
+			AccumulateHighPolyMeshStats(MeshStatsCache.GetStaticMeshStats(StaticMesh), OutResult);
+		}
+
+		for (const USkeletalMesh* SkeletalMesh : Snapshot.SkeletalMeshes)
+		{
+			AccumulateHighPolyMeshStats(MeshStatsCache.GetSkeletalMeshStats(SkeletalMesh), OutResult);
+		}
+	}
+}
+
+TArray<FActorMeshComplexityInfo> UEditorToolsBPFLibrary::GetHighPolyActorsInScene(UObject* WorldContextObject, int32 TriangleThreshold)
+{
+	TArray<FActorMeshComplexityInfo> HighPolyActors;
+
+	if (!WorldContextObject)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GetHighPolyActorsInScene: WorldContextObject is null"));
+		return HighPolyActors;
 	}
 
 	UWorld* World = WorldContextObject->GetWorld();
@@ -1101,7 +1462,11 @@ TArray<FActorMeshComplexityInfo> UEditorToolsBPFLibrary::GetHighPolyActorsInScen
 	int32 TotalActorsChecked = 0;
 	int32 HighPolyActorsCount = 0;
 
-	// 遍历世界中的所有Actor
+	// 缓存首次创建时要注册 UObject 委托，必须在游戏线程完成，工作线程只能取已有实例
+	FEditorToolsMeshStatsCache::Get();
+
+	// 1. 游戏线程：采集Actor和网格体指针快照（内联数组，不产生堆分配）
+	TArray<FHighPolyActorSnapshot> Snapshots;
 	for (TActorIterator<AActor> It(World); It; ++It)
 	{
 		AActor* Actor = *It;
@@ -1110,194 +1475,109 @@ TArray<FActorMeshComplexityInfo> UEditorToolsBPFLibrary::GetHighPolyActorsInScen
 			continue;
 		}
 
-		FActorMeshComplexityInfo ComplexityInfo;
-		ComplexityInfo.Actor = Actor;
-		ComplexityInfo.ActorLocation = Actor->GetActorLocation();
-		ComplexityInfo.ActorClass = Actor->GetClass()->GetName();
-
-#if WITH_EDITOR
-		ComplexityInfo.ActorName = Actor->GetActorLabel();
-#else
-		ComplexityInfo.ActorName = Actor->GetName();
-#endif
-
-		int32 ActorLOD0Triangles = 0;
-		int32 ActorLODNTriangles = 0;
-		int32 LODNIndex = 0;
-		int32 MaxLODCount = 0;
-		bool bHasMesh = false;
+		TInlineComponentArray<UStaticMeshComponent*> StaticMeshComponents(Actor);
+		TInlineComponentArray<USkeletalMeshComponent*> SkeletalMeshComponents(Actor);
+		if (StaticMeshComponents.Num() == 0 && SkeletalMeshComponents.Num() == 0)
+		{
+			continue;
+		}
 
-		// ============ 检查静态网格体组件 ============
-		TArray<UStaticMeshComponent*> StaticMeshComponents;
-		Actor->GetComponents<UStaticMeshComponent>(StaticMeshComponents);
+		FHighPolyActorSnapshot& Snapshot = Snapshots.AddDefaulted_GetRef();
+		Snapshot.Actor = Actor;
+		Snapshot.StaticMeshComponentCount = StaticMeshComponents.Num();
+		Snapshot.SkeletalMeshComponentCount = SkeletalMeshComponents.Num();
 
-		if (StaticMeshComponents.Num() > 0)
+		for (UStaticMeshComponent* MeshComp : StaticMeshComponents)
 		{
-			bHasMesh = true;
-			// 判断是纯静态网格体还是蓝图类
-			if (Actor->GetClass() == AStaticMeshActor::StaticClass())
-			{
-				ComplexityInfo.MeshType = EMeshType::StaticMesh;
-			}
-			else
+			UStaticMesh* StaticMesh = MeshComp ? MeshComp->GetStaticMesh() : nullptr;
+			// GetRenderData 会等待异步编译完成，保证工作线程查询缓存时渲染数据已就绪
+			if (StaticMesh && StaticMesh->GetRenderData())
 			{
-				// 蓝图类或其他派生类
-				ComplexityInfo.MeshType = EMeshType::StaticMesh;
+				Snapshot.StaticMeshes.Add(StaticMesh);
 			}
-			ComplexityInfo.ComponentCount = StaticMeshComponents.Num();
-
-			for (UStaticMeshComponent* MeshComp : StaticMeshComponents)
-			{
-				if (!MeshComp || !MeshComp->GetStaticMesh())
-				{
-					continue;
-				}
-
-				UStaticMesh* StaticMesh = MeshComp->GetStaticMesh();
-				if (!StaticMesh->GetRenderData())
-				{
-					continue;
-				}
-
-				int32 NumLODs = StaticMesh->GetNumLODs();
-				if (NumLODs == 0)
-				{
-					continue;
-				}
-
-				// 记录最大的LOD数量（如果Actor有多个组件，取最大值）
-				if (NumLODs > MaxLODCount)
-				{
-					MaxLODCount = NumLODs;
-				}
-
-				// 只计算LOD0和最后一个LOD
-				// LOD0
-				const FStaticMeshLODResources& LOD0Resources = StaticMesh->GetRenderData()->LODResources[0];
-				int32 LOD0Triangles = 0;
-				for (int32 SectionIndex = 0; SectionIndex < LOD0Resources.Sections.Num(); ++SectionIndex)
-					{
-					const FStaticMeshSection& Section = LOD0Resources.Sections[SectionIndex];
-					LOD0Triangles += Section.NumTriangles;
-					}
-				ActorLOD0Triangles += LOD0Triangles;
-
-				// 最后一个LOD
-				if (NumLODs > 1)
-				{
-					LODNIndex = NumLODs - 1;
-					const FStaticMeshLODResources& LODNResources = StaticMesh->GetRenderData()->LODResources[LODNIndex];
-					int32 LODNTriangles = 0;
-					for (int32 SectionIndex = 0; SectionIndex < LODNResources.Sections.Num(); ++SectionIndex)
-					{
-						const FStaticMeshSection& Section = LODNResources.Sections[SectionIndex];
-						LODNTriangles += Section.NumTriangles;
-					}
-					ActorLODNTriangles += LODNTriangles;
-					}
-				}
+		}
 
-			// 添加LOD信息到LODDetails（只添加LOD0和LOD N）
-			if (ActorLOD0Triangles > 0)
+		for (USkeletalMeshComponent* SkelMeshComp : SkeletalMeshComponents)
+		{
+			USkeletalMesh* SkeletalMesh = SkelMeshComp ? SkelMeshComp->GetSkeletalMeshAsset() : nullptr;
+			if (SkeletalMesh && SkeletalMesh->GetResourceForRendering())
 			{
-				ComplexityInfo.LODDetails.Add(FLODTriangleInfo(0, ActorLOD0Triangles));
-				if (MaxLODCount > 1 && ActorLODNTriangles > 0)
-				{
-					ComplexityInfo.LODDetails.Add(FLODTriangleInfo(MaxLODCount - 1, ActorLODNTriangles));
-				}
+				Snapshot.SkeletalMeshes.Add(SkeletalMesh);
 			}
-			ComplexityInfo.TotalLODCount = MaxLODCount;
 		}
+	}
 
-		// ============ 检查骨骼网格体组件 ============
-		TArray<USkeletalMeshComponent*> SkeletalMeshComponents;
-		Actor->GetComponents<USkeletalMeshComponent>(SkeletalMeshComponents);
+	// 2. 工作线程：按连续分块并行查询网格体统计缓存，累加LOD0和最后一个LOD的三角面数
+	TArray<FHighPolyActorTriangleResult> TriangleResults;
+	TriangleResults.SetNum(Snapshots.Num());
 
-		if (SkeletalMeshComponents.Num() > 0)
+	const int32 NumChunks = FMath::DivideAndRoundUp(Snapshots.Num(), HighPolyScanChunkSize);
+	ParallelFor(NumChunks, [&Snapshots, &TriangleResults](int32 ChunkIndex)
+	{
+		const int32 StartIndex = ChunkIndex * HighPolyScanChunkSize;
+		const int32 EndIndex = FMath::Min(StartIndex + HighPolyScanChunkSize, Snapshots.Num());
+		for (int32 Index = StartIndex; Index < EndIndex; ++Index)
 		{
-			bHasMesh = true;
-			ComplexityInfo.MeshType = EMeshType::SkeletalMesh;
-			ComplexityInfo.ComponentCount = SkeletalMeshComponents.Num();
+			ReduceHighPolyActorTriangles(Snapshots[Index], TriangleResults[Index]);
+		}
+	});
 
-			for (USkeletalMeshComponent* SkelMeshComp : SkeletalMeshComponents)
-			{
-				if (!SkelMeshComp || !SkelMeshComp->GetSkeletalMeshAsset())
-				{
-					continue;
-				}
+	// 3. 游戏线程：组装结果（保持Actor遍历顺序）
+	for (int32 Index = 0; Index < Snapshots.Num(); ++Index)
+	{
+		const FHighPolyActorSnapshot& Snapshot = Snapshots[Index];
+		const FHighPolyActorTriangleResult& TriangleResult = TriangleResults[Index];
 
-				USkeletalMesh* SkeletalMesh = SkelMeshComp->GetSkeletalMeshAsset();
-				FSkeletalMeshRenderData* RenderData = SkeletalMesh->GetResourceForRendering();
-				
-				if (!RenderData)
-				{
-					continue;
-				}
+		// 只统计LOD0有三角面的网格体Actor
+		if (TriangleResult.LOD0Triangles <= 0)
+		{
+			continue;
+		}
 
-				int32 NumLODs = RenderData->LODRenderData.Num();
-				if (NumLODs == 0)
-				{
-					continue;
-				}
+		TotalActorsChecked++;
 
-				// 记录最大的LOD数量（如果Actor有多个组件，取最大值）
-				if (NumLODs > MaxLODCount)
-				{
-					MaxLODCount = NumLODs;
-				}
+		if (TriangleResult.LOD0Triangles < TriangleThreshold)
+		{
+			continue;
+		}
 
-				// 只计算LOD0和最后一个LOD
-				// LOD0
-				const FSkeletalMeshLODRenderData& LOD0Data = RenderData->LODRenderData[0];
-				int32 LOD0Triangles = 0;
-				for (int32 SectionIndex = 0; SectionIndex < LOD0Data.RenderSections.Num(); ++SectionIndex)
-					{
-					const FSkelMeshRenderSection& Section = LOD0Data.RenderSections[SectionIndex];
-					LOD0Triangles += Section.NumTriangles;
-					}
-				ActorLOD0Triangles += LOD0Triangles;
+		AActor* Actor = Snapshot.Actor;
 
-				// 最后一个LOD
-				if (NumLODs > 1)
-				{
-					LODNIndex = NumLODs - 1;
-					const FSkeletalMeshLODRenderData& LODNData = RenderData->LODRenderData[LODNIndex];
-					int32 LODNTriangles = 0;
-					for (int32 SectionIndex = 0; SectionIndex < LODNData.RenderSections.Num(); ++SectionIndex)
-					{
-						const FSkelMeshRenderSection& Section = LODNData.RenderSections[SectionIndex];
-						LODNTriangles += Section.NumTriangles;
-					}
-					ActorLODNTriangles += LODNTriangles;
-					}
-				}
+		FActorMeshComplexityInfo& ComplexityInfo = HighPolyActors.AddDefaulted_GetRef();
+		ComplexityInfo.Actor = Actor;
+		ComplexityInfo.ActorLocation = Actor->GetActorLocation();
+		ComplexityInfo.ActorClass = Actor->GetClass()->GetName();
 
-			// 添加LOD信息到LODDetails（只添加LOD0和LOD N）
-			if (ActorLOD0Triangles > 0)
-			{
-				ComplexityInfo.LODDetails.Add(FLODTriangleInfo(0, ActorLOD0Triangles));
-				if (MaxLODCount > 1 && ActorLODNTriangles > 0)
-				{
-					ComplexityInfo.LODDetails.Add(FLODTriangleInfo(MaxLODCount - 1, ActorLODNTriangles));
-				}
-			}
-			ComplexityInfo.TotalLODCount = MaxLODCount;
-		}
+#if WITH_EDITOR
+		ComplexityInfo.ActorName = Actor->GetActorLabel();
+#else
+		ComplexityInfo.ActorName = Actor->GetName();
+#endif
 
-		// 如果有网格体且LOD0超过阈值
-		if (bHasMesh && ActorLOD0Triangles > 0)
+		// 有骨骼网格体组件时按骨骼网格体统计组件数
+		if (Snapshot.SkeletalMeshComponentCount > 0)
 		{
-			TotalActorsChecked++;
-			ComplexityInfo.LOD0TriangleCount = ActorLOD0Triangles;
-			// 不再计算总面数，TotalTriangleCount设为0或LOD0的值
-			ComplexityInfo.TotalTriangleCount = 0;
+			ComplexityInfo.MeshType = EMeshType::SkeletalMesh;
+			ComplexityInfo.ComponentCount = Snapshot.SkeletalMeshComponentCount;
+		}
+		else
+		{
+			ComplexityInfo.MeshType = EMeshType::StaticMesh;
+			ComplexityInfo.ComponentCount = Snapshot.StaticMeshComponentCount;
+		}
 
-			if (ActorLOD0Triangles >= TriangleThreshold)
-			{
-				HighPolyActors.Add(ComplexityInfo);
-				HighPolyActorsCount++;
-			}
+		// 添加LOD信息到LODDetails（只添加LOD0和LOD N）
+		ComplexityInfo.LODDetails.Add(FLODTriangleInfo(0, TriangleResult.LOD0Triangles));
+		if (TriangleResult.MaxLODCount > 1 && TriangleResult.LODNTriangles > 0)
+		{
+			ComplexityInfo.LODDetails.Add(FLODTriangleInfo(TriangleResult.MaxLODCount - 1, TriangleResult.LODNTriangles));
 		}
+		ComplexityInfo.TotalLODCount = TriangleResult.MaxLODCount;
+		ComplexityInfo.LOD0TriangleCount = TriangleResult.LOD0Triangles;
+		// 不再计算总面数，TotalTriangleCount设为0
+		ComplexityInfo.TotalTriangleCount = 0;
+
+		HighPolyActorsCount++;
 	}
 
 	// 按照LOD0三角形数量从高到低排序
@@ -1496,10 +1776,10 @@ TArray<FActorMaterialSlotInfo> UEditorToolsBPFLibrary::GetActorsMaterialSlotsInS
 	int32 TotalActorsChecked = 0;
 	int32 ActorsWithMaterialSlotsCount = 0;
 
-	// 遍历世界中的所有Actor
-	for (TActorIterator<AActor> It(World); It; ++It)
+	// 遍历场景索引中的Actor（只包含带网格体或灯光组件的Actor）
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
 	{
-		AActor* Actor = *It;
+		AActor* Actor = Entry.Actor.Get();
 		if (!Actor)
 		{
 			continue;
@@ -1520,8 +1800,8 @@ TArray<FActorMaterialSlotInfo> UEditorToolsBPFLibrary::GetActorsMaterialSlotsInS
 		bool bHasMesh = false;
 
 		// ============ 检查静态网格体组件 ============
-		TArray<UStaticMeshComponent*> StaticMeshComponents;
-		Actor->GetComponents<UStaticMeshComponent>(StaticMeshComponents);
+		TArray<UStaticMeshComponent*, TInlineAllocator<8>> StaticMeshComponents;
+		ResolveSceneIndexComponents(Entry.StaticMeshComponents, StaticMeshComponents);
 
 		if (StaticMeshComponents.Num() > 0)
 		{
@@ -1552,8 +1832,8 @@ TArray<FActorMaterialSlotInfo> UEditorToolsBPFLibrary::GetActorsMaterialSlotsInS
 		}
 
 		// ============ 检查骨骼网格体组件 ============
-		TArray<USkeletalMeshComponent*> SkeletalMeshComponents;
-		Actor->GetComponents<USkeletalMeshComponent>(SkeletalMeshComponents);
+		TArray<USkeletalMeshComponent*, TInlineAllocator<4>> SkeletalMeshComponents;
+		ResolveSceneIndexComponents(Entry.SkeletalMeshComponents, SkeletalMeshComponents);
 
 		if (SkeletalMeshComponents.Num() > 0)
 		{
@@ -1728,18 +2008,18 @@ FSceneLightStatistics UEditorToolsBPFLibrary::GetSceneLightStatistics(UObject* W
 		return Statistics;
 	}
 
-	// 遍历场景中所有的 Actor，查找灯光组件
-	for (TActorIterator<AActor> It(World); It; ++It)
+	// 遍历场景索引中的 Actor，查找灯光组件
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
 	{
-		AActor* Actor = *It;
-		if (!Actor)
+		AActor* Actor = Entry.Actor.Get();
+		if (!Actor || Entry.LightComponents.Num() == 0)
 		{
 			continue;
 		}
 
 		// 获取 Actor 上的所有灯光组件
-		TArray<ULightComponent*> LightComponents;
-		Actor->GetComponents<ULightComponent>(LightComponents);
+		TArray<ULightComponent*, TInlineAllocator<4>> LightComponents;
+		ResolveSceneIndexComponents(Entry.LightComponents, LightComponents);
 
 		for (ULightComponent* LightComponent : LightComponents)
 		{
@@ -1963,386 +2243,85 @@ FSceneLightStatistics UEditorToolsBPFLibrary::GetSceneLightStatistics(UObject* W
 
 // ==================== 未使用资源检查功能 ====================
 
-namespace
+TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedMeshesInFolder(const TArray<FString>& FolderPaths)
 {
-	// 转换UE返回的路径格式为标准格式
-	// 例如: "/All/Game/crates/MoonbackEchoes/S07" -> "/Game/crates/MoonbackEchoes/S07"
-	FString NormalizeFolderPath(const FString& FolderPath)
-	{
-		FString NormalizedPath = FolderPath;
-		
-		// 移除首尾空白
-		NormalizedPath.TrimStartAndEndInline();
-		
-		// 移除开头的引号（如果有）
-		if (NormalizedPath.StartsWith(TEXT("\"")))
-		{
-			NormalizedPath = NormalizedPath.Mid(1);
-		}
-		// 移除结尾的引号（如果有）
-		if (NormalizedPath.EndsWith(TEXT("\"")))
-		{
-			NormalizedPath = NormalizedPath.Left(NormalizedPath.Len() - 1);
-		}
-		
-		// 转换 /All/Game/ 为 /Game/
-		if (NormalizedPath.StartsWith(TEXT("/All/Game/")))
-		{
-			NormalizedPath = TEXT("/Game/") + NormalizedPath.Mid(10); // 10 = "/All/Game/".Len()
-		}
-		// 转换 /All/ 为 /Game/（如果路径不包含Game）
-		else if (NormalizedPath.StartsWith(TEXT("/All/")))
-		{
-			NormalizedPath = TEXT("/Game/") + NormalizedPath.Mid(5); // 5 = "/All/".Len()
-		}
-		// 如果路径以 /Game/ 开头，保持不变
-		else if (!NormalizedPath.StartsWith(TEXT("/Game/")))
-		{
-			// 如果路径不以 /Game/ 开头，尝试添加
-			if (NormalizedPath.StartsWith(TEXT("/")))
-			{
-				NormalizedPath = TEXT("/Game") + NormalizedPath;
-			}
-			else
-			{
-				NormalizedPath = TEXT("/Game/") + NormalizedPath;
-			}
-		}
-		
-		// 确保路径以 / 结尾（用于搜索）
-		if (!NormalizedPath.EndsWith(TEXT("/")))
-		{
-			NormalizedPath += TEXT("/");
-		}
-		
-		return NormalizedPath;
-	}
+	return FUnusedAssetScanner::FindUnusedAssets(EUnusedAssetCategory::Mesh, FolderPaths);
 }
 
-TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedMeshesInFolder(const TArray<FString>& FolderPaths)
+TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedMaterialsInFolder(const TArray<FString>& FolderPaths)
+{
+	return FUnusedAssetScanner::FindUnusedAssets(EUnusedAssetCategory::Material, FolderPaths);
+}
+
+TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedTexturesInFolder(const TArray<FString>& FolderPaths)
+{
+	return FUnusedAssetScanner::FindUnusedAssets(EUnusedAssetCategory::Texture, FolderPaths);
+}
+
+TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedAssetsInFolders(const TArray<FString>& FolderPaths)
+{
+	const EUnusedAssetCategory AllCategories[] = { EUnusedAssetCategory::Mesh, EUnusedAssetCategory::Material, EUnusedAssetCategory::Texture };
+	return FUnusedAssetScanner::FindUnusedAssets(AllCategories, FolderPaths);
+}
+
+TArray<AStaticMeshActor*> UEditorToolsBPFLibrary::GetAllStaticMeshActorsInScene(UObject* WorldContextObject)
 {
-	TArray<FUnusedAssetInfo> UnusedAssets;
+	TArray<AStaticMeshActor*> Result;
 
 #if WITH_EDITOR
-	TArray<FString> EffectiveFolderPaths = FolderPaths;
+	struct FStaticMeshCollisionInfo
+	{
+		TWeakObjectPtr<AStaticMeshActor> Actor;
+		FString ActorLabel;
+		FName CollisionProfileName = NAME_None;
+		bool bGenerateOverlapEvents = false;
+	};
 
-	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
-	if (EffectiveFolderPaths.Num() == 0)
+	UWorld* World = nullptr;
+	if (WorldContextObject)
 	{
-		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
+		World = WorldContextObject->GetWorld();
 	}
 
-	if (EffectiveFolderPaths.Num() == 0)
+	if (!World && GEditor)
 	{
-		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
-			LOCTEXT("MeshesFolderPathEmpty", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查未使用的模型”。")
-		);
-		return UnusedAssets;
+		World = GEditor->GetEditorWorldContext().World();
 	}
 
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	// 收集所有文件夹内的资源
-	TArray<FAssetData> AllMeshAssets;
-	FTopLevelAssetPath StaticMeshClassPath = UStaticMesh::StaticClass()->GetClassPathName();
-	FTopLevelAssetPath SkeletalMeshClassPath = USkeletalMesh::StaticClass()->GetClassPathName();
-
-	for (const FString& FolderPath : EffectiveFolderPaths)
+	if (!World)
 	{
-		// 转换并确保路径格式正确
-		FString SearchPath = NormalizeFolderPath(FolderPath);
-
-		// 获取文件夹内的所有资源
-		TArray<FAssetData> AllAssets;
-		AssetRegistry.GetAssetsByPath(FName(*SearchPath), AllAssets, true);
-
-		// 过滤出静态网格体和骨骼网格体
-		for (const FAssetData& AssetData : AllAssets)
-			{
-			if (AssetData.AssetClassPath == StaticMeshClassPath || AssetData.AssetClassPath == SkeletalMeshClassPath)
-			{
-				AllMeshAssets.Add(AssetData);
-			}
-		}
+		return Result;
 	}
 
-	// 输出消息统一由消息日志承担
-
-	// 检查每个资源是否被引用
-	for (const FAssetData& AssetData : AllMeshAssets)
+	TArray<FStaticMeshCollisionInfo> CollisionEnabledActors;
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
 	{
-		FName PackageName = AssetData.PackageName;
-		TArray<FName> Referencers;
-		AssetRegistry.GetReferencers(PackageName, Referencers);
-
-		// 过滤掉引擎内置引用（同一文件夹内的引用也算作使用）
-		bool bIsUsed = false;
-		for (const FName& ReferencerPackageName : Referencers)
+		AStaticMeshActor* Actor = Cast<AStaticMeshActor>(Entry.Actor.Get());
+		if (!IsValid(Actor))
 		{
-			FString ReferencerPath = ReferencerPackageName.ToString();
-			// 只要是被项目内资源引用就算使用（包括同一文件夹内的引用）
-			if (ReferencerPath.StartsWith(TEXT("/Game/")))
-			{
-				bIsUsed = true;
-				break;
-			}
+			continue;
 		}
 
-		if (!bIsUsed)
+		UStaticMeshComponent* MeshComp = Actor->GetStaticMeshComponent();
+		if (!IsValid(MeshComp))
 		{
-			FUnusedAssetInfo Info;
-			Info.AssetPath = AssetData.PackagePath.ToString();
-			Info.AssetName = AssetData.AssetName.ToString();
-			Info.AssetType = AssetData.AssetClassPath.GetAssetName().ToString();
-			Info.AssetObject = AssetData.GetAsset();
-
-			UnusedAssets.Add(Info);
+			continue;
 		}
-	}
 
-	// 显示可点击的消息日志
-	FEditorToolsMessageLog::ShowUnusedAssetsReport(TEXT("模型"), EffectiveFolderPaths, UnusedAssets, AllMeshAssets.Num());
-#endif
+		const ECollisionEnabled::Type CollisionEnabled = MeshComp->GetCollisionEnabled();
+		const bool bHasCollision = CollisionEnabled != ECollisionEnabled::NoCollision;
 
-	return UnusedAssets;
-}
+		Result.Add(Actor);
 
-TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedMaterialsInFolder(const TArray<FString>& FolderPaths)
-{
-	TArray<FUnusedAssetInfo> UnusedAssets;
-
-#if WITH_EDITOR
-	TArray<FString> EffectiveFolderPaths = FolderPaths;
-
-	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
-	if (EffectiveFolderPaths.Num() == 0)
-	{
-		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
-	}
-
-	if (EffectiveFolderPaths.Num() == 0)
-	{
-		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
-			LOCTEXT("MaterialsFolderPathEmpty", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查未使用的材质”。")
-		);
-		return UnusedAssets;
-	}
-
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	// 收集所有文件夹内的材质
-	TArray<FAssetData> FilteredMaterials;
-	for (const FString& FolderPath : EffectiveFolderPaths)
-	{
-		// 转换并确保路径格式正确
-		FString SearchPath = NormalizeFolderPath(FolderPath);
-
-		// 获取文件夹内的所有材质
-		TArray<FAssetData> MaterialAssets;
-		AssetRegistry.GetAssetsByPath(FName(*SearchPath), MaterialAssets, true);
-		
-		// 过滤出材质资源
-		for (const FAssetData& AssetData : MaterialAssets)
-		{
-			FString ClassName = AssetData.AssetClassPath.GetAssetName().ToString();
-			if (ClassName.Contains(TEXT("Material")) && AssetData.PackagePath.ToString().StartsWith(SearchPath))
-			{
-				FilteredMaterials.Add(AssetData);
-			}
-		}
-	}
-
-	// 输出消息统一由消息日志承担
-
-	// 检查每个资源是否被引用
-	for (const FAssetData& AssetData : FilteredMaterials)
-	{
-		FName PackageName = AssetData.PackageName;
-		TArray<FName> Referencers;
-		AssetRegistry.GetReferencers(PackageName, Referencers);
-
-		// 过滤掉引擎内置引用（同一文件夹内的引用也算作使用）
-		bool bIsUsed = false;
-		for (const FName& ReferencerPackageName : Referencers)
-		{
-			FString ReferencerPath = ReferencerPackageName.ToString();
-			// 只要是被项目内资源引用就算使用（包括同一文件夹内的引用）
-			if (ReferencerPath.StartsWith(TEXT("/Game/")))
-			{
-				bIsUsed = true;
-				break;
-			}
-		}
-
-		if (!bIsUsed)
-		{
-			FUnusedAssetInfo Info;
-			Info.AssetPath = AssetData.PackagePath.ToString();
-			Info.AssetName = AssetData.AssetName.ToString();
-			Info.AssetType = AssetData.AssetClassPath.GetAssetName().ToString();
-			Info.AssetObject = AssetData.GetAsset();
-
-			UnusedAssets.Add(Info);
-		}
-	}
-
-	// 显示可点击的消息日志
-	FEditorToolsMessageLog::ShowUnusedAssetsReport(TEXT("材质"), EffectiveFolderPaths, UnusedAssets, FilteredMaterials.Num());
-#endif
-
-	return UnusedAssets;
-}
-
-TArray<FUnusedAssetInfo> UEditorToolsBPFLibrary::FindUnusedTexturesInFolder(const TArray<FString>& FolderPaths)
-{
-	TArray<FUnusedAssetInfo> UnusedAssets;
-
-#if WITH_EDITOR
-	TArray<FString> EffectiveFolderPaths = FolderPaths;
-
-	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
-	if (EffectiveFolderPaths.Num() == 0)
-	{
-		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
-	}
-
-	if (EffectiveFolderPaths.Num() == 0)
-	{
-		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
-			LOCTEXT("TexturesFolderPathEmpty", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查未使用的贴图”。")
-		);
-		return UnusedAssets;
-	}
-
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	// 收集所有文件夹内的贴图
-	TArray<FAssetData> FilteredTextures;
-	for (const FString& FolderPath : EffectiveFolderPaths)
-	{
-		// 转换并确保路径格式正确
-		FString SearchPath = NormalizeFolderPath(FolderPath);
-
-		// 获取文件夹内的所有贴图
-		TArray<FAssetData> TextureAssets;
-		AssetRegistry.GetAssetsByPath(FName(*SearchPath), TextureAssets, true);
-		
-		// 过滤出贴图资源
-		for (const FAssetData& AssetData : TextureAssets)
-		{
-			FString ClassName = AssetData.AssetClassPath.GetAssetName().ToString();
-			if (ClassName.Contains(TEXT("Texture")) && AssetData.PackagePath.ToString().StartsWith(SearchPath))
-			{
-				FilteredTextures.Add(AssetData);
-			}
-		}
-	}
-
-	// 输出消息统一由消息日志承担
-
-	// 检查每个资源是否被引用
-	for (const FAssetData& AssetData : FilteredTextures)
-	{
-		FName PackageName = AssetData.PackageName;
-		TArray<FName> Referencers;
-		AssetRegistry.GetReferencers(PackageName, Referencers);
-
-		// 过滤掉引擎内置引用（同一文件夹内的引用也算作使用）
-		bool bIsUsed = false;
-		for (const FName& ReferencerPackageName : Referencers)
-		{
-			FString ReferencerPath = ReferencerPackageName.ToString();
-			// 只要是被项目内资源引用就算使用（包括同一文件夹内的引用）
-			if (ReferencerPath.StartsWith(TEXT("/Game/")))
-			{
-				bIsUsed = true;
-				break;
-			}
-		}
-
-		if (!bIsUsed)
-		{
-			FUnusedAssetInfo Info;
-			Info.AssetPath = AssetData.PackagePath.ToString();
-			Info.AssetName = AssetData.AssetName.ToString();
-			Info.AssetType = AssetData.AssetClassPath.GetAssetName().ToString();
-			Info.AssetObject = AssetData.GetAsset();
-
-			UnusedAssets.Add(Info);
-		}
-	}
-
-	// 显示可点击的消息日志
-	FEditorToolsMessageLog::ShowUnusedAssetsReport(TEXT("贴图"), EffectiveFolderPaths, UnusedAssets, FilteredTextures.Num());
-#endif
-
-	return UnusedAssets;
-}
-
-TArray<AStaticMeshActor*> UEditorToolsBPFLibrary::GetAllStaticMeshActorsInScene(UObject* WorldContextObject)
-{
-	TArray<AStaticMeshActor*> Result;
-
-#if WITH_EDITOR
-	struct FStaticMeshCollisionInfo
-	{
-		TWeakObjectPtr<AStaticMeshActor> Actor;
-		FString ActorLabel;
-		FName CollisionProfileName = NAME_None;
-		bool bGenerateOverlapEvents = false;
-	};
-
-	UWorld* World = nullptr;
-	if (WorldContextObject)
-	{
-		World = WorldContextObject->GetWorld();
-	}
-
-	if (!World && GEditor)
-	{
-		World = GEditor->GetEditorWorldContext().World();
-	}
-
-	if (!World)
-	{
-		return Result;
-	}
-
-	TArray<FStaticMeshCollisionInfo> CollisionEnabledActors;
-	for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
-	{
-		AStaticMeshActor* Actor = *It;
-		if (!IsValid(Actor))
-		{
-			continue;
-		}
-
-		UStaticMeshComponent* MeshComp = Actor->GetStaticMeshComponent();
-		if (!IsValid(MeshComp))
-		{
-			continue;
-		}
-
-		const ECollisionEnabled::Type CollisionEnabled = MeshComp->GetCollisionEnabled();
-		const bool bHasCollision = CollisionEnabled != ECollisionEnabled::NoCollision;
-
-		Result.Add(Actor);
-
-		if (bHasCollision)
-		{
-			FStaticMeshCollisionInfo& Info = CollisionEnabledActors.AddDefaulted_GetRef();
-			Info.Actor = Actor;
-			Info.ActorLabel = Actor->GetActorLabel();
-			Info.CollisionProfileName = MeshComp->GetCollisionProfileName();
-			Info.bGenerateOverlapEvents = MeshComp->GetGenerateOverlapEvents();
-		}
-	}
+		if (bHasCollision)
+		{
+			FStaticMeshCollisionInfo& Info = CollisionEnabledActors.AddDefaulted_GetRef();
+			Info.Actor = Actor;
+			Info.ActorLabel = Actor->GetActorLabel();
+			Info.CollisionProfileName = MeshComp->GetCollisionProfileName();
+			Info.bGenerateOverlapEvents = MeshComp->GetGenerateOverlapEvents();
+		}
+	}
 
 	TSharedPtr<IMessageLogListing> MessageLogListing = UEditorToolsUtilities::GetOrCreateMessageLogListing(true);
 
@@ -2552,9 +2531,9 @@ TArray<AStaticMeshActor*> UEditorToolsBPFLibrary::GetAllStaticMeshActorsWithShad
 	}
 
 	TArray<FStaticMeshShadowInfo> ShadowCastingActors;
-	for (TActorIterator<AStaticMeshActor> It(World); It; ++It)
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
 	{
-		AStaticMeshActor* Actor = *It;
+		AStaticMeshActor* Actor = Cast<AStaticMeshActor>(Entry.Actor.Get());
 		if (!IsValid(Actor))
 		{
 			continue;
@@ -2742,6 +2721,76 @@ TArray<AStaticMeshActor*> UEditorToolsBPFLibrary::GetAllStaticMeshActorsWithShad
 	return Result;
 }
 
+#if WITH_EDITOR
+namespace
+{
+	static bool MatchesActorFilter(AStaticMeshActor* Actor, const UStaticMeshComponent* MeshComp, const FEditorToolsActorFilter& Filter)
+	{
+		if (Filter.ActorClass && !Actor->IsA(Filter.ActorClass))
+		{
+			return false;
+		}
+
+		if (Filter.StaticMesh && MeshComp->GetStaticMesh() != Filter.StaticMesh)
+		{
+			return false;
+		}
+
+		const FVector ActorLocation = Actor->GetActorLocation();
+		if (Filter.bUseDistance && FVector::DistSquared(ActorLocation, Filter.DistanceOrigin) > FMath::Square(Filter.MaxDistance))
+		{
+			return false;
+		}
+
+		if (Filter.bUseBounds && !Filter.Bounds.IsInsideOrOn(ActorLocation))
+		{
+			return false;
+		}
+
+		if (Filter.bSelectedOnly && !Actor->IsSelected())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	// 从场景索引中筛选静态网格体Actor，返回匹配的Actor总数
+	static int32 GatherFilteredStaticMeshActors(UObject* WorldContextObject, const FEditorToolsActorFilter& Filter, TFunctionRef<bool(const UStaticMeshComponent*)> NeedsUpdate, TArray<TWeakObjectPtr<AStaticMeshActor>>& OutActors)
+	{
+		UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+		if (!World && GEditor)
+		{
+			World = GEditor->GetEditorWorldContext().World();
+		}
+
+		if (!World)
+		{
+			return 0;
+		}
+
+		int32 MatchedActors = 0;
+		for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
+		{
+			AStaticMeshActor* Actor = Cast<AStaticMeshActor>(Entry.Actor.Get());
+			UStaticMeshComponent* MeshComp = IsValid(Actor) ? Actor->GetStaticMeshComponent() : nullptr;
+			if (!MeshComp || !MatchesActorFilter(Actor, MeshComp, Filter))
+			{
+				continue;
+			}
+
+			MatchedActors++;
+			if (NeedsUpdate(MeshComp))
+			{
+				OutActors.Add(Actor);
+			}
+		}
+
+		return MatchedActors;
+	}
+}
+#endif
+
 void UEditorToolsBPFLibrary::DisableCollisionForSelectedStaticMeshActors()
 {
 	
@@ -2878,70 +2927,188 @@ void UEditorToolsBPFLibrary::DisableShadowCastingForSelectedStaticMeshActors()
 #endif
 }
 
-TArray<FTextureSizeInfo> UEditorToolsBPFLibrary::CheckTextureSizesInFolders(const TArray<FString>& FolderPaths)
-		{
-	TArray<FTextureSizeInfo> TextureSizeInfos;
-
+void UEditorToolsBPFLibrary::DisableCollisionForFilteredStaticMeshActors(UObject* WorldContextObject, const FEditorToolsActorFilter& Filter)
+{
 #if WITH_EDITOR
-	TArray<FString> EffectiveFolderPaths = FolderPaths;
+	TArray<TWeakObjectPtr<AStaticMeshActor>> ActorsToUpdate;
+	const int32 MatchedActors = GatherFilteredStaticMeshActors(WorldContextObject, Filter,
+		[](const UStaticMeshComponent* MeshComp) { return MeshComp->GetCollisionEnabled() != ECollisionEnabled::NoCollision; },
+		ActorsToUpdate);
 
-	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
-	if (EffectiveFolderPaths.Num() == 0)
+	if (MatchedActors == 0)
 	{
-		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("DisableCollisionFilterNoMatch", "没有符合筛选条件的静态网格体Actor。")
+		);
+		return;
 	}
 
-	if (EffectiveFolderPaths.Num() == 0)
+	TArray<FDisableCollisionActorRecord> DisabledRecords;
+	if (!DisableCollisionForActors(ActorsToUpdate, DisabledRecords))
 	{
 		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
-			LOCTEXT("TextureSizeNoFolder", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查贴图大小”。")
+			LOCTEXT("DisableCollisionFilterNoCollisionActors", "符合筛选条件的静态网格体碰撞已经处于关闭状态。")
 		);
-		return TextureSizeInfos;
+		return;
 	}
 
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-
-	// 收集所有文件夹内的贴图资源
-	TArray<FAssetData> AllTextureAssets;
-	for (const FString& FolderPath : EffectiveFolderPaths)
-	{
-		FString SearchPath = NormalizeFolderPath(FolderPath);
-		TArray<FAssetData> TextureAssets;
-		AssetRegistry.GetAssetsByPath(FName(*SearchPath), TextureAssets, true);
+	TSharedPtr<IMessageLogListing> MessageLogListing = UEditorToolsUtilities::GetOrCreateMessageLogListing(true);
+	FCollisionMessageLogger::LogDisableCollisionMessages(MessageLogListing, DisabledRecords, MatchedActors, true);
+#else
+	UE_LOG(LogTemp, Warning, TEXT("DisableCollisionForFilteredStaticMeshActors can only be used in the editor."));
+#endif
+}
 
-		// 过滤出贴图资源
-		for (const FAssetData& AssetData : TextureAssets)
-		{
-			FString ClassName = AssetData.AssetClassPath.GetAssetName().ToString();
-			if (ClassName.Contains(TEXT("Texture")) && AssetData.PackagePath.ToString().StartsWith(SearchPath))
-			{
-				AllTextureAssets.Add(AssetData);
-			}
-		}
-	}
+void UEditorToolsBPFLibrary::DisableShadowCastingForFilteredStaticMeshActors(UObject* WorldContextObject, const FEditorToolsActorFilter& Filter)
+{
+#if WITH_EDITOR
+	TArray<TWeakObjectPtr<AStaticMeshActor>> ActorsToUpdate;
+	const int32 MatchedActors = GatherFilteredStaticMeshActors(WorldContextObject, Filter,
+		[](const UStaticMeshComponent* MeshComp) { return MeshComp->CastShadow; },
+		ActorsToUpdate);
 
-	// 获取每个贴图的分辨率信息
-	for (const FAssetData& AssetData : AllTextureAssets)
+	if (MatchedActors == 0)
 	{
-		UTexture2D* Texture = Cast<UTexture2D>(AssetData.GetAsset());
-		if (Texture)
-		{
-			FTextureSizeInfo Info;
-			Info.TexturePath = AssetData.PackagePath.ToString();
-			Info.TextureName = AssetData.AssetName.ToString();
-			Info.Width = Texture->GetSizeX();
-			Info.Height = Texture->GetSizeY();
-			Info.MaxSize = FMath::Max(Info.Width, Info.Height);
-			Info.TextureObject = Texture;
-
-			TextureSizeInfos.Add(Info);
-		}
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("DisableShadowFilterNoMatch", "没有符合筛选条件的静态网格体Actor。")
+		);
+		return;
 	}
 
-	// 按最大尺寸从大到小排序
-	TextureSizeInfos.Sort([](const FTextureSizeInfo& A, const FTextureSizeInfo& B)
+	TArray<FDisableShadowActorRecord> DisabledRecords;
+	if (!DisableShadowCastingForActors(ActorsToUpdate, DisabledRecords))
+	{
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("DisableShadowFilterNoShadowActors", "符合筛选条件的静态网格体阴影已经处于关闭状态。")
+		);
+		return;
+	}
+
+	TSharedPtr<IMessageLogListing> MessageLogListing = UEditorToolsUtilities::GetOrCreateMessageLogListing(true);
+	FShadowMessageLogger::LogDisableShadowMessages(MessageLogListing, DisabledRecords, MatchedActors, true);
+#else
+	UE_LOG(LogTemp, Warning, TEXT("DisableShadowCastingForFilteredStaticMeshActors can only be used in the editor."));
+#endif
+}
+
+namespace
+{
+	// 解析 "2048x1024" 格式的尺寸字符串
+	static bool ParseTextureDimensionsTag(const FString& TagValue, int32& OutWidth, int32& OutHeight)
+	{
+		FString WidthText;
+		FString HeightText;
+		if (!TagValue.Split(TEXT("x"), &WidthText, &HeightText))
+		{
+			return false;
+		}
+
+		return LexTryParseString(OutWidth, *WidthText.TrimStartAndEnd())
+			&& LexTryParseString(OutHeight, *HeightText.TrimStartAndEnd())
+			&& OutWidth > 0
+			&& OutHeight > 0;
+	}
+
+	// 从资产注册表标签读取贴图尺寸：优先 Dimensions（平台数据尺寸），其次 ImportedSize（源图尺寸）
+	static bool TryGetTextureSizeFromTags(const FAssetData& AssetData, int32& OutWidth, int32& OutHeight)
+	{
+		static const FName DimensionsTag(TEXT("Dimensions"));
+		static const FName ImportedSizeTag(TEXT("ImportedSize"));
+
+		FString TagValue;
+		if (AssetData.GetTagValue(DimensionsTag, TagValue) && ParseTextureDimensionsTag(TagValue, OutWidth, OutHeight))
+		{
+			return true;
+		}
+
+		return AssetData.GetTagValue(ImportedSizeTag, TagValue) && ParseTextureDimensionsTag(TagValue, OutWidth, OutHeight);
+	}
+}
+
+TArray<FTextureSizeInfo> UEditorToolsBPFLibrary::CheckTextureSizesInFolders(const TArray<FString>& FolderPaths)
+		{
+	TArray<FTextureSizeInfo> TextureSizeInfos;
+
+#if WITH_EDITOR
+	TArray<FString> EffectiveFolderPaths = FolderPaths;
+
+	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
+	}
+
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("TextureSizeNoFolder", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查贴图大小”。")
+		);
+		return TextureSizeInfos;
+	}
+
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+
+	// 收集所有文件夹内的贴图资源
+	TArray<FAssetData> AllTextureAssets;
+	for (const FString& FolderPath : EffectiveFolderPaths)
+	{
+		// 注册表中的包路径不带结尾的 /，递归查询已经限定在该文件夹内
+		FString SearchPath = UEditorToolsUtilities::NormalizeFolderPath(FolderPath);
+		SearchPath.RemoveFromEnd(TEXT("/"));
+		TArray<FAssetData> TextureAssets;
+		AssetRegistry.GetAssetsByPath(FName(*SearchPath), TextureAssets, true);
+
+		// 过滤出2D贴图资源（只比较类信息，不加载资源）
+		for (const FAssetData& AssetData : TextureAssets)
+		{
+			if (AssetData.IsInstanceOf(UTexture2D::StaticClass()))
+			{
+				AllTextureAssets.Add(AssetData);
+			}
+		}
+	}
+
+	// 获取每个贴图的分辨率信息：优先读取注册表标签，只有标签缺失时才加载贴图
+	int32 LoadedFallbackCount = 0;
+	for (const FAssetData& AssetData : AllTextureAssets)
+	{
+		FTextureSizeInfo Info;
+		Info.TexturePath = AssetData.PackagePath.ToString();
+		Info.TextureName = AssetData.AssetName.ToString();
+		Info.TextureSoftPath = AssetData.GetSoftObjectPath();
+		Info.TextureObject = Cast<UTexture2D>(AssetData.FastGetAsset(false));
+
+		if (!TryGetTextureSizeFromTags(AssetData, Info.Width, Info.Height))
+		{
+			// 旧版本保存的资源可能没有尺寸标签
+			if (!Info.TextureObject)
+			{
+				Info.TextureObject = Cast<UTexture2D>(AssetData.GetAsset());
+				LoadedFallbackCount++;
+			}
+
+			if (!Info.TextureObject)
+			{
+				continue;
+			}
+
+			Info.Width = Info.TextureObject->GetSizeX();
+			Info.Height = Info.TextureObject->GetSizeY();
+		}
+
+		Info.MaxSize = FMath::Max(Info.Width, Info.Height);
+		TextureSizeInfos.Add(Info);
+	}
+
+	if (LoadedFallbackCount > 0)
+	{
+		UE_LOG(LogTemp, Log, TEXT("CheckTextureSizesInFolders: %d 个贴图缺少尺寸标签，已回退为加载读取"), LoadedFallbackCount);
+	}
+
+	// 按最大尺寸从大到小排序
+	TextureSizeInfos.Sort([](const FTextureSizeInfo& A, const FTextureSizeInfo& B)
 	{
 		return A.MaxSize > B.MaxSize;
 	});
@@ -3048,15 +3215,14 @@ TArray<FTextureSizeInfo> UEditorToolsBPFLibrary::CheckTextureSizesInFolders(cons
 			const FString DisplayName = EditorTools::BuildFixedDisplayName(Info.TextureName);
 			const FText DisplayText = FText::FromString(DisplayName);
 
+			Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
 			if (Info.TextureObject)
 			{
-				Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
 				Message->AddToken(FAssetObjectToken::Create(Info.TextureObject, DisplayText));
-		}
+			}
 			else
 			{
-				Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
-				Message->AddToken(FTextToken::Create(DisplayText));
+				Message->AddToken(FAssetObjectToken::Create(Info.TextureSoftPath, DisplayText));
 			}
 
 			// 添加分辨率信息（用[]框起来）
@@ -3088,7 +3254,7 @@ TArray<FTextureSizeInfo> UEditorToolsBPFLibrary::CheckTextureSizesInFolders(cons
 	return TextureSizeInfos;
 }
 
-TArray<FActorDrawCallInfo> UEditorToolsBPFLibrary::GetVisibleActorsDrawCallStats(UObject* WorldContextObject)
+TArray<FActorDrawCallInfo> UEditorToolsBPFLibrary::GetVisibleActorsDrawCallStats(UObject* WorldContextObject, EDrawCallStatsMode Mode)
 {
 	TArray<FActorDrawCallInfo> Results;
 
@@ -3153,104 +3319,16 @@ TArray<FActorDrawCallInfo> UEditorToolsBPFLibrary::GetVisibleActorsDrawCallStats
 
 	Results.Reserve(VisibleActors.Num());
 
-	// 3. 准备环境：关闭遮挡剔除
-	static const auto CVarAllowOcclusionCulling = IConsoleManager::Get().FindConsoleVariable(TEXT("r.AllowOcclusionCulling"));
-	const int32 OldAllowOcclusionCulling = CVarAllowOcclusionCulling ? CVarAllowOcclusionCulling->GetInt() : 1;
-
-	if (CVarAllowOcclusionCulling)
+	// 3. 统计每个Actor的DrawCall
+	if (Mode == EDrawCallStatsMode::Ablation)
 	{
-		CVarAllowOcclusionCulling->Set(0, ECVF_SetByCode);
+		GatherDrawCallsByAblation(VisibleActors, Results);
 	}
-
-	// 强制重绘
-	if (GEditor) GEditor->RedrawAllViewports();
-	FlushRenderingCommands();
-
-	// 4. 逐个分析Actor (Hybrid: Ablation + Estimation)
-	FScopedSlowTask SlowTask(VisibleActors.Num(), LOCTEXT("CalculatingDrawCalls", "正在计算Actor Draw Calls... (这可能需要一些时间)"));
-	SlowTask.MakeDialog();
-
-	for (AActor* Actor : VisibleActors)
-	{
-		SlowTask.EnterProgressFrame(1.f, FText::FromString(FString::Printf(TEXT("分析: %s"), *Actor->GetActorLabel())));
-
-		if (!IsValid(Actor)) continue;
-
-		// --- 估算部分 (Estimation) ---
-		// 统计组件和材质槽作为保底值
-		int32 ActiveComponentCount = 0;
-		int32 TotalMaterialSlots = 0;
-		TInlineComponentArray<UPrimitiveComponent*> PrimitiveComponents(Actor);
-		for (UPrimitiveComponent* PrimComp : PrimitiveComponents)
-		{
-			if (PrimComp && PrimComp->IsRegistered() && PrimComp->IsVisible() && !PrimComp->bHiddenInGame)
-			{
-				ActiveComponentCount++;
-				TotalMaterialSlots += PrimComp->GetNumMaterials();
-			}
-		}
-
-		// --- 测量部分 (Ablation) ---
-		int32 AblationDrawCalls = 0;
-		
-		// 步骤 A: 测量 "可见" 状态
-		bool bOriginalHidden = Actor->IsHidden();
-		Actor->SetActorHiddenInGame(false);
-		Actor->SetIsTemporarilyHiddenInEditor(false);
-
-		if (GEditor) GEditor->RedrawAllViewports();
-		FlushRenderingCommands();
-		const uint32 VisibleDrawCalls = *GNumDrawCallsRHI;
-
-		// 步骤 B: 测量 "隐藏" 状态
-		Actor->SetActorHiddenInGame(true);
-		Actor->SetIsTemporarilyHiddenInEditor(true);
-
-		if (GEditor) GEditor->RedrawAllViewports();
-		FlushRenderingCommands();
-		const uint32 HiddenDrawCalls = *GNumDrawCallsRHI;
-
-		// 步骤 C: 恢复状态
-		Actor->SetActorHiddenInGame(bOriginalHidden);
-		Actor->SetIsTemporarilyHiddenInEditor(false);
-
-		AblationDrawCalls = (int32)VisibleDrawCalls - (int32)HiddenDrawCalls;
-
-		// --- 混合结果 (Hybrid) ---
-		// 如果Ablation失败(<=0)，使用材质数量作为保底估计
-		// 即使Ablation成功，如果它小于材质数(不太可能，除非被完全遮挡且我们没关掉遮挡剔除)，也取最大值比较安全
-		int32 FinalDrawCalls = FMath::Max(AblationDrawCalls, TotalMaterialSlots);
-		
-		// 只有在真的有东西画的时候才记录
-		if (FinalDrawCalls > 0)
-		{
-			FActorDrawCallInfo& Info = Results.AddDefaulted_GetRef();
-			Info.Actor = Actor;
-			Info.ActorName = Actor->GetActorLabel();
-			Info.ActorClass = Actor->GetClass()->GetName();
-			Info.ActorLocation = Actor->GetActorLocation();
-			Info.MeshTypeText = BuildMeshTypeLabel(Actor);
-			Info.TotalDrawCalls = FinalDrawCalls;
-			Info.LOD0DrawCalls = FinalDrawCalls; 
-			Info.ComponentCount = ActiveComponentCount;
-			Info.TotalMaterialSlots = TotalMaterialSlots;
-
-			// 详细日志用于调试
-			UE_LOG(LogEditorTools, Verbose, TEXT("Actor: %s | Ablation: %d | Materials: %d | Final: %d"), 
-				*Info.ActorName, AblationDrawCalls, TotalMaterialSlots, FinalDrawCalls);
-		}
-	}
-
-	// 5. 恢复环境
-	if (CVarAllowOcclusionCulling)
+	else
 	{
-		CVarAllowOcclusionCulling->Set(OldAllowOcclusionCulling, ECVF_SetByCode);
+		GatherDrawCallsBySceneProxies(VisibleActors, Results);
 	}
 
-	// 恢复场景状态
-	if (GEditor) GEditor->RedrawAllViewports();
-	FlushRenderingCommands();
-
 	// 排序
 	Results.Sort([](const FActorDrawCallInfo& Lhs, const FActorDrawCallInfo& Rhs)
 	{
@@ -3273,10 +3351,13 @@ TArray<FActorDrawCallInfo> UEditorToolsBPFLibrary::GetVisibleActorsDrawCallStats
 		MessageLogListing->ClearMessages();
 
 		// 标题
+		const FText MethodText = (Mode == EDrawCallStatsMode::Ablation)
+			? LOCTEXT("DrawCallStatsMethodAblation", "Hybrid Method")
+			: LOCTEXT("DrawCallStatsMethodSceneProxy", "Scene Proxy Batches");
 		MessageLogListing->AddMessage(
 			FTokenizedMessage::Create(
 				EMessageSeverity::Info,
-				LOCTEXT("DrawCallStatsHeader", "------------------ 场景Draw Call统计 (Hybrid Method) ------------------")
+				FText::Format(LOCTEXT("DrawCallStatsHeader", "------------------ 场景Draw Call统计 ({0}) ------------------"), MethodText)
 			)
 		);
 
@@ -3382,4 +3463,494 @@ TArray<FActorDrawCallInfo> UEditorToolsBPFLibrary::GetVisibleActorsDrawCallStats
 	return Results;
 }
 
+namespace
+{
+	// 像素着色器指令数超过该值时用警告级别标注
+	constexpr int32 MaterialPixelInstructionWarningThreshold = 300;
+
+	/** 游戏线程收集的单个材质信息，着色器图引用保证工作线程读取期间不会被释放 */
+	struct FMaterialComplexityWorkItem
+	{
+		FMaterialComplexityInfo Info;
+		TRefCountPtr<FMaterialShaderMap> ShaderMap;
+		FEditorToolsMaterialShaderStatsPtr Stats;
+	};
+
+	static FString GetShadingModelDisplayName(const FMaterialShadingModelField& ShadingModels)
+	{
+		const UEnum* ShadingModelEnum = StaticEnum<EMaterialShadingModel>();
+		TArray<FString> Names;
+		for (int32 Index = 0; Index < MSM_NUM; ++Index)
+		{
+			if (ShadingModels.HasShadingModel((EMaterialShadingModel)Index))
+			{
+				Names.Add(ShadingModelEnum->GetDisplayNameTextByValue(Index).ToString());
+			}
+		}
+		return Names.Num() > 0 ? FString::Join(Names, TEXT(", ")) : ShadingModelEnum->GetDisplayNameTextByValue(MSM_DefaultLit).ToString();
+	}
+
+	/**
+	 * 计算材质的复杂度信息，按像素着色器指令数从高到低排序
+	 * 游戏线程：取当前特性等级的材质资源并等待编译完成，读取只能在游戏线程访问的属性；
+	 * 工作线程：按着色器图去重后并行读取指令数和纹理采样数（命中缓存时直接返回）。
+	 */
+	static TArray<FMaterialComplexityInfo> GatherMaterialComplexity(const TArray<UMaterialInterface*>& Materials, const TMap<UMaterialInterface*, int32>* UsageCounts)
+	{
+		TArray<FMaterialComplexityWorkItem> WorkItems;
+		WorkItems.Reserve(Materials.Num());
+
+		{
+			FScopedSlowTask SlowTask(Materials.Num(), LOCTEXT("MaterialComplexityCompiling", "正在等待材质着色器编译..."));
+			SlowTask.MakeDialogDelayed(1.0f);
+
+			for (UMaterialInterface* Material : Materials)
+			{
+				SlowTask.EnterProgressFrame();
+				if (!Material)
+				{
+					continue;
+				}
+
+				FMaterialComplexityWorkItem& Item = WorkItems.AddDefaulted_GetRef();
+				Item.Info.Material = Material;
+				Item.Info.MaterialName = Material->GetName();
+				Item.Info.MaterialPath = FPackageName::GetLongPackagePath(Material->GetOutermost()->GetName());
+				Item.Info.BlendMode = StaticEnum<EBlendMode>()->GetDisplayNameTextByValue(Material->GetBlendMode()).ToString();
+				Item.Info.ShadingModel = GetShadingModelDisplayName(Material->GetShadingModels());
+				Item.Info.bIsTwoSided = Material->IsTwoSided();
+				Item.Info.UsageCount = UsageCounts ? UsageCounts->FindRef(Material) : 0;
+
+				FMaterialResource* Resource = Material->GetMaterialResource(GMaxRHIFeatureLevel);
+				if (!Resource)
+				{
+					continue;
+				}
+
+				if (!Resource->IsCompilationFinished())
+				{
+					Resource->FinishCompilation();
+				}
+
+				Item.Info.bUsesWorldPositionOffset = Resource->MaterialUsesWorldPositionOffset_GameThread();
+				Item.Info.bUsesPixelDepthOffset = Resource->MaterialUsesPixelDepthOffset_GameThread();
+				Item.ShaderMap = Resource->GetGameThreadShaderMap();
+			}
+		}
+
+		// 同一个着色器图只统计一次（例如没有静态参数的材质实例与父材质共用）
+		TArray<FMaterialShaderMap*> UniqueShaderMaps;
+		TMap<FMaterialShaderMap*, int32> UniqueShaderMapIndices;
+		UniqueShaderMapIndices.Reserve(WorkItems.Num());
+		for (const FMaterialComplexityWorkItem& Item : WorkItems)
+		{
+			if (Item.ShaderMap.IsValid() && !UniqueShaderMapIndices.Contains(Item.ShaderMap.GetReference()))
+			{
+				UniqueShaderMapIndices.Add(Item.ShaderMap.GetReference(), UniqueShaderMaps.Add(Item.ShaderMap.GetReference()));
+			}
+		}
+
+		TArray<FEditorToolsMaterialShaderStatsPtr> UniqueStats;
+		UniqueStats.SetNum(UniqueShaderMaps.Num());
+		FEditorToolsMaterialStatsCache& StatsCache = FEditorToolsMaterialStatsCache::Get();
+		ParallelFor(UniqueShaderMaps.Num(), [&UniqueShaderMaps, &UniqueStats, &StatsCache](int32 Index)
+		{
+			UniqueStats[Index] = StatsCache.GetShaderMapStats(UniqueShaderMaps[Index]);
+		});
+
+		TArray<FMaterialComplexityInfo> Results;
+		Results.Reserve(WorkItems.Num());
+		for (FMaterialComplexityWorkItem& Item : WorkItems)
+		{
+			const int32* FoundStatsIndex = Item.ShaderMap.IsValid() ? UniqueShaderMapIndices.Find(Item.ShaderMap.GetReference()) : nullptr;
+			const int32 StatsIndex = FoundStatsIndex ? *FoundStatsIndex : INDEX_NONE;
+			if (StatsIndex != INDEX_NONE && UniqueStats[StatsIndex].IsValid())
+			{
+				const FEditorToolsMaterialShaderStats& Stats = *UniqueStats[StatsIndex];
+				Item.Info.bHasShaderStats = Stats.bHasRepresentativeShaders;
+				Item.Info.VertexShaderInstructionCount = Stats.VertexShaderInstructionCount;
+				Item.Info.PixelShaderInstructionCount = Stats.PixelShaderInstructionCount;
+				Item.Info.TextureSampleCount = Stats.VertexTextureSampleCount + Stats.PixelTextureSampleCount;
+			}
+			Results.Add(MoveTemp(Item.Info));
+		}
+
+		// 按像素着色器指令数从高到低排序，相同时按纹理采样数
+		Results.Sort([](const FMaterialComplexityInfo& A, const FMaterialComplexityInfo& B)
+		{
+			if (A.PixelShaderInstructionCount != B.PixelShaderInstructionCount)
+			{
+				return A.PixelShaderInstructionCount > B.PixelShaderInstructionCount;
+			}
+			return A.TextureSampleCount > B.TextureSampleCount;
+		});
+
+		return Results;
+	}
+
+	/** 在消息日志中列出材质复杂度结果 */
+	static void LogMaterialComplexity(const FText& HeaderText, const FText& ScopeText, const TArray<FMaterialComplexityInfo>& Infos)
+	{
+		TSharedPtr<IMessageLogListing> MessageLogListing = UEditorToolsUtilities::GetOrCreateMessageLogListing(true);
+		if (!MessageLogListing.IsValid())
+		{
+			return;
+		}
+
+		UEditorToolsUtilities::AddInfoMessage(MessageLogListing, HeaderText);
+		UEditorToolsUtilities::AddInfoMessage(MessageLogListing, ScopeText);
+
+		int32 HeavyCount = 0;
+		int32 MissingStatsCount = 0;
+		for (const FMaterialComplexityInfo& Info : Infos)
+		{
+			HeavyCount += Info.PixelShaderInstructionCount > MaterialPixelInstructionWarningThreshold ? 1 : 0;
+			MissingStatsCount += Info.bHasShaderStats ? 0 : 1;
+		}
+
+		UEditorToolsUtilities::AddInfoMessage(MessageLogListing,
+			FText::Format(LOCTEXT("MaterialComplexityStats", "找到 {0} 个材质，其中 {1} 个像素着色器指令数超过 {2}，{3} 个没有可用的着色器统计（不支持的材质域或编译失败）"),
+				FText::AsNumber(Infos.Num()),
+				FText::AsNumber(HeavyCount),
+				FText::AsNumber(MaterialPixelInstructionWarningThreshold),
+				FText::AsNumber(MissingStatsCount)));
+
+		if (Infos.Num() > 0)
+		{
+			const int32 RankWidth = FString::FromInt(Infos.Num()).Len();
+
+			MessageLogListing->AddMessage(
+				FTokenizedMessage::Create(
+					EMessageSeverity::Warning,
+					LOCTEXT("MaterialComplexityListHeader", "详细材质列表（按像素着色器指令数从高到低排序，点击可定位）：")
+				)
+			);
+
+			for (int32 i = 0; i < Infos.Num(); ++i)
+			{
+				const FMaterialComplexityInfo& Info = Infos[i];
+
+				FString RankStr = FString::FromInt(i + 1);
+				if ((i + 1) < 10)
+				{
+					RankStr = FString::Printf(TEXT(" %s"), *RankStr);
+				}
+				RankStr = RankStr.LeftPad(RankWidth);
+
+				const EMessageSeverity::Type Severity = Info.PixelShaderInstructionCount > MaterialPixelInstructionWarningThreshold ? EMessageSeverity::Warning : EMessageSeverity::Info;
+				TSharedRef<FTokenizedMessage> Message = FTokenizedMessage::Create(
+					Severity,
+					FText::FromString(FString::Printf(TEXT("#%s. [材质] "), *RankStr))
+				);
+
+				Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
+				Message->AddToken(FAssetObjectToken::Create(Info.Material, FText::FromString(EditorTools::BuildFixedDisplayName(Info.MaterialName))));
+
+				FString StatsText = Info.bHasShaderStats
+					? FString::Printf(TEXT(" [PS %d / VS %d / 采样 %d]"), Info.PixelShaderInstructionCount, Info.VertexShaderInstructionCount, Info.TextureSampleCount)
+					: FString::Printf(TEXT(" [无着色器统计 / 采样 %d]"), Info.TextureSampleCount);
+				StatsText += FString::Printf(TEXT(" %s, %s"), *Info.BlendMode, *Info.ShadingModel);
+				if (Info.bIsTwoSided)
+				{
+					StatsText += TEXT(", 双面");
+				}
+				if (Info.bUsesWorldPositionOffset)
+				{
+					StatsText += TEXT(", WPO");
+				}
+				if (Info.bUsesPixelDepthOffset)
+				{
+					StatsText += TEXT(", PDO");
+				}
+				if (Info.UsageCount > 0)
+				{
+					StatsText += FString::Printf(TEXT(", 使用 %d 次"), Info.UsageCount);
+				}
+				Message->AddToken(FTextToken::Create(FText::FromString(StatsText)));
+
+				const FString FullAssetPath = Info.MaterialPath + TEXT("/") + Info.MaterialName;
+				Message->AddToken(FTextToken::Create(FText::Format(LOCTEXT("MaterialComplexityPath", " ({0})"), FText::FromString(FullAssetPath))));
+
+				MessageLogListing->AddMessage(Message);
+			}
+		}
+
+		const FString FooterSeparator = FString::ChrN(80, TEXT('-'));
+		UEditorToolsUtilities::AddInfoMessage(MessageLogListing, FText::FromString(FooterSeparator));
+		UEditorToolsUtilities::OpenMessageLogPanel();
+	}
+}
+
+TArray<FMaterialComplexityInfo> UEditorToolsBPFLibrary::GetMaterialComplexityInFolders(const TArray<FString>& FolderPaths)
+{
+	TArray<FMaterialComplexityInfo> Results;
+
+#if WITH_EDITOR
+	TArray<FString> EffectiveFolderPaths = FolderPaths;
+
+	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
+	}
+
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("MaterialComplexityNoFolder", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“检查材质复杂度”。")
+		);
+		return Results;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// 收集所有文件夹内的材质和材质实例
+	TArray<FAssetData> MaterialAssets;
+	for (const FString& FolderPath : EffectiveFolderPaths)
+	{
+		FString SearchPath = UEditorToolsUtilities::NormalizeFolderPath(FolderPath);
+		SearchPath.RemoveFromEnd(TEXT("/"));
+		TArray<FAssetData> FolderAssets;
+		AssetRegistry.GetAssetsByPath(FName(*SearchPath), FolderAssets, true);
+
+		for (const FAssetData& AssetData : FolderAssets)
+		{
+			if (AssetData.IsInstanceOf(UMaterialInterface::StaticClass()))
+			{
+				MaterialAssets.Add(AssetData);
+			}
+		}
+	}
+
+	// 指令数只存在于已编译的着色器图中，所以必须加载材质
+	TArray<UMaterialInterface*> Materials;
+	Materials.Reserve(MaterialAssets.Num());
+	{
+		FScopedSlowTask SlowTask(MaterialAssets.Num(), LOCTEXT("MaterialComplexityLoading", "正在加载材质..."));
+		SlowTask.MakeDialogDelayed(1.0f);
+		for (const FAssetData& AssetData : MaterialAssets)
+		{
+			SlowTask.EnterProgressFrame();
+			if (UMaterialInterface* Material = Cast<UMaterialInterface>(AssetData.GetAsset()))
+			{
+				Materials.Add(Material);
+			}
+		}
+	}
+
+	Results = GatherMaterialComplexity(Materials, nullptr);
+
+	const FString FolderPathsText = EffectiveFolderPaths.Num() == 1 ? EffectiveFolderPaths[0] : FString::Printf(TEXT("%d个文件夹"), EffectiveFolderPaths.Num());
+	LogMaterialComplexity(
+		LOCTEXT("MaterialComplexityFolderHeader", "------------------ 检查材质复杂度 ------------------"),
+		FText::Format(LOCTEXT("MaterialComplexityFolderPath", "文件夹路径: {0}"), FText::FromString(FolderPathsText)),
+		Results);
+#endif
+
+	return Results;
+}
+
+TArray<FMaterialComplexityInfo> UEditorToolsBPFLibrary::GetMaterialComplexityInScene(UObject* WorldContextObject)
+{
+	TArray<FMaterialComplexityInfo> Results;
+
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GetMaterialComplexityInScene: Failed to get World from context"));
+		return Results;
+	}
+
+	// 统计每个材质被多少个网格体组件使用
+	TArray<UMaterialInterface*> Materials;
+	TMap<UMaterialInterface*, int32> UsageCounts;
+	TArray<UMaterialInterface*> ComponentMaterials;
+	auto AddComponentMaterials = [&](const UPrimitiveComponent* Component)
+	{
+		ComponentMaterials.Reset();
+		Component->GetUsedMaterials(ComponentMaterials);
+		for (UMaterialInterface* Material : TSet<UMaterialInterface*>(ComponentMaterials))
+		{
+			if (!Material)
+			{
+				continue;
+			}
+
+			int32& Count = UsageCounts.FindOrAdd(Material);
+			if (Count++ == 0)
+			{
+				Materials.Add(Material);
+			}
+		}
+	};
+
+	for (const FEditorToolsSceneActorEntry& Entry : UEditorToolsSceneIndexSubsystem::GetActorEntries(World))
+	{
+		TArray<UStaticMeshComponent*, TInlineAllocator<8>> StaticMeshComponents;
+		ResolveSceneIndexComponents(Entry.StaticMeshComponents, StaticMeshComponents);
+		for (const UStaticMeshComponent* Component : StaticMeshComponents)
+		{
+			AddComponentMaterials(Component);
+		}
+
+		TArray<USkeletalMeshComponent*, TInlineAllocator<4>> SkeletalMeshComponents;
+		ResolveSceneIndexComponents(Entry.SkeletalMeshComponents, SkeletalMeshComponents);
+		for (const USkeletalMeshComponent* Component : SkeletalMeshComponents)
+		{
+			AddComponentMaterials(Component);
+		}
+	}
+
+	Results = GatherMaterialComplexity(Materials, &UsageCounts);
+
+#if WITH_EDITOR
+	LogMaterialComplexity(
+		LOCTEXT("MaterialComplexitySceneHeader", "------------------ 场景材质复杂度 ------------------"),
+		FText::Format(LOCTEXT("MaterialComplexityScene", "场景: {0}"), FText::FromString(World->GetMapName())),
+		Results);
+#endif
+
+	return Results;
+}
+
+
+TArray<FDuplicateMaterialInstanceGroup> UEditorToolsBPFLibrary::FindDuplicateMaterialInstancesInFolders(const TArray<FString>& FolderPaths)
+{
+	TArray<FDuplicateMaterialInstanceGroup> Groups;
+
+#if WITH_EDITOR
+	TArray<FString> EffectiveFolderPaths = FolderPaths;
+
+	// 如果 FolderPaths 为空，从内容浏览器获取选中的文件夹
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+		ContentBrowserModule.Get().GetSelectedFolders(EffectiveFolderPaths);
+	}
+
+	if (EffectiveFolderPaths.Num() == 0)
+	{
+		UEditorToolsUtilities::LogWarningToMessageLogAndOpen(
+			LOCTEXT("DuplicateInstancesNoFolder", "请先在内容浏览器中选择一个或多个文件夹，然后再执行“查找重复材质实例”。")
+		);
+		return Groups;
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+	// 收集所有文件夹内的材质实例（多个文件夹可能互相嵌套，按包名去重）
+	TArray<FAssetData> InstanceAssets;
+	TSet<FName> SeenPackages;
+	for (const FString& FolderPath : EffectiveFolderPaths)
+	{
+		FString SearchPath = UEditorToolsUtilities::NormalizeFolderPath(FolderPath);
+		SearchPath.RemoveFromEnd(TEXT("/"));
+		TArray<FAssetData> FolderAssets;
+		AssetRegistry.GetAssetsByPath(FName(*SearchPath), FolderAssets, true);
+
+		for (const FAssetData& AssetData : FolderAssets)
+		{
+			if (AssetData.IsInstanceOf(UMaterialInstanceConstant::StaticClass()))
+			{
+				bool bAlreadySeen = false;
+				SeenPackages.Add(AssetData.PackageName, &bAlreadySeen);
+				if (!bAlreadySeen)
+				{
+					InstanceAssets.Add(AssetData);
+				}
+			}
+		}
+	}
+
+	// 参数覆盖值只存在于加载后的对象中
+	TArray<UMaterialInstanceConstant*> Instances;
+	Instances.Reserve(InstanceAssets.Num());
+	{
+		FScopedSlowTask SlowTask(InstanceAssets.Num(), LOCTEXT("DuplicateInstancesLoading", "正在加载材质实例..."));
+		SlowTask.MakeDialogDelayed(1.0f);
+		for (const FAssetData& AssetData : InstanceAssets)
+		{
+			SlowTask.EnterProgressFrame();
+			if (UMaterialInstanceConstant* Instance = Cast<UMaterialInstanceConstant>(AssetData.GetAsset()))
+			{
+				Instances.Add(Instance);
+			}
+		}
+	}
+
+	FDuplicateMaterialInstanceScanner::FindDuplicates(Instances, Groups);
+
+	TSharedPtr<IMessageLogListing> MessageLogListing = UEditorToolsUtilities::GetOrCreateMessageLogListing(true);
+	if (!MessageLogListing.IsValid())
+	{
+		return Groups;
+	}
+
+	const FString FolderPathsText = EffectiveFolderPaths.Num() == 1 ? EffectiveFolderPaths[0] : FString::Printf(TEXT("%d个文件夹"), EffectiveFolderPaths.Num());
+	UEditorToolsUtilities::AddInfoMessage(MessageLogListing, LOCTEXT("DuplicateInstancesHeader", "------------------ 查找重复材质实例 ------------------"));
+	UEditorToolsUtilities::AddInfoMessage(MessageLogListing, FText::Format(LOCTEXT("DuplicateInstancesFolderPath", "文件夹路径: {0}"), FText::FromString(FolderPathsText)));
+
+	int32 DuplicateCount = 0;
+	for (const FDuplicateMaterialInstanceGroup& Group : Groups)
+	{
+		DuplicateCount += Group.Duplicates.Num();
+	}
+
+	UEditorToolsUtilities::AddInfoMessage(MessageLogListing,
+		FText::Format(LOCTEXT("DuplicateInstancesStats", "检查了 {0} 个材质实例，找到 {1} 组重复，共 {2} 个实例可以合并"),
+			FText::AsNumber(Instances.Num()),
+			FText::AsNumber(Groups.Num()),
+			FText::AsNumber(DuplicateCount)));
+
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		const FDuplicateMaterialInstanceGroup& Group = Groups[GroupIndex];
+
+		TSharedRef<FTokenizedMessage> KeptMessage = FTokenizedMessage::Create(
+			EMessageSeverity::Warning,
+			FText::FromString(FString::Printf(TEXT("#%d. [保留] "), GroupIndex + 1))
+		);
+		KeptMessage->AddToken(FImageToken::Create(TEXT("Icons.Search")));
+		KeptMessage->AddToken(FAssetObjectToken::Create(Group.KeptInstance, FText::FromString(EditorTools::BuildFixedDisplayName(Group.KeptInstance.GetAssetName()))));
+		KeptMessage->AddToken(FTextToken::Create(FText::Format(LOCTEXT("DuplicateInstancesCount", " [{0} 个重复] ({1})"),
+			FText::AsNumber(Group.Duplicates.Num()), FText::FromString(Group.KeptInstance.GetLongPackageName()))));
+		MessageLogListing->AddMessage(KeptMessage);
+
+		for (const FSoftObjectPath& DuplicatePath : Group.Duplicates)
+		{
+			TSharedRef<FTokenizedMessage> DuplicateMessage = FTokenizedMessage::Create(
+				EMessageSeverity::Info,
+				FText::FromString(TEXT("      [重复] "))
+			);
+			DuplicateMessage->AddToken(FImageToken::Create(TEXT("Icons.Search")));
+			DuplicateMessage->AddToken(FAssetObjectToken::Create(DuplicatePath, FText::FromString(EditorTools::BuildFixedDisplayName(DuplicatePath.GetAssetName()))));
+			DuplicateMessage->AddToken(FTextToken::Create(FText::Format(LOCTEXT("DuplicateInstancesPath", " ({0})"), FText::FromString(DuplicatePath.GetLongPackageName()))));
+			MessageLogListing->AddMessage(DuplicateMessage);
+		}
+	}
+
+	const FString FooterSeparator = FString::ChrN(80, TEXT('-'));
+	UEditorToolsUtilities::AddInfoMessage(MessageLogListing, FText::FromString(FooterSeparator));
+	UEditorToolsUtilities::OpenMessageLogPanel();
+#endif
+
+	return Groups;
+}
+
+int32 UEditorToolsBPFLibrary::ConsolidateDuplicateMaterialInstances(const TArray<FDuplicateMaterialInstanceGroup>& Groups)
+{
+	int32 NumConsolidated = 0;
+
+#if WITH_EDITOR
+	NumConsolidated = FDuplicateMaterialInstanceScanner::ConsolidateDuplicates(Groups);
+
+	UEditorToolsUtilities::AddInfoMessage(UEditorToolsUtilities::GetOrCreateMessageLogListing(false),
+		FText::Format(LOCTEXT("DuplicateInstancesConsolidated", "已合并 {0} 个重复的材质实例，请保存修改过的资源。"), FText::AsNumber(NumConsolidated)));
+	UEditorToolsUtilities::OpenMessageLogPanel();
+#endif
+
+	return NumConsolidated;
+}
+
 #undef LOCTEXT_NAMESPACE
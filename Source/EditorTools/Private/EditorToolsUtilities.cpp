@@ -38,6 +38,78 @@ bool UEditorToolsUtilities::ResolveContentBrowserFolder(const FString& InputFold
 #endif
 }
 
+// 转换UE返回的路径格式为标准格式
+// 例如: "/All/Game/crates/MoonbackEchoes/S07" -> "/Game/crates/MoonbackEchoes/S07"
+FString UEditorToolsUtilities::NormalizeFolderPath(const FString& FolderPath)
+{
+	FString NormalizedPath = FolderPath;
+	
+	// 移除首尾空白
+	NormalizedPath.TrimStartAndEndInline();
+	
+	// 移除开头的引号（如果有）
+	if (NormalizedPath.StartsWith(TEXT("\"")))
+	{
+		NormalizedPath = NormalizedPath.Mid(1);
+	}
+	// 移除结尾的引号（如果有）
+	if (NormalizedPath.EndsWith(TEXT("\"")))
+	{
+		NormalizedPath = NormalizedPath.Left(NormalizedPath.Len() - 1);
+	}
+	
+	// 转换 /All/Game/ 为 /Game/
+	if (NormalizedPath.StartsWith(TEXT("/All/Game/")))
+	{
+		NormalizedPath = TEXT("/Game/") + NormalizedPath.Mid(10); // 10 = "/All/Game/".Len()
+	}
+	// 转换 /All/ 为 /Game/（如果路径不包含Game）
+	else if (NormalizedPath.StartsWith(TEXT("/All/")))
+	{
+		NormalizedPath = TEXT("/Game/") + NormalizedPath.Mid(5); // 5 = "/All/".Len()
+	}
+	// 如果路径以 /Game/ 开头，保持不变
+	else if (!NormalizedPath.StartsWith(TEXT("/Game/")))
+	{
+		// 如果路径不以 /Game/ 开头，尝试添加
+		if (NormalizedPath.StartsWith(TEXT("/")))
+		{
+			NormalizedPath = TEXT("/Game") + NormalizedPath;
+		}
+		// Game/Foo 只缺少开头的斜杠
+		else if (NormalizedPath.StartsWith(TEXT("Game/")))
+		{
+			NormalizedPath = TEXT("/") + NormalizedPath;
+		}
+		else
+		{
+			NormalizedPath = TEXT("/Game/") + NormalizedPath;
+		}
+	}
+	
+	// 确保路径以 / 结尾（用于搜索）
+	if (!NormalizedPath.EndsWith(TEXT("/")))
+	{
+		NormalizedPath += TEXT("/");
+	}
+	
+	return NormalizedPath;
+}
+
+FString UEditorToolsUtilities::MakeAssetObjectPath(const FString& FolderPath, const FString& AssetName)
+{
+	// 移除文件扩展名（如果用户提供了）
+	FString CleanAssetName = AssetName;
+	int32 DotIndex = INDEX_NONE;
+	if (CleanAssetName.FindLastChar(TEXT('.'), DotIndex))
+	{
+		CleanAssetName = CleanAssetName.Left(DotIndex);
+	}
+
+	// 资源引用格式：PackagePath.ObjectName
+	return NormalizeFolderPath(FolderPath) + CleanAssetName + TEXT(".") + CleanAssetName;
+}
+
 #if WITH_EDITOR
 namespace
 {
@@ -4,12 +4,18 @@
 #include "ContentBrowserModule.h"
 #include "IContentBrowserSingleton.h"
 #include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
 
 TSharedRef<FAssetObjectToken> FAssetObjectToken::Create(UObject* Object, const FText& DisplayText)
 {
 	return MakeShareable(new FAssetObjectToken(Object, DisplayText));
 }
 
+TSharedRef<FAssetObjectToken> FAssetObjectToken::Create(const FSoftObjectPath& AssetPath, const FText& DisplayText)
+{
+	return MakeShareable(new FAssetObjectToken(AssetPath, DisplayText));
+}
+
 FAssetObjectToken::FAssetObjectToken(UObject* InObject, const FText& InDisplayText)
 	: Object(InObject)
 {
@@ -33,3 +39,35 @@ FAssetObjectToken::FAssetObjectToken(UObject* InObject, const FText& InDisplayTe
 	});
 }
 
+FAssetObjectToken::FAssetObjectToken(const FSoftObjectPath& InAssetPath, const FText& InDisplayText)
+	: AssetPath(InAssetPath)
+{
+	CachedText = InDisplayText;
+
+	// 设置点击回调，通过资产注册表数据定位，内容浏览器同步不需要加载资产
+	MessageTokenActivated = FOnMessageTokenActivated::CreateLambda([SoftPath = AssetPath](const TSharedRef<IMessageToken>&)
+	{
+#if WITH_EDITOR
+		FAssetData AssetData = IAssetRegistry::GetChecked().GetAssetByObjectPath(SoftPath);
+		if (!AssetData.IsValid())
+		{
+			// 注册表中找不到（如尚未保存的新资产）时，只在点击时才尝试加载
+			if (UObject* ObjectPtr = SoftPath.TryLoad())
+			{
+				AssetData = FAssetData(ObjectPtr);
+			}
+		}
+
+		if (AssetData.IsValid())
+		{
+			FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
+			IContentBrowserSingleton& ContentBrowser = ContentBrowserModule.Get();
+
+			// 在内容浏览器中定位并选中资产
+			TArray<FAssetData> AssetsToSelect;
+			AssetsToSelect.Add(AssetData);
+			ContentBrowser.SyncBrowserToAssets(AssetsToSelect);
+		}
+#endif
+	});
+}
@@ -115,24 +115,13 @@ void FEditorToolsMessageLog::ShowUnusedAssetsReport(
 		{
 			const FUnusedAssetInfo& Info = UnusedAssets[i];
 			FString FullAssetPath = FString::Printf(TEXT("%s/%s"), *Info.AssetPath, *Info.AssetName);
-			
-			// 构建资产对象路径（格式：/Game/Path/AssetName.AssetName）
-			FString ObjectPath = FullAssetPath;
-			if (!ObjectPath.StartsWith(TEXT("/Game/")))
+
+			// 使用软引用路径创建 Token，报告本身不加载任何资产
+			FSoftObjectPath AssetSoftPath = Info.AssetSoftPath;
+			if (AssetSoftPath.IsNull())
 			{
-				if (ObjectPath.StartsWith(TEXT("/")))
-				{
-					ObjectPath = TEXT("/Game") + ObjectPath;
-				}
-				else
-				{
-					ObjectPath = TEXT("/Game/") + ObjectPath;
-				}
+				AssetSoftPath = FSoftObjectPath(FString::Printf(TEXT("%s.%s"), *FullAssetPath, *Info.AssetName));
 			}
-			ObjectPath = ObjectPath + TEXT(".") + Info.AssetName;
-			
-			// 尝试加载资产对象
-			UObject* AssetObject = LoadObject<UObject>(nullptr, *ObjectPath);
 			
 			// 创建可点击的消息（格式：序号 + 类型）
 			FString RankStr = FString::FromInt(i + 1);
@@ -150,17 +139,15 @@ void FEditorToolsMessageLog::ShowUnusedAssetsReport(
 
 			const FString DisplayName = EditorTools::BuildFixedDisplayName(Info.AssetName);
 			const FText DisplayText = FText::FromString(DisplayName);
-			if (AssetObject)
+			// 手动添加放大镜图标以保持与 GetHighPolyActorsInScene 的一致性
+			Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
+			if (Info.AssetObject)
 			{
-				// 手动添加放大镜图标以保持与 GetHighPolyActorsInScene 的一致性
-				Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
-				Message->AddToken(FAssetObjectToken::Create(AssetObject, DisplayText));
+				Message->AddToken(FAssetObjectToken::Create(Info.AssetObject, DisplayText));
 			}
 			else
 			{
-				// 如果无法加载资产，使用文本显示，需要手动添加放大镜图标
-				Message->AddToken(FImageToken::Create(TEXT("Icons.Search")));
-				Message->AddToken(FTextToken::Create(DisplayText));
+				Message->AddToken(FAssetObjectToken::Create(AssetSoftPath, DisplayText));
 			}
 			
 			// 添加路径信息
@@ -214,39 +201,31 @@ void FEditorToolsMessageLog::NavigateToAsset(const FString& AssetPath, const FSt
 	// 构建资产对象路径（格式：/Game/Path/AssetName.AssetName）
 	FString ObjectPath = FString::Printf(TEXT("/Game/%s.%s"), *CleanPath, *AssetName);
 
-	// 尝试加载资产
-	UObject* Asset = LoadObject<UObject>(nullptr, *ObjectPath);
-	
-	if (Asset)
+	// 优先通过资产注册表定位，不需要加载资产
+	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+	IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
+
+	FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(ObjectPath));
+	if (!AssetData.IsValid())
+	{
+		// 注册表中找不到时再尝试加载
+		if (UObject* Asset = LoadObject<UObject>(nullptr, *ObjectPath))
+		{
+			AssetData = FAssetData(Asset);
+		}
+	}
+
+	if (AssetData.IsValid())
 	{
-		// 使用内容浏览器定位到资产
 		FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-		TArray<UObject*> AssetsToSync;
-		AssetsToSync.Add(Asset);
+		TArray<FAssetData> AssetsToSync;
+		AssetsToSync.Add(AssetData);
 		ContentBrowserModule.Get().SyncBrowserToAssets(AssetsToSync);
 	}
-		else
-		{
-			// 如果直接加载失败，尝试通过资产注册表查找
-			FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-			IAssetRegistry& AssetRegistry = AssetRegistryModule.Get();
-			
-			FSoftObjectPath SoftObjectPath(ObjectPath);
-			FAssetData AssetData = AssetRegistry.GetAssetByObjectPath(SoftObjectPath);
-			
-			if (AssetData.IsValid())
-			{
-				// 使用资产数据定位
-				FContentBrowserModule& ContentBrowserModule = FModuleManager::LoadModuleChecked<FContentBrowserModule>("ContentBrowser");
-				TArray<FAssetData> AssetsToSync;
-				AssetsToSync.Add(AssetData);
-				ContentBrowserModule.Get().SyncBrowserToAssets(AssetsToSync);
-			}
-			else
-			{
-				UE_LOG_EDITORTOOLS_WARNING(TEXT("无法找到资产: %s"), *ObjectPath);
-			}
-		}
+	else
+	{
+		UE_LOG_EDITORTOOLS_WARNING(TEXT("无法找到资产: %s"), *ObjectPath);
+	}
 #endif
 }
 
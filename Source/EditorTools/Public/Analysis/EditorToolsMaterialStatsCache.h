@@ -0,0 +1,70 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+#include "RHIDefinitions.h"
+
+class FMaterialShaderMap;
+
+/**
+ * 一个已编译着色器图的代表性统计
+ * 表面材质取 FLocalVertexFactory 上无光照贴图的基础通道 VS/PS，后处理材质取后处理 VS/PS，与材质编辑器的 Stats 面板一致
+ */
+struct FEditorToolsMaterialShaderStats
+{
+	int32 VertexShaderInstructionCount = 0;
+	int32 PixelShaderInstructionCount = 0;
+	int32 VertexTextureSampleCount = 0;
+	int32 PixelTextureSampleCount = 0;
+
+	/** 着色器图中找到了代表性着色器 */
+	bool bHasRepresentativeShaders = false;
+};
+
+typedef TSharedPtr<const FEditorToolsMaterialShaderStats, ESPMode::ThreadSafe> FEditorToolsMaterialShaderStatsPtr;
+
+/**
+ * 按着色器图 ID 缓存材质的指令数和纹理采样数，供文件夹和场景的材质复杂度扫描共享
+ * 着色器图 ID 包含材质的全部编译输入，材质修改后 ID 随之变化，所以不需要失效回调；
+ * 共用同一个父材质且没有静态参数的材质实例会共用一个条目。
+ */
+class EDITORTOOLS_API FEditorToolsMaterialStatsCache
+{
+public:
+	/** 创建缓存 */
+	static void Initialize();
+
+	/** 销毁缓存 */
+	static void Shutdown();
+
+	/** 获取缓存实例（未初始化时自动初始化） */
+	static FEditorToolsMaterialStatsCache& Get();
+
+	/**
+	 * 获取着色器图的统计，未命中时从着色器图中的代表性着色器读取并写入缓存
+	 * 线程安全；调用方需持有着色器图的引用，并保证它已经编译完成
+	 * @return 着色器图为空时返回空指针
+	 */
+	FEditorToolsMaterialShaderStatsPtr GetShaderMapStats(const FMaterialShaderMap* ShaderMap);
+
+	/** 清空全部缓存 */
+	void Reset();
+
+	/** 当前缓存的着色器图数量 */
+	int32 Num() const;
+
+private:
+	typedef TPair<FSHAHash, EShaderPlatform> FShaderMapKey;
+
+	static FShaderMapKey MakeKey(const FMaterialShaderMap* ShaderMap);
+
+	FEditorToolsMaterialShaderStatsPtr FindEntry(const FShaderMapKey& Key) const;
+	FEditorToolsMaterialShaderStatsPtr AddEntry(const FShaderMapKey& Key, FEditorToolsMaterialShaderStats&& Stats);
+
+private:
+	mutable FRWLock EntriesLock;
+	TMap<FShaderMapKey, FEditorToolsMaterialShaderStatsPtr> Entries;
+
+	static FEditorToolsMaterialStatsCache* Instance;
+};
@@ -0,0 +1,83 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+class UStaticMesh;
+class USkeletalMesh;
+
+/**
+ * 单个LOD的三角面和分段统计
+ */
+struct FEditorToolsMeshLODStats
+{
+	int32 TriangleCount = 0;
+	int32 SectionCount = 0;
+};
+
+/**
+ * 单个网格体资产的逐LOD统计
+ */
+struct FEditorToolsMeshStats
+{
+	TArray<FEditorToolsMeshLODStats, TInlineAllocator<8>> LODs;
+
+	int32 GetNumLODs() const { return LODs.Num(); }
+	int32 GetTriangleCount(int32 LODIndex) const { return LODs.IsValidIndex(LODIndex) ? LODs[LODIndex].TriangleCount : 0; }
+	int32 GetSectionCount(int32 LODIndex) const { return LODs.IsValidIndex(LODIndex) ? LODs[LODIndex].SectionCount : 0; }
+};
+
+typedef TSharedPtr<const FEditorToolsMeshStats, ESPMode::ThreadSafe> FEditorToolsMeshStatsPtr;
+
+/**
+ * 按 UStaticMesh / USkeletalMesh 缓存逐LOD三角面和分段数量，供所有场景扫描功能共享
+ * 网格体属性变化（PostEditChange）时自动失效，垃圾回收后清理失效条目
+ */
+class EDITORTOOLS_API FEditorToolsMeshStatsCache
+{
+public:
+	/** 创建缓存并注册失效回调 */
+	static void Initialize();
+
+	/** 注销回调并销毁缓存 */
+	static void Shutdown();
+
+	/** 获取缓存实例（未初始化时自动初始化） */
+	static FEditorToolsMeshStatsCache& Get();
+
+	/**
+	 * 获取静态网格体的统计信息，未命中时从渲染数据计算并写入缓存
+	 * 线程安全；在工作线程调用时，调用方需保证网格体没有正在异步编译
+	 * @return 网格体无效或没有渲染数据时返回空指针
+	 */
+	FEditorToolsMeshStatsPtr GetStaticMeshStats(const UStaticMesh* StaticMesh);
+
+	/** 获取骨骼网格体的统计信息，规则同 GetStaticMeshStats */
+	FEditorToolsMeshStatsPtr GetSkeletalMeshStats(const USkeletalMesh* SkeletalMesh);
+
+	/** 使指定网格体的缓存失效 */
+	void Invalidate(const UObject* Mesh);
+
+	/** 清空全部缓存 */
+	void Reset();
+
+private:
+	FEditorToolsMeshStatsCache();
+	~FEditorToolsMeshStatsCache();
+
+	FEditorToolsMeshStatsPtr FindEntry(const UObject* Mesh) const;
+	FEditorToolsMeshStatsPtr AddEntry(const UObject* Mesh, FEditorToolsMeshStats&& Stats);
+
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+	void OnPostGarbageCollect();
+
+private:
+	mutable FRWLock EntriesLock;
+	TMap<FObjectKey, FEditorToolsMeshStatsPtr> Entries;
+
+	FDelegateHandle ObjectPropertyChangedHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	static FEditorToolsMeshStatsCache* Instance;
+};
@@ -0,0 +1,109 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EditorSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "EditorToolsSceneIndexSubsystem.generated.h"
+
+class AActor;
+class UActorComponent;
+class ULevel;
+class ULightComponent;
+class USkeletalMeshComponent;
+class UStaticMeshComponent;
+
+/**
+ * 场景索引中的单个Actor条目，只记录场景分析功能关心的组件
+ */
+struct FEditorToolsSceneActorEntry
+{
+	TWeakObjectPtr<AActor> Actor;
+	FObjectKey ActorKey;
+	TArray<TWeakObjectPtr<UStaticMeshComponent>, TInlineAllocator<2>> StaticMeshComponents;
+	TArray<TWeakObjectPtr<USkeletalMeshComponent>, TInlineAllocator<1>> SkeletalMeshComponents;
+	TArray<TWeakObjectPtr<ULightComponent>, TInlineAllocator<1>> LightComponents;
+};
+
+/**
+ * 编辑器场景分析索引
+ * 按世界缓存含网格体或灯光组件的Actor，首次查询时全量构建，之后根据Actor增删和修改事件增量更新，
+ * 避免每次运行场景报告都完整遍历 TActorIterator。只缓存编辑器世界，PIE等其他世界每次查询临时构建。
+ */
+UCLASS()
+class EDITORTOOLS_API UEditorToolsSceneIndexSubsystem : public UEditorSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * 获取世界中已索引的Actor条目（先应用待处理的增量）
+	 * 返回的数组在下一次查询或场景修改前有效，只能在游戏线程使用
+	 */
+	static const TArray<FEditorToolsSceneActorEntry>& GetActorEntries(UWorld* World);
+
+	/** 丢弃指定世界的索引，下次查询时全量重建 */
+	void InvalidateWorld(UWorld* World);
+
+private:
+	struct FWorldSceneIndex
+	{
+		TArray<FEditorToolsSceneActorEntry> Entries;
+		TMap<FObjectKey, int32> EntryIndexByActor;
+		TMap<FObjectKey, TWeakObjectPtr<AActor>> PendingActors;
+		bool bNeedsFullRebuild = true;
+
+		/** World Partition 世界的持久关卡，加载/卸载Actor时不会触发 GEngine 的Actor增删事件 */
+		TWeakObjectPtr<ULevel> PartitionedLevel;
+		FDelegateHandle LoadedActorAddedHandle;
+		FDelegateHandle LoadedActorRemovedHandle;
+	};
+
+	const TArray<FEditorToolsSceneActorEntry>& GetOrUpdateEntries(UWorld* World);
+
+	FWorldSceneIndex& FindOrAddWorldIndex(UWorld* World);
+	void RemoveWorldIndex(UWorld* World);
+	static void UnbindLoadedActorEvents(FWorldSceneIndex& Index);
+
+	static void BuildFullIndex(UWorld* World, FWorldSceneIndex& Index);
+	static void ApplyPendingActors(FWorldSceneIndex& Index);
+	static void UpsertActor(FWorldSceneIndex& Index, AActor* Actor);
+	static void RemoveEntryAt(FWorldSceneIndex& Index, int32 EntryIndex);
+	static bool BuildActorEntry(AActor* Actor, FEditorToolsSceneActorEntry& OutEntry);
+
+	FWorldSceneIndex* FindIndexForActor(const AActor* Actor);
+	void MarkActorDirty(AActor* Actor);
+	void MarkAllWorldsForRebuild();
+
+	void OnLevelActorAdded(AActor* Actor);
+	void OnLevelActorDeleted(AActor* Actor);
+	void OnLoadedActorAdded(AActor& Actor);
+	void OnLoadedActorRemoved(AActor& Actor);
+	void OnObjectModified(UObject* Object);
+	void OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+	void OnObjectsReplaced(const TMap<UObject*, UObject*>& ReplacementMap);
+	void OnLevelChanged(ULevel* Level, UWorld* World);
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+	void OnPostUndoRedo();
+	void OnMapChange(uint32 MapChangeFlags);
+
+private:
+	TMap<FObjectKey, FWorldSceneIndex> WorldIndices;
+
+	/** 非编辑器世界的临时索引，每次查询重建 */
+	FWorldSceneIndex TransientIndex;
+
+	FDelegateHandle LevelActorAddedHandle;
+	FDelegateHandle LevelActorDeletedHandle;
+	FDelegateHandle ObjectModifiedHandle;
+	FDelegateHandle ObjectPropertyChangedHandle;
+	FDelegateHandle ObjectsReplacedHandle;
+	FDelegateHandle LevelAddedToWorldHandle;
+	FDelegateHandle LevelRemovedFromWorldHandle;
+	FDelegateHandle WorldCleanupHandle;
+	FDelegateHandle PostUndoRedoHandle;
+	FDelegateHandle MapChangeHandle;
+};
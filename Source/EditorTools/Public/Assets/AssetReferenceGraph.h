@@ -0,0 +1,128 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "Templates/Function.h"
+
+class IAssetRegistry;
+
+typedef TSharedRef<const class FAssetReferenceGraph, ESPMode::ThreadSafe> FAssetReferenceGraphRef;
+typedef TSharedPtr<const class FAssetReferenceGraph, ESPMode::ThreadSafe> FAssetReferenceGraphPtr;
+
+/**
+ * 资产包依赖关系图快照
+ * 从资产注册表一次性构建，正向（依赖）和反向（引用者）边都以 CSR 紧凑数组存储，节点为包索引。
+ * 构建完成后只读，可以在任意线程查询。注册表发生变化或包被保存时只记录变化的包，
+ * 下次获取快照时沿用旧快照中其余包的依赖，只重新读取变化包的依赖。
+ */
+class EDITORTOOLS_API FAssetReferenceGraph
+{
+public:
+	/** 注册资产注册表变化回调 */
+	static void Initialize();
+
+	/** 注销回调并释放缓存的快照 */
+	static void Shutdown();
+
+	/**
+	 * 获取缓存的快照：没有快照或已整体失效时重新构建，只有部分包变化时在旧快照上更新这些包的依赖
+	 * 线程安全；构建期间其他调用者会等待同一次构建完成
+	 */
+	static FAssetReferenceGraphRef GetSnapshot();
+
+	/**
+	 * 可取消的 GetSnapshot，供工作线程上的检查使用
+	 * 需要构建且构建期间 ShouldCancel 返回 true 时放弃构建并返回空指针，缓存的快照和待更新的包保持不变
+	 */
+	static FAssetReferenceGraphPtr GetSnapshot(TFunctionRef<bool()> ShouldCancel);
+
+	/** 使缓存的快照整体失效，下次获取时完整重建 */
+	static void InvalidateSnapshot();
+
+	/**
+	 * 从资产注册表构建新的快照（注册表查询自带锁，可以在工作线程调用）
+	 * 逐包查询依赖时定期调用 ShouldCancel，返回 true 时中止并返回空指针
+	 */
+	static FAssetReferenceGraphPtr Build(const IAssetRegistry& AssetRegistry, TFunctionRef<bool()> ShouldCancel);
+
+	/**
+	 * 在已有快照的基础上构建新快照：未变化的包沿用旧的节点和依赖，只向注册表查询变化的包
+	 * 结果与完整构建相同（包索引顺序可能不同）；取消方式与 Build 相同
+	 */
+	static FAssetReferenceGraphPtr BuildPatched(const FAssetReferenceGraph& Previous, const TSet<FName>& ChangedPackages, const IAssetRegistry& AssetRegistry, TFunctionRef<bool()> ShouldCancel);
+
+	int32 NumPackages() const { return PackageNames.Num(); }
+
+	/** 查找包索引，不存在时返回 INDEX_NONE */
+	int32 FindPackageIndex(FName PackageName) const;
+
+	FName GetPackageName(int32 PackageIndex) const { return PackageNames[PackageIndex]; }
+
+	/** 是否为项目内（/Game/）的包 */
+	bool IsProjectPackage(int32 PackageIndex) const { return EnumHasAnyFlags(PackageFlags[PackageIndex], EPackageFlags::Project); }
+
+	/** 是否包含关卡（UWorld） */
+	bool IsMapPackage(int32 PackageIndex) const { return EnumHasAnyFlags(PackageFlags[PackageIndex], EPackageFlags::Map); }
+
+	/** 该包直接依赖的包 */
+	TConstArrayView<int32> GetDependencies(int32 PackageIndex) const;
+
+	/** 直接引用该包的包 */
+	TConstArrayView<int32> GetReferencers(int32 PackageIndex) const;
+
+	/** 是否被任意项目内的包直接引用（同一文件夹内的引用也算作使用） */
+	bool IsReferencedByProjectPackage(int32 PackageIndex) const;
+
+	/** 所有关卡包的索引 */
+	const TArray<int32>& GetMapPackageIndices() const { return MapPackageIndices; }
+
+	/**
+	 * 从根节点沿依赖边做传递可达标记
+	 * @param OutReachable 按包索引的可达位，会被重置为 NumPackages() 大小
+	 */
+	void MarkReachable(TConstArrayView<int32> RootIndices, TBitArray<>& OutReachable) const;
+
+	/**
+	 * 查找孤立簇：项目内非关卡包按依赖关系连通后，整个连通分量都没有被分量外的项目包引用
+	 * 单个未被引用的包也是一个孤立簇
+	 */
+	void FindOrphanClusters(TArray<TArray<int32>>& OutClusters) const;
+
+private:
+	enum class EPackageFlags : uint8
+	{
+		None = 0,
+		Project = 1 << 0,
+		Map = 1 << 1,
+		/** 注册表中有资产的包（其余节点只作为依赖目标出现） */
+		Asset = 1 << 2,
+	};
+	FRIEND_ENUM_CLASS_FLAGS(EPackageFlags);
+
+	FAssetReferenceGraph() = default;
+
+	/** 查找或添加节点 */
+	int32 AddPackage(FName PackageName);
+
+	/** 标记为注册表中的资产包 */
+	void MarkAssetPackage(int32 PackageIndex, bool bIsMap);
+
+	/** 把注册表中查到的依赖转换为边（跳过自身和脚本包） */
+	void AddDependencyEdges(int32 PackageIndex, const TArray<FName>& DependencyNames, TArray<TPair<int32, int32>>& InOutEdges);
+
+	void AddEdges(const TArray<TPair<int32, int32>>& Edges);
+
+	TArray<FName> PackageNames;
+	TMap<FName, int32> PackageIndexByName;
+	TArray<EPackageFlags> PackageFlags;
+	TArray<int32> MapPackageIndices;
+
+	/** CSR：DependencyOffsets[i]..DependencyOffsets[i+1] 是包 i 的依赖 */
+	TArray<int32> DependencyOffsets;
+	TArray<int32> Dependencies;
+
+	/** CSR：ReferencerOffsets[i]..ReferencerOffsets[i+1] 是包 i 的引用者 */
+	TArray<int32> ReferencerOffsets;
+	TArray<int32> Referencers;
+};
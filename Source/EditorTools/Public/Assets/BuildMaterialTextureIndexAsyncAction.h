@@ -0,0 +1,75 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "AssetRegistry/AssetData.h"
+#include "Engine/StreamableManager.h"
+#include "Types/MaterialTextureBindingTypes.h"
+#include "BuildMaterialTextureIndexAsyncAction.generated.h"
+
+class FAsyncTaskNotification;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMaterialTextureIndexBuilt, const TArray<FMaterialTextureBindings>&, Materials);
+
+/**
+ * 异步获取文件夹内全部材质的纹理参数绑定
+ * 先用磁盘索引和注册表依赖数据判断，只有依赖了纹理且索引过期的材质才会分批异步加载；
+ * 每批处理完立即释放加载句柄，内存占用不随文件夹大小增长。
+ * 进度显示在带取消按钮的通知中，取消时 OnCancelled 返回已经建立索引的部分结果
+ */
+UCLASS()
+class EDITORTOOLS_API UBuildMaterialTextureIndexAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	//异步获取指定文件夹内全部材质和材质实例的纹理参数绑定
+	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material", meta = (BlueprintInternalUseOnly = "true"))
+	static UBuildMaterialTextureIndexAsyncAction* GetMaterialTextureBindingsInFoldersAsync(const TArray<FString>& FolderPaths);
+
+	/** 全部材质已建立索引 */
+	UPROPERTY(BlueprintAssignable)
+	FOnMaterialTextureIndexBuilt OnCompleted;
+
+	/** 用户取消或没有可检查的文件夹 */
+	UPROPERTY(BlueprintAssignable)
+	FOnMaterialTextureIndexBuilt OnCancelled;
+
+	virtual void Activate() override;
+
+	/** 请求取消（也可以通过通知上的取消按钮触发），当前批次加载完成后生效 */
+	void Cancel();
+
+private:
+	/** 用索引或注册表数据处理材质，都不可用时加入加载队列 */
+	void EnqueueMaterial(const FAssetData& AssetData);
+	void EnqueueParent(const FSoftObjectPath& ParentPath);
+
+	void LoadNextBatch();
+	void OnBatchLoaded();
+	void Finish(bool bWasCancelled);
+
+private:
+	TArray<FString> FolderPaths;
+
+	/** 文件夹内的材质，结果按此顺序返回 */
+	TArray<FAssetData> Targets;
+
+	/** 已处理过的包（包含文件夹外的父材质） */
+	TSet<FName> VisitedPackages;
+
+	/** 需要加载的材质，处理加载结果时会追加新发现的父材质 */
+	TArray<FSoftObjectPath> LoadQueue;
+	int32 NextLoadIndex = 0;
+	TArray<FSoftObjectPath> CurrentBatch;
+
+	int32 NumFromIndex = 0;
+	int32 NumFromRegistry = 0;
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+	TSharedPtr<FAsyncTaskNotification> Notification;
+	bool bCancelRequested = false;
+};
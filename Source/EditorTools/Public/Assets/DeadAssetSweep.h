@@ -0,0 +1,33 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAssetReferenceGraph;
+
+/**
+ * 基于可达性的无用资源检测（标记-清除）
+ * 从项目设置中的关卡、主资产和始终烘焙目录出发沿依赖边标记，项目内未被标记的包即为不会进入烘焙的资源。
+ * 与"是否被任意 /Game/ 包引用"不同，只被无用资源引用的资源也会被一起找出。
+ */
+class EDITORTOOLS_API FDeadAssetSweep
+{
+public:
+	/**
+	 * 收集项目的根包（必须在游戏线程调用，需要读取项目设置和 AssetManager）：
+	 * - 打包设置中的 MapsToCook（为空时与烘焙行为一致，使用项目内所有关卡）
+	 * - 默认游戏地图
+	 * - AssetManager 中烘焙规则不是 NeverCook 的主资产
+	 * - 打包设置中的 DirectoriesToAlwaysCook 目录下的所有包
+	 * - 以上关卡的外部 Actor（__ExternalActors__）和外部对象（__ExternalObjects__）包
+	 */
+	static void CollectProjectRoots(TArray<FName>& OutRootPackages);
+
+	/**
+	 * 标记-清除，返回不可达的项目包（可以在工作线程调用）
+	 * 关卡的外部 Actor 和外部对象包不会作为结果返回
+	 * @param PackagePathPrefixes 只返回这些路径下的包（形如 "/Game/Foo/"），为空时返回整个 /Game/
+	 * @param OutNumCheckedPackages 参与检查的项目包数量（同样按路径过滤，不含外部包）
+	 */
+	static void FindDeadPackages(const FAssetReferenceGraph& Graph, const TArray<FName>& RootPackages, const TArray<FString>& PackagePathPrefixes, TArray<FName>& OutDeadPackages, int32& OutNumCheckedPackages);
+};
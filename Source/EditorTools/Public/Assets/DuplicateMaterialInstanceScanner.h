@@ -0,0 +1,31 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/DuplicateMaterialInstanceTypes.h"
+
+class UMaterialInstanceConstant;
+
+/**
+ * 重复材质实例检测
+ * 每个实例的签名由父材质和全部覆盖值（标量、向量、纹理等对象参数、静态开关、通道遮罩、基础属性覆盖）按参数排序后序列化得到，
+ * 先比较签名哈希再逐字节确认。父材质也在扫描范围内时按层处理，签名使用父材质所在组的保留实例，
+ * 所以父材质互为重复的子实例同样会被归为一组。
+ */
+class EDITORTOOLS_API FDuplicateMaterialInstanceScanner
+{
+public:
+	/**
+	 * 查找重复的材质实例（必须在游戏线程调用，签名在工作线程中并行计算）
+	 * 使用材质图层的实例不参与比较
+	 * @param OutGroups 只包含至少有一个重复实例的组，按重复数量从多到少排序
+	 */
+	static void FindDuplicates(const TArray<UMaterialInstanceConstant*>& Instances, TArray<FDuplicateMaterialInstanceGroup>& OutGroups);
+
+	/**
+	 * 把每组的重复实例合并到保留实例：替换全部引用后删除重复实例（留下重定向器）
+	 * 被修改的包只会标记为脏，需要用户保存
+	 * @return 成功合并的实例数量
+	 */
+	static int32 ConsolidateDuplicates(const TArray<FDuplicateMaterialInstanceGroup>& Groups);
+};
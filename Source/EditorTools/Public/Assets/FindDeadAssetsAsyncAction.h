@@ -0,0 +1,46 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Types/UnusedAssetTypes.h"
+#include "FindDeadAssetsAsyncAction.generated.h"
+
+class FAsyncTaskNotification;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDeadAssetSweepFinished, const TArray<FUnusedAssetInfo>&, DeadAssets);
+
+/**
+ * 异步查找不可达（不会被烘焙）的资源
+ * 游戏线程收集项目根包，引用图构建和标记-清除在后台线程执行，完成后输出消息日志报告
+ * 通知带取消按钮，引用图构建期间也可以取消
+ */
+UCLASS()
+class EDITORTOOLS_API UFindDeadAssetsAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	//从关卡、主资产和始终烘焙目录出发，查找不可达的项目资源（整个无用子图一次找出）
+	//FolderPaths 只用于过滤结果，为空时报告整个 /Game
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Unused Assets", meta = (BlueprintInternalUseOnly = "true"))
+	static UFindDeadAssetsAsyncAction* FindUnreachableAssetsAsync(const TArray<FString>& FolderPaths);
+
+	/** 检查完成 */
+	UPROPERTY(BlueprintAssignable)
+	FOnDeadAssetSweepFinished OnCompleted;
+
+	/** 检查被取消（不返回结果） */
+	UPROPERTY(BlueprintAssignable)
+	FOnDeadAssetSweepFinished OnCancelled;
+
+	virtual void Activate() override;
+
+private:
+	void OnSweepFinished(TArray<FName>&& DeadPackages, int32 NumCheckedPackages, bool bWasCancelled);
+
+private:
+	TArray<FString> FolderPaths;
+	TArray<FString> PackagePathPrefixes;
+	TSharedPtr<FAsyncTaskNotification> Notification;
+};
@@ -0,0 +1,55 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "AssetRegistry/AssetData.h"
+#include "Types/UnusedAssetTypes.h"
+#include <atomic>
+#include "FindUnusedAssetsAsyncAction.generated.h"
+
+class FAsyncTaskNotification;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnUnusedAssetScanFinished, const TArray<FUnusedAssetInfo>&, UnusedAssets);
+
+/**
+ * 异步检查文件夹内未使用的资源
+ * 游戏线程只收集候选资源，引用检查在后台线程执行，编辑器不会卡住；
+ * 进度显示在带取消按钮的通知中，取消时 OnCancelled 返回已经检查出的部分结果
+ * 结果只包含软引用路径和注册表标签，不会加载任何资源
+ */
+UCLASS()
+class EDITORTOOLS_API UFindUnusedAssetsAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	//异步检查指定文件夹内未使用的资源
+	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Unused Assets", meta = (BlueprintInternalUseOnly = "true"))
+	static UFindUnusedAssetsAsyncAction* FindUnusedAssetsInFolderAsync(EUnusedAssetCategory Category, const TArray<FString>& FolderPaths);
+
+	/** 检查完成 */
+	UPROPERTY(BlueprintAssignable)
+	FOnUnusedAssetScanFinished OnCompleted;
+
+	/** 用户取消或没有可检查的文件夹 */
+	UPROPERTY(BlueprintAssignable)
+	FOnUnusedAssetScanFinished OnCancelled;
+
+	virtual void Activate() override;
+
+	/** 请求取消（也可以通过通知上的取消按钮触发） */
+	void Cancel();
+
+private:
+	void OnScanFinished(TArray<int32>&& UnusedCandidateIndices, bool bWasCancelled);
+	void Finish(const TArray<FUnusedAssetInfo>& UnusedAssets, bool bWasCancelled);
+
+private:
+	EUnusedAssetCategory Category = EUnusedAssetCategory::Mesh;
+	TArray<FString> FolderPaths;
+	TArray<FAssetData> Candidates;
+	TSharedPtr<FAsyncTaskNotification> Notification;
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> CancelRequested;
+};
@@ -0,0 +1,48 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "Engine/StreamableManager.h"
+#include "LoadTexturesAsyncAction.generated.h"
+
+class UTexture;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnTexturesLoaded, const TArray<UTexture*>&, Textures);
+
+/**
+ * 异步批量加载纹理，LoadTextureFromPath 的批量版本
+ * 全部路径先通过注册表解析，再用一次 FStreamableManager 请求加载整批纹理，游戏线程不会逐个等待；
+ * 结果与输入一一对应，找不到或不是纹理的条目为空
+ */
+UCLASS()
+class EDITORTOOLS_API ULoadTexturesAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	//异步加载多个纹理资源
+	//AssetPaths只有一个元素时所有AssetNames共用该路径，否则与AssetNames一一对应
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Texture", meta = (BlueprintInternalUseOnly = "true"))
+	static ULoadTexturesAsyncAction* LoadTexturesFromPathsAsync(const TArray<FString>& AssetPaths, const TArray<FString>& AssetNames);
+
+	/** 加载完成，Textures 与 AssetNames 一一对应 */
+	UPROPERTY(BlueprintAssignable)
+	FOnTexturesLoaded OnCompleted;
+
+	virtual void Activate() override;
+
+private:
+	/** 加载完成（或无需加载）时广播结果并释放句柄 */
+	void Finish();
+
+private:
+	TArray<FString> AssetPaths;
+	TArray<FString> AssetNames;
+
+	/** 每个输入解析出的纹理路径，解析失败为空 */
+	TArray<FSoftObjectPath> ResolvedPaths;
+
+	FStreamableManager StreamableManager;
+	TSharedPtr<FStreamableHandle> LoadHandle;
+};
@@ -0,0 +1,90 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IO/IoHash.h"
+#include "UObject/SoftObjectPath.h"
+#include "Types/MaterialTextureBindingTypes.h"
+
+class IAssetRegistry;
+class UMaterialInterface;
+struct FAssetData;
+
+/**
+ * 材质 -> 纹理参数绑定索引，保存在 Saved/EditorTools/MaterialTextureIndex.bin
+ * 每个材质包一个条目：包的保存哈希、父材质和自身的纹理参数值（材质为参数默认值，材质实例只记录覆盖值）。
+ * 材质实例的有效绑定在查询时沿父材质链合并，父材质修改后不需要重新读取子实例；条目只在包的保存哈希变化时失效。
+ * 只能在游戏线程使用。
+ */
+class EDITORTOOLS_API FMaterialTextureIndex
+{
+public:
+	struct FEntry
+	{
+		/** 建立条目时包的保存哈希 */
+		FIoHash PackageSavedHash;
+
+		FSoftObjectPath MaterialPath;
+
+		/** 材质实例的父材质，材质为空 */
+		FSoftObjectPath ParentPath;
+
+		/** 材质：全部纹理参数的默认值；材质实例：自身覆盖的纹理参数 */
+		TArray<FMaterialTextureBinding> Textures;
+	};
+
+	/** 获取索引实例，首次调用时从磁盘读取 */
+	static FMaterialTextureIndex& Get();
+
+	/** 写回未保存的修改并释放索引实例 */
+	static void Shutdown();
+
+	/** 从注册表读取包的保存哈希，包不存在或从未保存时返回零哈希 */
+	static FIoHash GetPackageSavedHash(const IAssetRegistry& AssetRegistry, FName PackageName);
+
+	/**
+	 * 只用注册表数据建立条目，不加载材质
+	 * 包不依赖任何纹理时：材质没有纹理参数，材质实例没有纹理覆盖（父材质来自注册表的 Parent 标签）
+	 * @return 包依赖了纹理或缺少 Parent 标签，需要加载材质时返回 false
+	 */
+	static bool TryMakeEntryFromRegistry(const IAssetRegistry& AssetRegistry, const FAssetData& AssetData, const FIoHash& PackageSavedHash, FEntry& OutEntry);
+
+	/** 从已加载的材质建立条目 */
+	static FEntry MakeEntry(const UMaterialInterface* Material, const FIoHash& PackageSavedHash);
+
+	/** 条目存在且保存哈希一致 */
+	bool IsUpToDate(FName PackageName, const FIoHash& PackageSavedHash) const;
+
+	const FEntry* FindEntry(FName PackageName) const { return Entries.Find(PackageName); }
+
+	void SetEntry(FName PackageName, FEntry&& Entry);
+
+	/** 移除条目，例如包已修改、等待重新读取时 */
+	void RemoveEntry(FName PackageName);
+
+	/**
+	 * 解析材质的有效纹理绑定：沿父材质链合并覆盖值，按参数名排序
+	 * 父材质不在索引中时只返回已知部分
+	 * @return 材质本身不在索引中时返回 false
+	 */
+	bool ResolveBindings(FName PackageName, TArray<FMaterialTextureBinding>& OutBindings) const;
+
+	int32 Num() const { return Entries.Num(); }
+
+	/** 移除已删除或重命名的包的条目后，有修改时写回磁盘 */
+	bool Save();
+
+	static FString GetCacheFilename();
+
+private:
+	FMaterialTextureIndex() = default;
+
+	bool Load();
+	void PruneMissingPackages();
+	bool ResolveBindingsRecursive(FName PackageName, int32 Depth, TArray<FMaterialTextureBinding>& OutBindings) const;
+
+	TMap<FName, FEntry> Entries;
+	bool bDirty = false;
+
+	static FMaterialTextureIndex* Instance;
+};
@@ -0,0 +1,49 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Types/UnusedAssetTypes.h"
+
+class FAssetReferenceGraph;
+
+/**
+ * 未使用资源扫描的公共逻辑
+ * 同步的 FindUnused*InFolder 和异步的 UFindUnusedAssetsAsyncAction 共用同一套候选收集和引用判断，
+ * 引用判断基于 FAssetReferenceGraph 快照，多个资源类别可以在一次遍历中完成
+ */
+class EDITORTOOLS_API FUnusedAssetScanner
+{
+public:
+	/** 资源类别在消息日志中的显示名称（如"模型"、"材质"、"贴图"），多个类别时为"资源" */
+	static FString GetCategoryDisplayName(EUnusedAssetCategory Category);
+	static FString GetCategoryDisplayName(TConstArrayView<EUnusedAssetCategory> Categories);
+
+	/**
+	 * 解析要检查的文件夹：FolderPaths 为空时使用内容浏览器中选中的文件夹
+	 * 两者都为空时写入警告并打开消息日志，返回 false
+	 * @param DisplayName 警告中显示的资源类别名称
+	 */
+	static bool ResolveFolderPaths(const FString& DisplayName, const TArray<FString>& FolderPaths, TArray<FString>& OutFolderPaths);
+
+	/** 从资产注册表收集文件夹（递归）内属于任一类别的资源，只读取注册表数据不加载资源 */
+	static void CollectCandidates(TConstArrayView<EUnusedAssetCategory> Categories, const TArray<FString>& FolderPaths, TArray<FAssetData>& OutCandidates);
+
+	/**
+	 * 资源包是否被项目内（/Game/）的其他包引用（同一文件夹内的引用也算作使用）
+	 * 引用图快照只读，可以在工作线程调用
+	 */
+	static bool IsReferencedByProject(const FAssetReferenceGraph& Graph, FName PackageName);
+
+	/**
+	 * 根据注册表数据生成结果条目（软引用路径 + 标签），不会加载资源
+	 * AssetObject 只在资源已在内存中时填充
+	 */
+	static FUnusedAssetInfo MakeUnusedAssetInfo(const FAssetData& AssetData);
+
+	/** 同步检查并输出消息日志报告 */
+	static TArray<FUnusedAssetInfo> FindUnusedAssets(EUnusedAssetCategory Category, const TArray<FString>& FolderPaths);
+
+	/** 同步检查多个类别（一次收集、一次引用判断），输出合并的消息日志报告 */
+	static TArray<FUnusedAssetInfo> FindUnusedAssets(TConstArrayView<EUnusedAssetCategory> Categories, const TArray<FString>& FolderPaths);
+};
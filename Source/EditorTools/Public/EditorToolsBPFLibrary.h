@@ -11,11 +11,14 @@
 #include "Engine/StaticMeshActor.h"
 #include "Materials/MaterialInstanceConstant.h"
 #include "Types/MaterialComplexityTypes.h"
+#include "Types/MaterialInstanceBatchTypes.h"
+#include "Types/DuplicateMaterialInstanceTypes.h"
 #include "Types/LightingBuildTypes.h"
 #include "Types/MeshComplexityTypes.h"
 #include "Types/DrawCallTypes.h"
 #include "Types/LightInfoTypes.h"
 #include "Types/UnusedAssetTypes.h"
+#include "Types/ActorFilterTypes.h"
 #include "Types/TextureSizeTypes.h"
 
 #include "EditorToolsBPFLibrary.generated.h"
@@ -37,6 +40,11 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material")
 	static UMaterialInstanceConstant* CreateMaterialInstanceFromBase(UMaterialInterface* BaseMaterial, const FString& SavePath);
 
+	//批量创建材质实例：全部创建并设置纹理参数后，一次并发保存所有包（同路径已有的材质实例会被复用并更新）
+	//返回数组与 Rows 一一对应，失败的行为空
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material")
+	static TArray<UMaterialInstanceConstant*> CreateMaterialInstancesBatch(const TArray<FMaterialInstanceBatchRow>& Rows, bool bSavePackages = true);
+
 	//设置材质实例的纹理参数
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material")
 	static void SetMICTexture(UMaterialInterface* MaterialInterface, FName ParamName, UTexture* NewTexture);
@@ -74,6 +82,7 @@ public:
 	// ==================== 纹理资源 ====================
 	
 	//从路径和文件名加载纹理资源
+	//批量加载时请使用 LoadTexturesFromPathsAsync，避免逐个同步加载卡住编辑器
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Texture")
 	static UTexture* LoadTextureFromPath(const FString& AssetPath, const FString& AssetName);
 
@@ -109,6 +118,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Static Mesh")
 	static void DisableShadowCastingForSelectedStaticMeshActors();
 
+	// 关闭符合筛选条件（类、网格体、距离、包围盒、选中状态）的静态网格体Actor的碰撞
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Static Mesh", meta = (WorldContext = "WorldContextObject"))
+	static void DisableCollisionForFilteredStaticMeshActors(UObject* WorldContextObject, const FEditorToolsActorFilter& Filter);
+
+	// 关闭符合筛选条件（类、网格体、距离、包围盒、选中状态）的静态网格体Actor的投射阴影
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Static Mesh", meta = (WorldContext = "WorldContextObject"))
+	static void DisableShadowCastingForFilteredStaticMeshActors(UObject* WorldContextObject, const FEditorToolsActorFilter& Filter);
+
 	// ==================== 光照构建 ====================
 	
 	//获取场景中所有需要重新构建光照的Actor（可选在屏幕上用红色显示）
@@ -137,6 +154,11 @@ public:
 	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Unused Assets")
 	static TArray<FUnusedAssetInfo> FindUnusedTexturesInFolder(const TArray<FString>& FolderPaths);
+	
+	//一次遍历检查指定文件夹内未使用的模型、材质和贴图（共用同一份引用图快照）
+	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Unused Assets")
+	static TArray<FUnusedAssetInfo> FindUnusedAssetsInFolders(const TArray<FString>& FolderPaths);
 
 	// ==================== 贴图大小检查功能 ====================
 	
@@ -145,11 +167,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Texture Size")
 	static TArray<FTextureSizeInfo> CheckTextureSizesInFolders(const TArray<FString>& FolderPaths);
 
+	// ==================== 材质复杂度分析 ====================
+
+	//检查指定文件夹内材质的着色器复杂度（按像素着色器指令数从高到低排序，结果按着色器图缓存）
+	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material Complexity")
+	static TArray<FMaterialComplexityInfo> GetMaterialComplexityInFolders(const TArray<FString>& FolderPaths);
+
+	//获取场景中网格体组件使用的全部材质的着色器复杂度（按像素着色器指令数从高到低排序，附带使用次数）
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Material Complexity", meta = (WorldContext = "WorldContextObject"))
+	static TArray<FMaterialComplexityInfo> GetMaterialComplexityInScene(UObject* WorldContextObject);
+
+	// ==================== 重复材质实例 ====================
+
+	//查找指定文件夹内父材质和全部参数覆盖完全相同的材质实例（按重复数量从多到少排序）
+	//如果FolderPaths为空，则从内容浏览器获取选中的文件夹
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Duplicate Material Instances")
+	static TArray<FDuplicateMaterialInstanceGroup> FindDuplicateMaterialInstancesInFolders(const TArray<FString>& FolderPaths);
+
+	//把每组的重复实例合并到保留实例（替换全部引用并删除重复实例），返回成功合并的数量
+	//修改过的包需要手动保存
+	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Duplicate Material Instances")
+	static int32 ConsolidateDuplicateMaterialInstances(const TArray<FDuplicateMaterialInstanceGroup>& Groups);
+
 	// ==================== Draw Call 分析 ====================
 
 	// 获取当前视野内（根据最近渲染时间阈值）的Actor DrawCall概览
+	// Ablation（默认）：逐Actor隐藏对比（精确但每个Actor需要两帧）；SceneProxyBatches：渲染线程单帧遍历场景代理统计网格批次，需要时显式选择
 	UFUNCTION(BlueprintCallable, Category = "Editor Tools BP Library|Draw Call", meta = (WorldContext = "WorldContextObject"))
-	static TArray<FActorDrawCallInfo> GetVisibleActorsDrawCallStats(UObject* WorldContextObject);
+	static TArray<FActorDrawCallInfo> GetVisibleActorsDrawCallStats(UObject* WorldContextObject, EDrawCallStatsMode Mode = EDrawCallStatsMode::Ablation);
 
 	
 	
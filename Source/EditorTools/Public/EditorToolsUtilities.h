@@ -26,6 +26,18 @@ public:
 	 * Note: Caller is responsible for normalizing the returned path if needed.
 	 */
 	static bool ResolveContentBrowserFolder(const FString& InputFolderPath, FString& OutFolderPath, const FText& NoSelectionDialogText);
+
+	/**
+	 * Convert a Content Browser folder path (e.g. "/All/Game/Foo", "Game/Foo" or "Foo") into a registry search path ("/Game/Foo/").
+	 * Surrounding whitespace and quotes are stripped and the result always ends with a slash.
+	 */
+	static FString NormalizeFolderPath(const FString& FolderPath);
+
+	/**
+	 * Build an object path ("/Game/Foo/T_Bar.T_Bar") from a folder path and an asset name.
+	 * The folder goes through NormalizeFolderPath and a file extension on the asset name is dropped.
+	 */
+	static FString MakeAssetObjectPath(const FString& FolderPath, const FString& AssetName);
 #if WITH_EDITOR
 	/**
 	 * Retrieve the default EditorTools message log listing, optionally clearing previous messages.
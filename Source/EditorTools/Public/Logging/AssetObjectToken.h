@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "Logging/TokenizedMessage.h"
 #include "UObject/UObjectGlobals.h"
+#include "UObject/SoftObjectPath.h"
 
 /**
  * 自定义消息日志 Token，用于在内容浏览器中定位资产，不自动显示放大镜图标
@@ -18,12 +19,21 @@ public:
 	 */
 	static TSharedRef<FAssetObjectToken> Create(UObject* Object, const FText& DisplayText);
 
+	/**
+	 * 创建一个通过软引用路径定位资产的 Token，创建和点击时都不会加载资产
+	 * @param AssetPath 资产的软引用路径
+	 * @param DisplayText 显示的文本（已处理对齐/截断）
+	 */
+	static TSharedRef<FAssetObjectToken> Create(const FSoftObjectPath& AssetPath, const FText& DisplayText);
+
 	// IMessageToken interface
 	virtual EMessageToken::Type GetType() const override { return EMessageToken::Text; }
 
 private:
 	FAssetObjectToken(UObject* InObject, const FText& InDisplayText);
+	FAssetObjectToken(const FSoftObjectPath& InAssetPath, const FText& InDisplayText);
 
 	TWeakObjectPtr<UObject> Object;
+	FSoftObjectPath AssetPath;
 };
 
@@ -0,0 +1,60 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Engine/StaticMesh.h"
+#include "ActorFilterTypes.generated.h"
+
+/**
+ * 场景Actor筛选条件（所有启用的条件同时满足才算匹配）
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLS_API FEditorToolsActorFilter
+{
+	GENERATED_BODY()
+
+	// 只匹配该类（及其子类）的Actor，为空时不限制
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter")
+	TSubclassOf<AActor> ActorClass;
+
+	// 只匹配使用该静态网格体的Actor，为空时不限制
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter")
+	UStaticMesh* StaticMesh;
+
+	// 是否按到 DistanceOrigin 的距离筛选
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter")
+	bool bUseDistance;
+
+	// 距离筛选的中心点
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter", meta = (EditCondition = "bUseDistance"))
+	FVector DistanceOrigin;
+
+	// 最大距离（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter", meta = (EditCondition = "bUseDistance"))
+	float MaxDistance;
+
+	// 是否只匹配位于 Bounds 内的Actor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter")
+	bool bUseBounds;
+
+	// 包围盒（世界空间，按Actor位置判断）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter", meta = (EditCondition = "bUseBounds"))
+	FBox Bounds;
+
+	// 是否只匹配当前选中的Actor
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Actor Filter")
+	bool bSelectedOnly;
+
+	FEditorToolsActorFilter()
+		: ActorClass(nullptr)
+		, StaticMesh(nullptr)
+		, bUseDistance(false)
+		, DistanceOrigin(FVector::ZeroVector)
+		, MaxDistance(0.f)
+		, bUseBounds(false)
+		, Bounds(ForceInit)
+		, bSelectedOnly(false)
+	{
+	}
+};
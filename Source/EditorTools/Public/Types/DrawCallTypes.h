@@ -5,6 +5,16 @@
 #include "GameFramework/Actor.h"
 #include "DrawCallTypes.generated.h"
 
+/**
+ * DrawCall统计方式枚举
+ */
+UENUM(BlueprintType)
+enum class EDrawCallStatsMode : uint8
+{
+	SceneProxyBatches UMETA(DisplayName = "Scene Proxy Batches"),	// 渲染线程一次性遍历场景代理统计网格批次（单帧）
+	Ablation UMETA(DisplayName = "Ablation")						// 逐Actor隐藏/显示并对比 GNumDrawCallsRHI（每个Actor两帧）
+};
+
 /**
  * Actor DrawCall信息结构体
  */
@@ -0,0 +1,23 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "DuplicateMaterialInstanceTypes.generated.h"
+
+/**
+ * 一组父材质和全部参数覆盖完全相同的材质实例
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLS_API FDuplicateMaterialInstanceGroup
+{
+	GENERATED_BODY()
+
+	// 合并时保留的材质实例（组内被引用最多的一个）
+	UPROPERTY(BlueprintReadOnly, Category = "Duplicate Material Instance")
+	FSoftObjectPath KeptInstance;
+
+	// 可以替换为 KeptInstance 的重复实例
+	UPROPERTY(BlueprintReadOnly, Category = "Duplicate Material Instance")
+	TArray<FSoftObjectPath> Duplicates;
+};
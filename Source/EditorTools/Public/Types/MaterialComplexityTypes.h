@@ -2,6 +2,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Materials/MaterialInterface.h"
 #include "MaterialComplexityTypes.generated.h"
 
 /**
@@ -13,6 +14,22 @@ struct EDITORTOOLS_API FMaterialComplexityInfo
 {
 	GENERATED_BODY()
 
+	// 材质对象引用
+	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
+	UMaterialInterface* Material;
+
+	// 材质名称
+	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
+	FString MaterialName;
+
+	// 材质所在的包路径
+	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
+	FString MaterialPath;
+
+	// 是否取到了已编译着色器的指令统计（不支持的材质域或编译失败时为 false，指令数为 0）
+	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
+	bool bHasShaderStats;
+
 	// 顶点着色器指令数（估算值）
 	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
 	int32 VertexShaderInstructionCount;
@@ -45,9 +62,17 @@ struct EDITORTOOLS_API FMaterialComplexityInfo
 	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
 	bool bIsTwoSided;
 
+	// 场景中使用该材质的组件数量（文件夹扫描时为 0）
+	UPROPERTY(BlueprintReadOnly, Category = "Material Complexity")
+	int32 UsageCount;
+
 	// 构造函数 - 初始化默认值
 	FMaterialComplexityInfo()
-		: VertexShaderInstructionCount(0)
+		: Material(nullptr)
+		, MaterialName(TEXT(""))
+		, MaterialPath(TEXT(""))
+		, bHasShaderStats(false)
+		, VertexShaderInstructionCount(0)
 		, PixelShaderInstructionCount(0)
 		, TextureSampleCount(0)
 		, bUsesWorldPositionOffset(false)
@@ -55,6 +80,7 @@ struct EDITORTOOLS_API FMaterialComplexityInfo
 		, BlendMode(TEXT("Opaque"))
 		, ShadingModel(TEXT("DefaultLit"))
 		, bIsTwoSided(false)
+		, UsageCount(0)
 	{
 	}
 };
@@ -0,0 +1,34 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Materials/MaterialInterface.h"
+#include "Engine/Texture.h"
+#include "MaterialInstanceBatchTypes.generated.h"
+
+/**
+ * 批量创建材质实例的一行：父材质、保存路径和纹理参数覆盖
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLS_API FMaterialInstanceBatchRow
+{
+	GENERATED_BODY()
+
+	// 父材质（材质或材质实例）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Instance Batch")
+	UMaterialInterface* Parent;
+
+	// 保存路径，格式与 CreateMaterialInstanceFromBase 相同（如 /Game/Materials/MI_Rock）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Instance Batch")
+	FString SavePath;
+
+	// 纹理参数覆盖（参数名 -> 纹理）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Material Instance Batch")
+	TMap<FName, UTexture*> TextureParameters;
+
+	FMaterialInstanceBatchRow()
+		: Parent(nullptr)
+		, SavePath(TEXT(""))
+	{
+	}
+};
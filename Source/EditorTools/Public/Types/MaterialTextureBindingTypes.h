@@ -0,0 +1,51 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "MaterialTextureBindingTypes.generated.h"
+
+/**
+ * 材质的一个纹理参数及其当前生效的纹理
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLS_API FMaterialTextureBinding
+{
+	GENERATED_BODY()
+
+	// 纹理参数名称
+	UPROPERTY(BlueprintReadOnly, Category = "Material Texture Binding")
+	FName ParameterName;
+
+	// 纹理软引用路径（不会触发加载）
+	UPROPERTY(BlueprintReadOnly, Category = "Material Texture Binding")
+	FSoftObjectPath Texture;
+
+	FMaterialTextureBinding()
+		: ParameterName(NAME_None)
+	{
+	}
+
+	FMaterialTextureBinding(FName InParameterName, const FSoftObjectPath& InTexture)
+		: ParameterName(InParameterName)
+		, Texture(InTexture)
+	{
+	}
+};
+
+/**
+ * 单个材质（或材质实例）的全部纹理参数绑定，材质实例已合并父材质链上的值
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLS_API FMaterialTextureBindings
+{
+	GENERATED_BODY()
+
+	// 材质软引用路径
+	UPROPERTY(BlueprintReadOnly, Category = "Material Texture Binding")
+	FSoftObjectPath Material;
+
+	// 纹理参数绑定（按参数名排序）
+	UPROPERTY(BlueprintReadOnly, Category = "Material Texture Binding")
+	TArray<FMaterialTextureBinding> Bindings;
+};
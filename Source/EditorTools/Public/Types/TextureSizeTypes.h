@@ -29,7 +29,11 @@ struct EDITORTOOLS_API FTextureSizeInfo
 	UPROPERTY(BlueprintReadOnly, Category = "Texture Size Info")
 	int32 Height;
 
-	// 贴图对象引用（如果已加载）
+	// 贴图软引用路径（不会触发加载）
+	UPROPERTY(BlueprintReadOnly, Category = "Texture Size Info")
+	FSoftObjectPath TextureSoftPath;
+
+	// 贴图对象引用（仅当贴图已在内存中或注册表缺少尺寸标签而回退加载时有效）
 	UPROPERTY(BlueprintReadOnly, Category = "Texture Size Info")
 	UTexture2D* TextureObject;
 
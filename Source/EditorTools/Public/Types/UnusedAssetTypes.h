@@ -8,6 +8,17 @@
 #include "Engine/Texture2D.h"
 #include "UnusedAssetTypes.generated.h"
 
+/**
+ * 未使用资源检查的资源类别
+ */
+UENUM(BlueprintType)
+enum class EUnusedAssetCategory : uint8
+{
+	Mesh UMETA(DisplayName = "Mesh"),			// 静态网格体和骨骼网格体
+	Material UMETA(DisplayName = "Material"),	// 材质、材质实例、材质函数等
+	Texture UMETA(DisplayName = "Texture")		// 贴图
+};
+
 /**
  * 未使用的资源信息结构体
  */
@@ -28,7 +39,15 @@ struct EDITORTOOLS_API FUnusedAssetInfo
 	UPROPERTY(BlueprintReadOnly, Category = "Unused Asset Info")
 	FString AssetType;
 
-	// 资源对象引用（如果已加载）
+	// 资源软引用路径（不会触发加载，需要时再解析）
+	UPROPERTY(BlueprintReadOnly, Category = "Unused Asset Info")
+	FSoftObjectPath AssetSoftPath;
+
+	// 资产注册表标签数据（如贴图的 Dimensions、网格体的 Triangles）
+	UPROPERTY(BlueprintReadOnly, Category = "Unused Asset Info")
+	TMap<FName, FString> AssetTags;
+
+	// 资源对象引用（仅当扫描时资源已在内存中才有效，扫描不会为此加载资源）
 	UPROPERTY(BlueprintReadOnly, Category = "Unused Asset Info")
 	UObject* AssetObject;
 
@@ -0,0 +1,154 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsBenchmark.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsComputeShader.h"
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsSIMDStep.h"
+#include "Boids/BoidsSyntheticScenario.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+
+namespace BoidsBenchmark
+{
+	FCPUResult RunCPU(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params, ECPUKernel Kernel, int32 NumSteps, TArray<FBoidTableData>& OutBoids)
+	{
+		FBoidsCellListBuilder CellListBuilder;
+		FBoidsCellList Cells;
+		FBoidsSIMDStep SIMDStep;
+
+		TArray<FBoidTableData> Boids = Scenario.Boids;
+		TArray<FBoidTableData> NextBoids;
+		NextBoids.SetNumUninitialized(Boids.Num());
+
+		auto RunStep = [&](int32 StepIndex)
+		{
+			const uint32 ShuffleSeed = Params.bFullNeighbourEvaluation ? 0u : (uint32)StepIndex;
+			CellListBuilder.Build(Boids, Params.CellSize, ShuffleSeed, Cells);
+			if (Kernel == ECPUKernel::SIMD)
+			{
+				SIMDStep.Step(Params, Boids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, NextBoids);
+			}
+			else
+			{
+				FBoidsReferenceStep::Step(Params, Boids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, NextBoids);
+			}
+			Swap(Boids, NextBoids);
+		};
+
+		// 预热：中间缓冲区在第一步分配
+		RunStep(0);
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 StepIndex = 1; StepIndex <= NumSteps; ++StepIndex)
+		{
+			RunStep(StepIndex);
+		}
+		const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		FCPUResult Result;
+		Result.MsPerStep = ElapsedMs / FMath::Max(NumSteps, 1);
+		Result.AllocatedBytes = Boids.GetAllocatedSize() + NextBoids.GetAllocatedSize()
+			+ Cells.GetAllocatedSize() + CellListBuilder.GetAllocatedSize() + SIMDStep.GetAllocatedSize()
+			+ Scenario.Volumes.GetAllocatedSize() + Scenario.VolumeGrid.GetAllocatedSize()
+			+ Scenario.Groups.GetAllocatedSize() + sizeof(FBoidsGroupResponseMatrix);
+
+		OutBoids = MoveTemp(Boids);
+		return Result;
+	}
+
+	double RunGPU(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params, int32 NumSteps)
+	{
+		double ElapsedMs = 0.0;
+		ENQUEUE_RENDER_COMMAND(BenchmarkBoidsGPU)(
+			[&Scenario, &Params, &ElapsedMs, NumSteps](FRHICommandListImmediate& RHICmdList)
+			{
+				const int32 NumBoids = Scenario.Boids.Num();
+
+				// 先等之前的工作完成，计时只包含本次提交的步骤
+				RHICmdList.SubmitCommandsAndFlushGPU();
+				RHICmdList.BlockUntilGPUIdle();
+
+				const double StartTime = FPlatformTime::Seconds();
+				{
+					FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("BoidsBenchmark"));
+					FRDGBufferRef Boids = CreateStructuredBuffer(GraphBuilder, TEXT("Boids.BoidData"), sizeof(FBoidTableData), NumBoids, Scenario.Boids.GetData(), NumBoids * sizeof(FBoidTableData), ERDGInitialDataFlags::NoCopy);
+					for (int32 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+					{
+						FRDGBufferRef NextBoids = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(FBoidTableData), NumBoids), TEXT("Boids.OutBoidData"));
+						const uint32 ShuffleSeed = Params.bFullNeighbourEvaluation ? 0u : (uint32)StepIndex;
+						AddBoidsStepPasses(GraphBuilder, Boids, NextBoids, NumBoids, Params, ShuffleSeed, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses);
+						Boids = NextBoids;
+					}
+					GraphBuilder.Execute();
+				}
+				RHICmdList.SubmitCommandsAndFlushGPU();
+				RHICmdList.BlockUntilGPUIdle();
+
+				ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0 / FMath::Max(NumSteps, 1);
+			});
+		FlushRenderingCommands();
+		return ElapsedMs;
+	}
+
+	SIZE_T GetGPUMemoryFootprint(const FBoidsSyntheticScenario& Scenario)
+	{
+		const SIZE_T NumBoids = Scenario.Boids.Num();
+
+		// 与 AddBuildCellListPasses 相同：排序键补齐到 2 的幂，至少一个双调排序块
+		const SIZE_T PaddedBoidCount = FMath::Max<SIZE_T>(FMath::RoundUpToPowerOfTwo64(NumBoids), BoidsShader::ThreadGroupSize * 2);
+
+		return NumBoids * sizeof(FBoidTableData) * 2
+			+ PaddedBoidCount * sizeof(uint32) * 2
+			+ NumBoids * sizeof(uint32)
+			+ BoidsShader::TotalCells * sizeof(uint32) * 2
+			+ Scenario.VolumeGrid.CellRanges.Num() * sizeof(FUintVector2)
+			+ Scenario.VolumeGrid.VolumeIndices.Num() * sizeof(uint32)
+			+ Scenario.Volumes.Num() * sizeof(FVolumeTableData)
+			+ Scenario.Groups.Num() * sizeof(FGroupTableData)
+			+ sizeof(FBoidsGroupResponseMatrix);
+	}
+
+	double CountNeighbourChecksPerBoid(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params)
+	{
+		const int32 NumBoids = Scenario.Boids.Num();
+		if (NumBoids == 0)
+		{
+			return 0.0;
+		}
+
+		FBoidsCellList Cells;
+		Cells.Build(Scenario.Boids, Params.CellSize, 0);
+
+		const uint32 NeighbourCheckLimit = Params.GetNeighbourCheckLimit();
+		TArray<uint32> Checks;
+		Checks.SetNumUninitialized(NumBoids);
+		ParallelFor(NumBoids, [&](int32 BoidIndex)
+		{
+			const FIntVector CellIndex = BoidsShader::GetCellVector(Scenario.Boids[BoidIndex].Position, Params.CellSize);
+			uint32 Count = 0;
+			for (int32 I = -1; I <= 1; ++I)
+			{
+				for (int32 J = -1; J <= 1; ++J)
+				{
+					for (int32 K = -1; K <= 1; ++K)
+					{
+						const uint32 FlatNeighbourIndex = BoidsShader::GetFlatCellIndex(CellIndex + FIntVector(I, J, K));
+						Count += FMath::Min(Cells.CellBoidCount[FlatNeighbourIndex], NeighbourCheckLimit);
+					}
+				}
+			}
+			Checks[BoidIndex] = Count;
+		});
+
+		uint64 Total = 0;
+		for (const uint32 Count : Checks)
+		{
+			Total += Count;
+		}
+		return (double)Total / NumBoids;
+	}
+}
@@ -0,0 +1,43 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+
+struct FBoidsSyntheticScenario;
+
+/**
+ * 基准测试共用的模拟驱动（EditorTools.Boids.BenchmarkNeighbourModes 和 UBoidsBenchmarkCommandlet 使用）
+ */
+namespace BoidsBenchmark
+{
+	enum class ECPUKernel : uint8
+	{
+		Reference,
+		SIMD,
+	};
+
+	struct FCPUResult
+	{
+		/** 平均每步耗时（毫秒，含单元表构建） */
+		double MsPerStep = 0.0;
+
+		/** 鱼群双缓冲、单元表、构建器和内核中间数据、体积与分组表占用的内存 */
+		SIZE_T AllocatedBytes = 0;
+	};
+
+	/** 在 CPU 上连续模拟若干步，先跑一步预热（不计时），最终状态写入 OutBoids */
+	FCPUResult RunCPU(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params, ECPUKernel Kernel, int32 NumSteps, TArray<FBoidTableData>& OutBoids);
+
+	/**
+	 * 在 GPU 上连续模拟若干步，开始前和结束后都等待 GPU 空闲
+	 * @return 平均每步耗时（毫秒，含上传和单元表构建，不含回读）
+	 */
+	double RunGPU(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params, int32 NumSteps);
+
+	/** GPU 路径的显存占用：双缓冲鱼群状态、排序键、单元表、体积网格、体积与分组表 */
+	SIZE_T GetGPUMemoryFootprint(const FBoidsSyntheticScenario& Scenario);
+
+	/** 每条鱼平均检查的邻居数，按内核的 27 个单元遍历和 MaxNeighbourChecks 截断统计 */
+	double CountNeighbourChecksPerBoid(const FBoidsSyntheticScenario& Scenario, const FBoidsStepParams& Params);
+}
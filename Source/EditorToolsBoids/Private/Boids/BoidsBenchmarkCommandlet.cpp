@@ -0,0 +1,157 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsBenchmarkCommandlet.h"
+#include "Boids/BoidsBenchmark.h"
+#include "Boids/BoidsSimulation.h"
+#include "Boids/BoidsSyntheticScenario.h"
+#include "EditorToolsBoids.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RHI.h"
+
+namespace
+{
+	/** CSV 字段：含逗号或引号时加引号 */
+	static FString CsvField(const FString& Value)
+	{
+		if (Value.Contains(TEXT(",")) || Value.Contains(TEXT("\"")))
+		{
+			return FString::Printf(TEXT("\"%s\""), *Value.Replace(TEXT("\""), TEXT("\"\"")));
+		}
+		return Value;
+	}
+
+	struct FBenchmarkRow
+	{
+		FString Kernel;
+		int32 NumBoids = 0;
+		double MsPerStep = 0.0;
+		double NeighbourChecksPerBoid = 0.0;
+		SIZE_T MemoryBytes = 0;
+	};
+}
+
+UBoidsBenchmarkCommandlet::UBoidsBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("用合成鱼群测试鱼群模拟的吞吐量并输出 CSV");
+	HelpUsage = TEXT("-run=BoidsBenchmark [-Steps=10] [-MinBoids=1000] [-MaxBoids=1000000] [-Multiplier=10] [-Groups=2] [-Volumes=2] [-Density=8] [-Kernels=Reference,SIMD,GPU] [-FullNeighbours] [-Output=<csv>]");
+}
+
+int32 UBoidsBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumSteps = 10;
+	int32 MinBoids = 1000;
+	int32 MaxBoids = 1000000;
+	int32 Multiplier = 10;
+	int32 NumGroups = 2;
+	int32 NumVolumes = 2;
+	float Density = 8.f;
+	FString KernelList = TEXT("Reference,SIMD,GPU");
+	FString OutputPath = FPaths::Combine(FPaths::ProfilingDir(), TEXT("BoidsBenchmark.csv"));
+
+	FParse::Value(*Params, TEXT("Steps="), NumSteps);
+	FParse::Value(*Params, TEXT("MinBoids="), MinBoids);
+	FParse::Value(*Params, TEXT("MaxBoids="), MaxBoids);
+	FParse::Value(*Params, TEXT("Multiplier="), Multiplier);
+	FParse::Value(*Params, TEXT("Groups="), NumGroups);
+	FParse::Value(*Params, TEXT("Volumes="), NumVolumes);
+	FParse::Value(*Params, TEXT("Density="), Density);
+	FParse::Value(*Params, TEXT("Kernels="), KernelList);
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+	const bool bFullNeighbours = FParse::Param(*Params, TEXT("FullNeighbours"));
+
+	NumSteps = FMath::Max(NumSteps, 1);
+	MinBoids = FMath::Max(MinBoids, 1);
+	MaxBoids = FMath::Max(MaxBoids, MinBoids);
+	Multiplier = FMath::Max(Multiplier, 2);
+
+	TArray<FString> Kernels;
+	KernelList.ParseIntoArray(Kernels, TEXT(","));
+	const bool bRunReference = Kernels.Contains(TEXT("Reference"));
+	const bool bRunSIMD = Kernels.Contains(TEXT("SIMD"));
+	bool bRunGPU = Kernels.Contains(TEXT("GPU"));
+	if (bRunGPU && !FBoidsSimulation::CanUseGPU())
+	{
+		UE_LOG(LogEditorToolsBoids, Display, TEXT("当前 RHI 不支持鱼群计算着色器（例如 -nullrhi），跳过 GPU 测试"));
+		bRunGPU = false;
+	}
+
+	const FString CPUBrand = FPlatformMisc::GetCPUBrand().TrimStartAndEnd();
+	const FString GPUAdapter = bRunGPU ? GRHIAdapterName : TEXT("None");
+	const FString BuildConfiguration = LexToString(FApp::GetBuildConfiguration());
+
+	TArray<FBenchmarkRow> Rows;
+	for (int64 NumBoids = MinBoids; NumBoids <= MaxBoids; NumBoids *= Multiplier)
+	{
+		const FBoidsSyntheticScenario Scenario = FBoidsSyntheticScenario::Make((int32)NumBoids, Density, NumGroups, NumVolumes);
+		FBoidsStepParams StepParams = Scenario.Params;
+		StepParams.bFullNeighbourEvaluation = bFullNeighbours;
+
+		// 邻居数与内核无关，只统计一次
+		const double NeighbourChecks = BoidsBenchmark::CountNeighbourChecksPerBoid(Scenario, StepParams);
+
+		auto AddRow = [&](const TCHAR* Kernel, double MsPerStep, SIZE_T MemoryBytes)
+		{
+			FBenchmarkRow& Row = Rows.AddDefaulted_GetRef();
+			Row.Kernel = Kernel;
+			Row.NumBoids = (int32)NumBoids;
+			Row.MsPerStep = MsPerStep;
+			Row.NeighbourChecksPerBoid = NeighbourChecks;
+			Row.MemoryBytes = MemoryBytes;
+
+			UE_LOG(LogEditorToolsBoids, Display, TEXT("%-9s %8d 条鱼：%.3f ms/步，%.2f ns/鱼/步，%.1f 次邻居检查/鱼，%.2f MB"),
+				Kernel, Row.NumBoids, MsPerStep, MsPerStep * 1.0e6 / NumBoids, NeighbourChecks, MemoryBytes / (1024.0 * 1024.0));
+		};
+
+		TArray<FBoidTableData> ResultBoids;
+		if (bRunReference)
+		{
+			const BoidsBenchmark::FCPUResult Result = BoidsBenchmark::RunCPU(Scenario, StepParams, BoidsBenchmark::ECPUKernel::Reference, NumSteps, ResultBoids);
+			AddRow(TEXT("Reference"), Result.MsPerStep, Result.AllocatedBytes);
+		}
+		if (bRunSIMD)
+		{
+			const BoidsBenchmark::FCPUResult Result = BoidsBenchmark::RunCPU(Scenario, StepParams, BoidsBenchmark::ECPUKernel::SIMD, NumSteps, ResultBoids);
+			AddRow(TEXT("SIMD"), Result.MsPerStep, Result.AllocatedBytes);
+		}
+		if (bRunGPU)
+		{
+			// 预热一步，着色器编译和缓冲区分配不计入
+			BoidsBenchmark::RunGPU(Scenario, StepParams, 1);
+			AddRow(TEXT("GPU"), BoidsBenchmark::RunGPU(Scenario, StepParams, NumSteps), BoidsBenchmark::GetGPUMemoryFootprint(Scenario));
+		}
+
+		if (NumBoids > MAX_int32 / Multiplier)
+		{
+			break;
+		}
+	}
+
+	FString Csv = TEXT("Kernel,NumBoids,NumGroups,NumVolumes,Steps,FullNeighbours,MsPerStep,NsPerBoidStep,NeighbourChecksPerBoid,MemoryBytes,BytesPerBoid,BuildConfiguration,CPU,GPU\n");
+	for (const FBenchmarkRow& Row : Rows)
+	{
+		Csv += FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%.4f,%.3f,%.2f,%llu,%.1f,%s,%s,%s\n"),
+			*Row.Kernel, Row.NumBoids, NumGroups, NumVolumes, NumSteps, bFullNeighbours ? 1 : 0,
+			Row.MsPerStep, Row.MsPerStep * 1.0e6 / Row.NumBoids, Row.NeighbourChecksPerBoid,
+			(uint64)Row.MemoryBytes, (double)Row.MemoryBytes / Row.NumBoids,
+			*CsvField(BuildConfiguration), *CsvField(CPUBrand), *CsvField(GPUAdapter));
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogEditorToolsBoids, Error, TEXT("无法写入鱼群基准测试结果：%s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogEditorToolsBoids, Display, TEXT("鱼群基准测试结果已写入 %s"), *FPaths::ConvertRelativePathToFull(OutputPath));
+	return 0;
+}
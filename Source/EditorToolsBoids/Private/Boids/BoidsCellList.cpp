@@ -0,0 +1,113 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsCellList.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	// 每块至少这么多条鱼，块直方图本身要清零 TotalCells 个计数，块太小不划算
+	constexpr int32 MinBoidsPerChunk = 16384;
+
+	// 前缀和阶段每段的桶数量
+	constexpr int32 CellsPerBlock = 4096;
+	constexpr int32 NumCellBlocks = BoidsShader::TotalCells / CellsPerBlock;
+	static_assert(BoidsShader::TotalCells % CellsPerBlock == 0, "TotalCells 必须是 CellsPerBlock 的整数倍");
+
+	static EParallelForFlags GetParallelForFlags(int32 Num)
+	{
+		return Num > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+	}
+}
+
+void FBoidsCellList::Build(TConstArrayView<FBoidTableData> Boids, float CellSize, uint32 ShuffleSeed)
+{
+	FBoidsCellListBuilder Builder;
+	Builder.Build(Boids, CellSize, ShuffleSeed, *this);
+}
+
+void FBoidsCellListBuilder::Build(TConstArrayView<FBoidTableData> Boids, float CellSize, uint32 ShuffleSeed, FBoidsCellList& OutCells)
+{
+	const int32 NumBoids = Boids.Num();
+	const int32 MaxChunks = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+	const int32 NumChunks = FMath::Clamp(FMath::DivideAndRoundUp(NumBoids, MinBoidsPerChunk), 1, MaxChunks);
+	const int32 BoidsPerChunk = FMath::DivideAndRoundUp(FMath::Max(NumBoids, 1), NumChunks);
+
+	BoidCells.SetNumUninitialized(NumBoids);
+	ChunkCellCounts.SetNumUninitialized(NumChunks * BoidsShader::TotalCells);
+	CellBlockSums.SetNumUninitialized(NumCellBlocks);
+	OutCells.CellBoidCount.SetNumUninitialized(BoidsShader::TotalCells);
+	OutCells.CellOffsetList.SetNumUninitialized(BoidsShader::TotalCells);
+	OutCells.SortedCellList.SetNumUninitialized(NumBoids);
+
+	// 1. 每块的桶直方图
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		uint32* Counts = ChunkCellCounts.GetData() + ChunkIndex * BoidsShader::TotalCells;
+		FMemory::Memzero(Counts, BoidsShader::TotalCells * sizeof(uint32));
+
+		const int32 Begin = ChunkIndex * BoidsPerChunk;
+		const int32 End = FMath::Min(Begin + BoidsPerChunk, NumBoids);
+		for (int32 BoidIndex = Begin; BoidIndex < End; ++BoidIndex)
+		{
+			const uint32 Cell = BoidsShader::GetFlatCellIndex(BoidsShader::GetCellVector(Boids[BoidIndex].Position, CellSize));
+			BoidCells[BoidIndex] = Cell;
+			++Counts[Cell];
+		}
+	}, GetParallelForFlags(NumChunks));
+
+	// 2. 按桶段并行：块直方图改写为块在桶内的排他前缀，同时得到桶总数和每段的总数
+	ParallelFor(NumCellBlocks, [&](int32 BlockIndex)
+	{
+		uint32 BlockSum = 0;
+		const int32 CellBegin = BlockIndex * CellsPerBlock;
+		for (int32 Cell = CellBegin; Cell < CellBegin + CellsPerBlock; ++Cell)
+		{
+			uint32 CellCount = 0;
+			for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+			{
+				uint32& ChunkCount = ChunkCellCounts[ChunkIndex * BoidsShader::TotalCells + Cell];
+				const uint32 Count = ChunkCount;
+				ChunkCount = CellCount;
+				CellCount += Count;
+			}
+			OutCells.CellBoidCount[Cell] = CellCount;
+			BlockSum += CellCount;
+		}
+		CellBlockSums[BlockIndex] = BlockSum;
+	});
+
+	// 3. 段总数的排他前缀和（段数很少，串行即可），再按段并行写出桶起点
+	uint32 BlockOffset = 0;
+	for (int32 BlockIndex = 0; BlockIndex < NumCellBlocks; ++BlockIndex)
+	{
+		const uint32 BlockSum = CellBlockSums[BlockIndex];
+		CellBlockSums[BlockIndex] = BlockOffset;
+		BlockOffset += BlockSum;
+	}
+
+	ParallelFor(NumCellBlocks, [&](int32 BlockIndex)
+	{
+		uint32 Offset = CellBlockSums[BlockIndex];
+		const int32 CellBegin = BlockIndex * CellsPerBlock;
+		for (int32 Cell = CellBegin; Cell < CellBegin + CellsPerBlock; ++Cell)
+		{
+			OutCells.CellOffsetList[Cell] = Offset;
+			Offset += OutCells.CellBoidCount[Cell];
+		}
+	});
+
+	// 4. 各块并行散射：桶内排名为 N 的鱼放到 (N + ShuffleSeed) % Count 的位置
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		uint32* Cursors = ChunkCellCounts.GetData() + ChunkIndex * BoidsShader::TotalCells;
+
+		const int32 Begin = ChunkIndex * BoidsPerChunk;
+		const int32 End = FMath::Min(Begin + BoidsPerChunk, NumBoids);
+		for (int32 BoidIndex = Begin; BoidIndex < End; ++BoidIndex)
+		{
+			const uint32 Cell = BoidCells[BoidIndex];
+			const uint32 Slot = (Cursors[Cell]++ + ShuffleSeed) % OutCells.CellBoidCount[Cell];
+			OutCells.SortedCellList[OutCells.CellOffsetList[Cell] + Slot] = (uint32)BoidIndex;
+		}
+	}, GetParallelForFlags(NumChunks));
+}
@@ -0,0 +1,210 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsComputeShader.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+
+IMPLEMENT_GLOBAL_SHADER(FComputeFishShaderCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "MainComputeShader", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FComputeFishShaderTiledCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "MainComputeShaderTiled", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsHashCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "HashBoidsCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsBitonicSortLocalCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "BitonicSortLocalCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsBitonicMergeLocalCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "BitonicMergeLocalCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsBitonicMergeGlobalCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "BitonicMergeGlobalCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsFindCellStartsCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "FindCellStartsCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsCountCellsCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "CountCellsCS", SF_Compute);
+IMPLEMENT_GLOBAL_SHADER(FBoidsScatterCellsCS, "/Plugin/EditorTools/Private/ComputeFishShader.usf", "ScatterCellsCS", SF_Compute);
+
+bool FBoidsGlobalShader::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+{
+	return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::SM5);
+}
+
+void FBoidsGlobalShader::ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+{
+	FGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+
+	// 着色器里的常量全部来自 BoidsShaderTypes.h，保证两边布局一致
+	OutEnvironment.SetDefine(TEXT("MAX_VOLUMES"), BoidsShader::MaxVolumes);
+	OutEnvironment.SetDefine(TEXT("MAX_GROUPS"), BoidsShader::MaxGroups);
+	OutEnvironment.SetDefine(TEXT("GROUP_RESPONSE_BITS"), BoidsShader::GroupResponseBits);
+	OutEnvironment.SetDefine(TEXT("GROUP_RESPONSE_WORDS_PER_ROW"), BoidsShader::GroupResponseWordsPerRow);
+	OutEnvironment.SetDefine(TEXT("TOTAL_CELLS"), BoidsShader::TotalCells);
+	OutEnvironment.SetDefine(TEXT("THREADGROUPSIZE_X"), BoidsShader::ThreadGroupSize);
+	OutEnvironment.SetDefine(TEXT("THREADGROUPSIZE_Y"), 1);
+	OutEnvironment.SetDefine(TEXT("THREADGROUPSIZE_Z"), 1);
+	OutEnvironment.SetDefine(TEXT("NEIGHBOUR_TILE_SIZE"), BoidsShader::NeighbourTileSize);
+	OutEnvironment.SetDefine(TEXT("TILED_DISPATCH_WIDTH"), BoidsShader::TiledDispatchWidth);
+}
+
+namespace
+{
+	template <typename ElementType>
+	static FRDGBufferRef CreateStructuredUploadBuffer(FRDGBuilder& GraphBuilder, const TCHAR* Name, const TArray<ElementType>& Data)
+	{
+		// RDG 不允许空缓冲区，空表用一个清零的元素占位（着色器按数量参数访问，不会读到它）
+		if (Data.Num() == 0)
+		{
+			static const ElementType ZeroElement = {};
+			return CreateStructuredBuffer(GraphBuilder, Name, sizeof(ElementType), 1, &ZeroElement, sizeof(ElementType), ERDGInitialDataFlags::NoCopy);
+		}
+
+		// 输入在图执行完之前一直由渲染命令持有，所以不需要复制
+		return CreateStructuredBuffer(GraphBuilder, Name, sizeof(ElementType), Data.Num(), Data.GetData(), Data.Num() * sizeof(ElementType), ERDGInitialDataFlags::NoCopy);
+	}
+
+	// 双调排序在共享内存中处理的块大小，与着色器的 BITONIC_BLOCK_SIZE 一致
+	constexpr uint32 BitonicBlockSize = BoidsShader::ThreadGroupSize * 2;
+
+	template <typename ShaderType>
+	static void AddCellListPass(FRDGBuilder& GraphBuilder, FRDGEventName&& PassName, typename ShaderType::FParameters* Parameters, uint32 NumThreads)
+	{
+		TShaderMapRef<ShaderType> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+		FComputeShaderUtils::AddPass(GraphBuilder, MoveTemp(PassName), ComputeShader, Parameters, FIntVector(FMath::DivideAndRoundUp<uint32>(NumThreads, BoidsShader::ThreadGroupSize), 1, 1));
+	}
+}
+
+FBoidsCellListRDG AddBuildCellListPasses(FRDGBuilder& GraphBuilder, FRDGBufferRef BoidBuffer, int32 NumBoids, float CellSize, uint32 ShuffleSeed)
+{
+	check(NumBoids > 0);
+	RDG_EVENT_SCOPE(GraphBuilder, "BoidsBuildCellList %d", NumBoids);
+
+	// 补齐到 2 的幂（至少一个块），补齐的键排在最后
+	const uint32 PaddedBoidCount = FMath::Max(FMath::RoundUpToPowerOfTwo((uint32)NumBoids), BitonicBlockSize);
+
+	FBoidsCellListRDG Cells;
+	Cells.SortedCellList = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(uint32), NumBoids), TEXT("Boids.SortedCellList"));
+	Cells.CellOffsetList = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(uint32), BoidsShader::TotalCells), TEXT("Boids.CellOffsetList"));
+	Cells.CellBoidCount = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(uint32), BoidsShader::TotalCells), TEXT("Boids.CellBoidCount"));
+	FRDGBufferRef CellKeys = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(uint32) * 2, PaddedBoidCount), TEXT("Boids.CellKeys"));
+	FRDGBufferUAVRef CellKeysUAV = GraphBuilder.CreateUAV(CellKeys);
+
+	// 空单元的数量必须为 0，偏移清零只是为了结果确定
+	FRDGBufferUAVRef CellOffsetUAV = GraphBuilder.CreateUAV(Cells.CellOffsetList);
+	FRDGBufferUAVRef CellCountUAV = GraphBuilder.CreateUAV(Cells.CellBoidCount);
+	AddClearUAVPass(GraphBuilder, CellOffsetUAV, 0u);
+	AddClearUAVPass(GraphBuilder, CellCountUAV, 0u);
+
+	{
+		FBoidsHashCS::FParameters* Parameters = GraphBuilder.AllocParameters<FBoidsHashCS::FParameters>();
+		Parameters->BoidCount = NumBoids;
+		Parameters->PaddedBoidCount = PaddedBoidCount;
+		Parameters->CellSize = CellSize;
+		Parameters->BoidData = GraphBuilder.CreateSRV(BoidBuffer);
+		Parameters->CellKeys = CellKeysUAV;
+		AddCellListPass<FBoidsHashCS>(GraphBuilder, RDG_EVENT_NAME("HashBoids"), Parameters, PaddedBoidCount);
+	}
+
+	// 每个线程处理一对元素
+	const uint32 NumPairs = PaddedBoidCount / 2;
+	{
+		FBoidsBitonicSortLocalCS::FParameters* Parameters = GraphBuilder.AllocParameters<FBoidsBitonicSortLocalCS::FParameters>();
+		Parameters->CellKeys = CellKeysUAV;
+		AddCellListPass<FBoidsBitonicSortLocalCS>(GraphBuilder, RDG_EVENT_NAME("BitonicSortLocal"), Parameters, NumPairs);
+	}
+
+	for (uint32 K = BitonicBlockSize * 2; K <= PaddedBoidCount; K <<= 1)
+	{
+		for (uint32 J = K >> 1; J >= BitonicBlockSize; J >>= 1)
+		{
+			FBoidsBitonicMergeGlobalCS::FParameters* Parameters = GraphBuilder.AllocParameters<FBoidsBitonicMergeGlobalCS::FParameters>();
+			Parameters->PaddedBoidCount = PaddedBoidCount;
+			Parameters->BitonicK = K;
+			Parameters->BitonicJ = J;
+			Parameters->CellKeys = CellKeysUAV;
+			AddCellListPass<FBoidsBitonicMergeGlobalCS>(GraphBuilder, RDG_EVENT_NAME("BitonicMergeGlobal K=%u J=%u", K, J), Parameters, NumPairs);
+		}
+
+		FBoidsBitonicMergeLocalCS::FParameters* Parameters = GraphBuilder.AllocParameters<FBoidsBitonicMergeLocalCS::FParameters>();
+		Parameters->BitonicK = K;
+		Parameters->CellKeys = CellKeysUAV;
+		AddCellListPass<FBoidsBitonicMergeLocalCS>(GraphBuilder, RDG_EVENT_NAME("BitonicMergeLocal K=%u", K), Parameters, NumPairs);
+	}
+
+	FRDGBufferUAVRef SortedCellUAV = GraphBuilder.CreateUAV(Cells.SortedCellList);
+	auto AllocRangeParameters = [&]()
+	{
+		FBoidsCellRangeParameters* Parameters = GraphBuilder.AllocParameters<FBoidsCellRangeParameters>();
+		Parameters->BoidCount = NumBoids;
+		Parameters->ShuffleSeed = ShuffleSeed;
+		Parameters->CellKeys = CellKeysUAV;
+		Parameters->SortedCellList = SortedCellUAV;
+		Parameters->CellOffsetList = CellOffsetUAV;
+		Parameters->CellBoidCount = CellCountUAV;
+		return Parameters;
+	};
+
+	// 三个阶段依次依赖上一阶段写入的偏移和数量
+	AddCellListPass<FBoidsFindCellStartsCS>(GraphBuilder, RDG_EVENT_NAME("FindCellStarts"), AllocRangeParameters(), NumBoids);
+	AddCellListPass<FBoidsCountCellsCS>(GraphBuilder, RDG_EVENT_NAME("CountCells"), AllocRangeParameters(), NumBoids);
+	AddCellListPass<FBoidsScatterCellsCS>(GraphBuilder, RDG_EVENT_NAME("ScatterCells"), AllocRangeParameters(), NumBoids);
+
+	return Cells;
+}
+
+void AddBoidsStepPasses(
+	FRDGBuilder& GraphBuilder,
+	FRDGBufferRef InBoidBuffer,
+	FRDGBufferRef OutBoidBuffer,
+	int32 NumBoids,
+	const FBoidsStepParams& Params,
+	uint32 ShuffleSeed,
+	const TArray<FVolumeTableData>& Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	const TArray<FGroupTableData>& Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses)
+{
+	const FBoidsCellListRDG Cells = AddBuildCellListPasses(GraphBuilder, InBoidBuffer, NumBoids, Params.CellSize, ShuffleSeed);
+	FRDGBufferRef VolumeBuffer = CreateStructuredUploadBuffer(GraphBuilder, TEXT("Boids.VolumeData"), Volumes);
+	FRDGBufferRef GroupBuffer = CreateStructuredUploadBuffer(GraphBuilder, TEXT("Boids.GroupData"), Groups);
+	FRDGBufferRef GroupResponseBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("Boids.GroupResponseMatrix"), sizeof(uint32), UE_ARRAY_COUNT(GroupResponses.Words), GroupResponses.Words, sizeof(GroupResponses.Words), ERDGInitialDataFlags::NoCopy);
+	FRDGBufferRef VolumeGridCellBuffer = CreateStructuredUploadBuffer(GraphBuilder, TEXT("Boids.VolumeGridCells"), VolumeGrid.CellRanges);
+	FRDGBufferRef VolumeGridIndexBuffer = CreateStructuredUploadBuffer(GraphBuilder, TEXT("Boids.VolumeGridIndices"), VolumeGrid.VolumeIndices);
+
+	const int32 CalculationsPerThread = FMath::Max(1, Params.CalculationsPerThread);
+
+	FComputeFishShaderCS::FParameters* Parameters = GraphBuilder.AllocParameters<FComputeFishShaderCS::FParameters>();
+	Parameters->BoidCount = NumBoids;
+	Parameters->VolumeCount = Volumes.Num();
+	Parameters->CalculationsPerThread = CalculationsPerThread;
+	Parameters->MaxNeighbourChecks = Params.MaxNeighbourChecks;
+	Parameters->DeltaSeconds = Params.DeltaSeconds;
+	Parameters->CellSize = Params.CellSize;
+	Parameters->SortedCellList = GraphBuilder.CreateUAV(Cells.SortedCellList);
+	Parameters->CellOffsetList = GraphBuilder.CreateUAV(Cells.CellOffsetList);
+	Parameters->CellBoidCount = GraphBuilder.CreateUAV(Cells.CellBoidCount);
+	Parameters->BoidData = GraphBuilder.CreateSRV(InBoidBuffer);
+	Parameters->VolumeData = GraphBuilder.CreateSRV(VolumeBuffer);
+	Parameters->GroupData = GraphBuilder.CreateSRV(GroupBuffer);
+	Parameters->GroupResponseMatrix = GraphBuilder.CreateSRV(GroupResponseBuffer);
+	Parameters->OutBoidData = GraphBuilder.CreateUAV(OutBoidBuffer);
+	Parameters->VolumeGridMin = VolumeGrid.Min;
+	Parameters->VolumeGridInvCellSize = VolumeGrid.InvCellSize;
+	Parameters->VolumeGridDims = VolumeGrid.Dims;
+	Parameters->RestrictionListOffset = VolumeGrid.RestrictionOffset;
+	Parameters->RestrictionListCount = VolumeGrid.RestrictionCount;
+	Parameters->RestrictionGroupsMask = VolumeGrid.RestrictionGroupsMask;
+	Parameters->VolumeGridCells = GraphBuilder.CreateSRV(VolumeGridCellBuffer);
+	Parameters->VolumeGridIndices = GraphBuilder.CreateSRV(VolumeGridIndexBuffer);
+
+	if (Params.bFullNeighbourEvaluation)
+	{
+		// 每个哈希桶一个线程组，空桶直接退出
+		TShaderMapRef<FComputeFishShaderTiledCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+		FComputeShaderUtils::AddPass(
+			GraphBuilder,
+			RDG_EVENT_NAME("BoidsStepTiled %d", NumBoids),
+			ComputeShader,
+			Parameters,
+			FIntVector(BoidsShader::TiledDispatchWidth, BoidsShader::TotalCells / BoidsShader::TiledDispatchWidth, 1));
+		return;
+	}
+
+	TShaderMapRef<FComputeFishShaderCS> ComputeShader(GetGlobalShaderMap(GMaxRHIFeatureLevel));
+	const int32 BoidsPerGroup = BoidsShader::ThreadGroupSize * CalculationsPerThread;
+	FComputeShaderUtils::AddPass(
+		GraphBuilder,
+		RDG_EVENT_NAME("BoidsStep %d", NumBoids),
+		ComputeShader,
+		Parameters,
+		FIntVector(FMath::DivideAndRoundUp(NumBoids, BoidsPerGroup), 1, 1));
+}
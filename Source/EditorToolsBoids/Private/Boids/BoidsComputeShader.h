@@ -0,0 +1,189 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlobalShader.h"
+#include "ShaderParameterStruct.h"
+#include "RenderGraphResources.h"
+#include "Boids/BoidsShaderTypes.h"
+#include "Boids/BoidsVolumeGrid.h"
+
+/**
+ * ComputeFishShader.usf 中所有入口共用的编译环境
+ */
+class FBoidsGlobalShader : public FGlobalShader
+{
+public:
+	FBoidsGlobalShader() {}
+	FBoidsGlobalShader(const ShaderMetaType::CompiledShaderInitializerType& Initializer) : FGlobalShader(Initializer) {}
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters);
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment);
+};
+
+/**
+ * MainComputeShader：鱼群模拟一步
+ */
+class FComputeFishShaderCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FComputeFishShaderCS);
+	SHADER_USE_PARAMETER_STRUCT(FComputeFishShaderCS, FBoidsGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(int32, BoidCount)
+		SHADER_PARAMETER(int32, VolumeCount)
+		SHADER_PARAMETER(int32, CalculationsPerThread)
+		SHADER_PARAMETER(int32, MaxNeighbourChecks)
+		SHADER_PARAMETER(float, DeltaSeconds)
+		SHADER_PARAMETER(float, CellSize)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, SortedCellList)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, CellOffsetList)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, CellBoidCount)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<BoidTableData>, BoidData)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<VolumeTableData>, VolumeData)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<GroupTableData>, GroupData)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint>, GroupResponseMatrix)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<BoidTableData>, OutBoidData)
+		SHADER_PARAMETER(FVector3f, VolumeGridMin)
+		SHADER_PARAMETER(FVector3f, VolumeGridInvCellSize)
+		SHADER_PARAMETER(FIntVector, VolumeGridDims)
+		SHADER_PARAMETER(uint32, RestrictionListOffset)
+		SHADER_PARAMETER(uint32, RestrictionListCount)
+		SHADER_PARAMETER(int32, RestrictionGroupsMask)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint2>, VolumeGridCells)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<uint>, VolumeGridIndices)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/**
+ * MainComputeShaderTiled：完整邻居模式的一步模拟
+ * 每个哈希桶一个线程组，相邻 27 个桶的鱼分块读入共享内存，桶内所有鱼共用
+ */
+class FComputeFishShaderTiledCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FComputeFishShaderTiledCS);
+	SHADER_USE_PARAMETER_STRUCT(FComputeFishShaderTiledCS, FBoidsGlobalShader);
+	using FParameters = FComputeFishShaderCS::FParameters;
+};
+
+/** HashBoidsCS：计算每条鱼的 (单元, 索引) 排序键 */
+class FBoidsHashCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsHashCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsHashCS, FBoidsGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(int32, BoidCount)
+		SHADER_PARAMETER(uint32, PaddedBoidCount)
+		SHADER_PARAMETER(float, CellSize)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<BoidTableData>, BoidData)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint2>, CellKeys)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/** BitonicSortLocalCS：在共享内存中排好每个块 */
+class FBoidsBitonicSortLocalCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsBitonicSortLocalCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsBitonicSortLocalCS, FBoidsGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint2>, CellKeys)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/** BitonicMergeLocalCS：在共享内存中完成一个合并阶段里步长小于块大小的部分 */
+class FBoidsBitonicMergeLocalCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsBitonicMergeLocalCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsBitonicMergeLocalCS, FBoidsGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(uint32, BitonicK)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint2>, CellKeys)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/** BitonicMergeGlobalCS：在全局内存中做一次步长不小于块大小的比较交换 */
+class FBoidsBitonicMergeGlobalCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsBitonicMergeGlobalCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsBitonicMergeGlobalCS, FBoidsGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER(uint32, PaddedBoidCount)
+		SHADER_PARAMETER(uint32, BitonicK)
+		SHADER_PARAMETER(uint32, BitonicJ)
+		SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint2>, CellKeys)
+	END_SHADER_PARAMETER_STRUCT()
+};
+
+/** FindCellStartsCS / CountCellsCS / ScatterCellsCS 共用的参数 */
+BEGIN_SHADER_PARAMETER_STRUCT(FBoidsCellRangeParameters, )
+	SHADER_PARAMETER(int32, BoidCount)
+	SHADER_PARAMETER(uint32, ShuffleSeed)
+	SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint2>, CellKeys)
+	SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, SortedCellList)
+	SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, CellOffsetList)
+	SHADER_PARAMETER_RDG_BUFFER_UAV(RWStructuredBuffer<uint>, CellBoidCount)
+END_SHADER_PARAMETER_STRUCT()
+
+class FBoidsFindCellStartsCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsFindCellStartsCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsFindCellStartsCS, FBoidsGlobalShader);
+	using FParameters = FBoidsCellRangeParameters;
+};
+
+class FBoidsCountCellsCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsCountCellsCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsCountCellsCS, FBoidsGlobalShader);
+	using FParameters = FBoidsCellRangeParameters;
+};
+
+class FBoidsScatterCellsCS : public FBoidsGlobalShader
+{
+public:
+	DECLARE_GLOBAL_SHADER(FBoidsScatterCellsCS);
+	SHADER_USE_PARAMETER_STRUCT(FBoidsScatterCellsCS, FBoidsGlobalShader);
+	using FParameters = FBoidsCellRangeParameters;
+};
+
+/** GPU 上构建的单元表 */
+struct FBoidsCellListRDG
+{
+	FRDGBufferRef SortedCellList = nullptr;
+	FRDGBufferRef CellOffsetList = nullptr;
+	FRDGBufferRef CellBoidCount = nullptr;
+};
+
+/**
+ * 在 GPU 上构建单元表：哈希 -> 双调排序 -> 单元区间 -> 轮转散射
+ * 结果与 FBoidsCellListBuilder 相同（空单元的 CellOffsetList 除外，两边都不会读取）
+ */
+FBoidsCellListRDG AddBuildCellListPasses(FRDGBuilder& GraphBuilder, FRDGBufferRef BoidBuffer, int32 NumBoids, float CellSize, uint32 ShuffleSeed);
+
+/**
+ * 在 InBoidBuffer 上构建单元表并调度一步模拟，结果写入 OutBoidBuffer
+ * 完整邻居模式使用分块内核，否则使用按鱼调度的截断内核
+ */
+void AddBoidsStepPasses(
+	FRDGBuilder& GraphBuilder,
+	FRDGBufferRef InBoidBuffer,
+	FRDGBufferRef OutBoidBuffer,
+	int32 NumBoids,
+	const FBoidsStepParams& Params,
+	uint32 ShuffleSeed,
+	const TArray<FVolumeTableData>& Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	const TArray<FGroupTableData>& Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses);
@@ -0,0 +1,183 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsGPUState.h"
+#include "Boids/BoidsComputeShader.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RHIGPUReadback.h"
+#include "Misc/ScopeLock.h"
+
+bool FBoidsDoubleBufferedState::HasState(uint32 InGeneration, int32 InNumBoids) const
+{
+	return Buffers[ReadIndex].IsValid() && Generation == InGeneration && NumBoids == InNumBoids;
+}
+
+void FBoidsDoubleBufferedState::Upload(FRDGBuilder& GraphBuilder, const TArray<FBoidTableData>& Boids, uint32 InGeneration)
+{
+	check(Boids.Num() > 0);
+
+	// 数量不变时复用原来的缓冲区
+	if (NumBoids != Boids.Num() || !Buffers[0].IsValid() || !Buffers[1].IsValid())
+	{
+		const FRDGBufferDesc Desc = FRDGBufferDesc::CreateStructuredDesc(sizeof(FBoidTableData), Boids.Num());
+		Buffers[0] = AllocatePooledBuffer(Desc, TEXT("Boids.BoidData0"));
+		Buffers[1] = AllocatePooledBuffer(Desc, TEXT("Boids.BoidData1"));
+		NumBoids = Boids.Num();
+	}
+
+	ReadIndex = 0;
+	Generation = InGeneration;
+
+	FRDGBufferRef ReadBuffer = GraphBuilder.RegisterExternalBuffer(Buffers[ReadIndex]);
+	GraphBuilder.QueueBufferUpload(ReadBuffer, Boids.GetData(), Boids.Num() * sizeof(FBoidTableData), ERDGInitialDataFlags::NoCopy);
+}
+
+FBoidsDoubleBufferedState::FStepBuffers FBoidsDoubleBufferedState::BeginStep(FRDGBuilder& GraphBuilder) const
+{
+	check(Buffers[0].IsValid() && Buffers[1].IsValid());
+
+	FStepBuffers StepBuffers;
+	StepBuffers.Read = GraphBuilder.RegisterExternalBuffer(Buffers[ReadIndex]);
+	StepBuffers.Write = GraphBuilder.RegisterExternalBuffer(Buffers[ReadIndex ^ 1]);
+	return StepBuffers;
+}
+
+void FBoidsDoubleBufferedState::EndStep()
+{
+	ReadIndex ^= 1;
+}
+
+void FBoidsDoubleBufferedState::Release()
+{
+	Buffers[0].SafeRelease();
+	Buffers[1].SafeRelease();
+	ReadIndex = 0;
+	NumBoids = 0;
+}
+
+FBoidsGPUState::FBoidsGPUState()
+{
+}
+
+FBoidsGPUState::~FBoidsGPUState()
+{
+}
+
+void FBoidsGPUState::Step_RenderThread(FRHICommandListImmediate& RHICmdList, FBoidsGPUStepInputs& Inputs)
+{
+	check(IsInRenderingThread());
+
+	PollReadback_RenderThread();
+
+	if (Inputs.NumBoids == 0)
+	{
+		BoidState.Release();
+		return;
+	}
+
+	const bool bUpload = Inputs.UploadBoids.Num() > 0;
+	if (!bUpload && !BoidState.HasState(Inputs.Generation, Inputs.NumBoids))
+	{
+		// 没有可用的状态（例如渲染线程刚重建），等游戏线程下次上传
+		return;
+	}
+	check(!bUpload || Inputs.UploadBoids.Num() == Inputs.NumBoids);
+
+	FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("BoidsSimulation"));
+
+	if (bUpload)
+	{
+		BoidState.Upload(GraphBuilder, Inputs.UploadBoids, Inputs.Generation);
+	}
+	const FBoidsDoubleBufferedState::FStepBuffers Buffers = BoidState.BeginStep(GraphBuilder);
+
+	AddBoidsStepPasses(GraphBuilder, Buffers.Read, Buffers.Write, Inputs.NumBoids, Inputs.Params, Inputs.ShuffleSeed, Inputs.Volumes, Inputs.VolumeGrid, Inputs.Groups, Inputs.GroupResponses);
+
+	// 上一次回读还没完成时跳过，游戏线程只需要最近的一份结果
+	if (Inputs.bReadback && !bReadbackInFlight)
+	{
+		if (!Readback.IsValid())
+		{
+			Readback = MakeUnique<FRHIGPUBufferReadback>(TEXT("Boids.Readback"));
+		}
+		AddEnqueueCopyPass(GraphBuilder, Readback.Get(), Buffers.Write, Inputs.NumBoids * sizeof(FBoidTableData));
+		ReadbackNumBoids = Inputs.NumBoids;
+		ReadbackGeneration = Inputs.Generation;
+		bReadbackInFlight = true;
+	}
+
+	GraphBuilder.Execute();
+
+	BoidState.EndStep();
+}
+
+bool FBoidsGPUState::ConsumeReadback(uint32 Generation, TArray<FBoidTableData>& OutBoids)
+{
+	FScopeLock Lock(&ResultLock);
+	if (!bHasResult || ResultGeneration != Generation)
+	{
+		return false;
+	}
+
+	OutBoids = MoveTemp(ResultBoids);
+	ResultBoids.Reset();
+	bHasResult = false;
+	return true;
+}
+
+TRefCountPtr<FRDGPooledBuffer> FBoidsGPUState::GetBoidBuffer_RenderThread(int32& OutNumBoids) const
+{
+	check(IsInRenderingThread());
+
+	OutNumBoids = BoidState.GetCurrentBuffer().IsValid() ? BoidState.GetNumBoids() : 0;
+	return BoidState.GetCurrentBuffer();
+}
+
+bool FBoidsGPUState::ReadBoidsBlocking_RenderThread(FRHICommandListImmediate& RHICmdList, uint32 Generation, TArray<FBoidTableData>& OutBoids)
+{
+	check(IsInRenderingThread());
+
+	const int32 NumBoids = BoidState.GetNumBoids();
+	if (NumBoids == 0 || !BoidState.HasState(Generation, NumBoids))
+	{
+		return false;
+	}
+
+	FRHIGPUBufferReadback SyncReadback(TEXT("Boids.SyncReadback"));
+	{
+		FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("BoidsSyncReadback"));
+		FRDGBufferRef CurrentBuffer = GraphBuilder.RegisterExternalBuffer(BoidState.GetCurrentBuffer());
+		AddEnqueueCopyPass(GraphBuilder, &SyncReadback, CurrentBuffer, NumBoids * sizeof(FBoidTableData));
+		GraphBuilder.Execute();
+	}
+
+	RHICmdList.SubmitCommandsAndFlushGPU();
+	RHICmdList.BlockUntilGPUIdle();
+
+	const uint32 NumBytes = NumBoids * sizeof(FBoidTableData);
+	OutBoids.SetNumUninitialized(NumBoids);
+	FMemory::Memcpy(OutBoids.GetData(), SyncReadback.Lock(NumBytes), NumBytes);
+	SyncReadback.Unlock();
+	return true;
+}
+
+void FBoidsGPUState::PollReadback_RenderThread()
+{
+	if (!bReadbackInFlight || !Readback->IsReady())
+	{
+		return;
+	}
+
+	const uint32 NumBytes = ReadbackNumBoids * sizeof(FBoidTableData);
+	const FBoidTableData* Data = static_cast<const FBoidTableData*>(Readback->Lock(NumBytes));
+	{
+		FScopeLock Lock(&ResultLock);
+		ResultBoids.SetNumUninitialized(ReadbackNumBoids);
+		FMemory::Memcpy(ResultBoids.GetData(), Data, NumBytes);
+		ResultGeneration = ReadbackGeneration;
+		bHasResult = true;
+	}
+	Readback->Unlock();
+
+	bReadbackInFlight = false;
+}
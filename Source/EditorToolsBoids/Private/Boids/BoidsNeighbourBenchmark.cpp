@@ -0,0 +1,99 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsBenchmark.h"
+#include "Boids/BoidsSimulation.h"
+#include "Boids/BoidsSyntheticScenario.h"
+#include "EditorToolsBoids.h"
+#include "HAL/IConsoleManager.h"
+
+// 比较截断邻居和完整邻居两种模式的吞吐量与结果差异：
+// EditorTools.Boids.BenchmarkNeighbourModes [步数] [鱼数量...]（默认 10 步，10000 100000 1000000 条鱼）
+namespace
+{
+	/** 两次模拟结果的差异，以完整邻居模式为基准 */
+	struct FNeighbourModeDeviation
+	{
+		double MeanHeadingDegrees = 0.0;
+		double MaxHeadingDegrees = 0.0;
+		double MeanPositionDistance = 0.0;
+	};
+
+	static FNeighbourModeDeviation MeasureDeviation(TConstArrayView<FBoidTableData> Reference, TConstArrayView<FBoidTableData> Actual)
+	{
+		check(Reference.Num() == Actual.Num());
+
+		FNeighbourModeDeviation Deviation;
+		if (Reference.Num() == 0)
+		{
+			return Deviation;
+		}
+
+		for (int32 Index = 0; Index < Reference.Num(); ++Index)
+		{
+			const float CosAngle = FMath::Clamp(FVector3f::DotProduct(Reference[Index].Heading, Actual[Index].Heading), -1.f, 1.f);
+			const double Degrees = FMath::RadiansToDegrees(FMath::Acos(CosAngle));
+			Deviation.MeanHeadingDegrees += Degrees;
+			Deviation.MaxHeadingDegrees = FMath::Max(Deviation.MaxHeadingDegrees, Degrees);
+			Deviation.MeanPositionDistance += FVector3f::Distance(Reference[Index].Position, Actual[Index].Position);
+		}
+		Deviation.MeanHeadingDegrees /= Reference.Num();
+		Deviation.MeanPositionDistance /= Reference.Num();
+		return Deviation;
+	}
+
+	static void BenchmarkNeighbourModes(const TArray<FString>& Args)
+	{
+		const int32 NumSteps = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10;
+
+		TArray<int32> BoidCounts;
+		for (int32 Index = 1; Index < Args.Num(); ++Index)
+		{
+			BoidCounts.Add(FMath::Max(1, FCString::Atoi(*Args[Index])));
+		}
+		if (BoidCounts.Num() == 0)
+		{
+			BoidCounts = { 10000, 100000, 1000000 };
+		}
+
+		const bool bUseGPU = FBoidsSimulation::CanUseGPU();
+		if (!bUseGPU)
+		{
+			UE_LOG(LogEditorToolsBoids, Display, TEXT("当前 RHI 不支持鱼群计算着色器，只测试 CPU 内核"));
+		}
+
+		for (const int32 NumBoids : BoidCounts)
+		{
+			const FBoidsSyntheticScenario Scenario = FBoidsSyntheticScenario::Make(NumBoids);
+
+			FBoidsStepParams TruncatedParams = Scenario.Params;
+			TruncatedParams.bFullNeighbourEvaluation = false;
+			FBoidsStepParams FullParams = Scenario.Params;
+			FullParams.bFullNeighbourEvaluation = true;
+
+			TArray<FBoidTableData> TruncatedBoids;
+			TArray<FBoidTableData> FullBoids;
+			const double TruncatedMs = BoidsBenchmark::RunCPU(Scenario, TruncatedParams, BoidsBenchmark::ECPUKernel::SIMD, NumSteps, TruncatedBoids).MsPerStep;
+			const double FullMs = BoidsBenchmark::RunCPU(Scenario, FullParams, BoidsBenchmark::ECPUKernel::SIMD, NumSteps, FullBoids).MsPerStep;
+			const FNeighbourModeDeviation Deviation = MeasureDeviation(FullBoids, TruncatedBoids);
+
+			UE_LOG(LogEditorToolsBoids, Display, TEXT("%d 条鱼，%d 步：CPU 截断 %.2f ms/步（%.1f M 鱼/秒），CPU 完整 %.2f ms/步（%.1f M 鱼/秒）"),
+				NumBoids, NumSteps,
+				TruncatedMs, NumBoids / (TruncatedMs * 1000.0),
+				FullMs, NumBoids / (FullMs * 1000.0));
+			UE_LOG(LogEditorToolsBoids, Display, TEXT("    截断模式相对完整模式：朝向平均偏差 %.3f 度，最大 %.3f 度，位置平均偏差 %.3f 厘米"),
+				Deviation.MeanHeadingDegrees, Deviation.MaxHeadingDegrees, Deviation.MeanPositionDistance);
+
+			if (bUseGPU)
+			{
+				const double GPUTruncatedMs = BoidsBenchmark::RunGPU(Scenario, TruncatedParams, NumSteps);
+				const double GPUFullMs = BoidsBenchmark::RunGPU(Scenario, FullParams, NumSteps);
+				UE_LOG(LogEditorToolsBoids, Display, TEXT("    GPU 截断 %.2f ms/步，GPU 完整（分块内核）%.2f ms/步"), GPUTruncatedMs, GPUFullMs);
+			}
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkNeighbourModesCommand(
+		TEXT("EditorTools.Boids.BenchmarkNeighbourModes"),
+		TEXT("比较截断邻居与完整邻居模式的吞吐量和结果偏差。参数：步数（默认 10），鱼数量列表（默认 10000 100000 1000000）"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkNeighbourModes));
+}
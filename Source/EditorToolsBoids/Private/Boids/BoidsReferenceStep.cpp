@@ -0,0 +1,430 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsVolumeGrid.h"
+#include "Types/BoidsTypes.h"
+
+// 以下辅助函数与 ComputeFishShader.usf 中的同名函数一一对应，修改时两边同步
+namespace
+{
+	static FVector3f Normalize(const FVector3f& V)
+	{
+		return V * (1.0f / FMath::Sqrt(FVector3f::DotProduct(V, V)));
+	}
+
+	static float Length(const FVector3f& V)
+	{
+		return FMath::Sqrt(FVector3f::DotProduct(V, V));
+	}
+
+	static FVector3f SafeNormalize(const FVector3f& V)
+	{
+		return Length(V) > 0.0f ? Normalize(V) : FVector3f(1.0f, 0.0f, 0.0f);
+	}
+
+	// mul(transpose(M), float4(V, 1)).xyz，矩阵按行主序上传
+	static FVector3f TransformPosition(const FVector3f& V, const FMatrix44f& M)
+	{
+		return FVector3f(
+			V.X * M.M[0][0] + V.Y * M.M[1][0] + V.Z * M.M[2][0] + M.M[3][0],
+			V.X * M.M[0][1] + V.Y * M.M[1][1] + V.Z * M.M[2][1] + M.M[3][1],
+			V.X * M.M[0][2] + V.Y * M.M[1][2] + V.Z * M.M[2][2] + M.M[3][2]);
+	}
+
+	static FVector3f ClampVector(const FVector3f& V, const FVector3f& Min, const FVector3f& Max)
+	{
+		return FVector3f(FMath::Clamp(V.X, Min.X, Max.X), FMath::Clamp(V.Y, Min.Y, Max.Y), FMath::Clamp(V.Z, Min.Z, Max.Z));
+	}
+
+	static FVector3f Slerp(const FVector3f& Current, const FVector3f& Target, float DeltaSeconds, float MaxAngle)
+	{
+		const float T = (DeltaSeconds * MaxAngle) / 360.0f;
+
+		float D = FVector3f::DotProduct(Current, Target);
+		if (D > 0.99f)
+		{
+			return Target;
+		}
+
+		D = FMath::Clamp(D, -1.0f, 1.0f);
+		const float Theta = FMath::Min(1.0f, T);
+
+		const FVector3f RelativeVec = Normalize(Target - Current * D);
+		return (Current * FMath::Cos(Theta)) + (RelativeVec * FMath::Sin(Theta));
+	}
+
+	static float InverseLerp(float Value, float MinRange, float MaxRange)
+	{
+		return MinRange == MaxRange ? 0.0f : (Value - MinRange) / (MaxRange - MinRange);
+	}
+
+	static bool BoxContainsPoint(const FVector3f& P, const FMatrix44f& WorldToLocal, const FVector3f& Extents)
+	{
+		const FVector3f LocalP = TransformPosition(P, WorldToLocal);
+		const FVector3f Min = -Extents;
+		const FVector3f Max = Extents;
+
+		return
+			(Min.X - LocalP.X) * (Max.X - LocalP.X) <= 0.0f &&
+			(Min.Y - LocalP.Y) * (Max.Y - LocalP.Y) <= 0.0f &&
+			(Min.Z - LocalP.Z) * (Max.Z - LocalP.Z) <= 0.0f;
+	}
+
+	static float GetSphericalInfluence(const FVector3f& Position, const FMatrix44f& WorldToLocal, float InnerRadius, float OuterRadius, float Falloff)
+	{
+		const FVector3f LocalP = TransformPosition(Position, WorldToLocal);
+		const float DistanceFromEpicenter = Length(LocalP);
+
+		if (DistanceFromEpicenter >= OuterRadius)
+		{
+			return 0.0f;
+		}
+
+		if ((Falloff == 0.0f) || (DistanceFromEpicenter <= InnerRadius))
+		{
+			return 1.0f;
+		}
+
+		float Influence = 1.f - ((DistanceFromEpicenter - InnerRadius) / (OuterRadius - InnerRadius));
+		Influence = FMath::Pow(Influence, Falloff);
+		return Influence;
+	}
+
+	static float GetBoxInfluence(const FVector3f& SamplePosition, const FMatrix44f& WorldToLocal, const FVector3f& InnerExtents, const FVector3f& OuterExtents, float Falloff)
+	{
+		if (BoxContainsPoint(SamplePosition, WorldToLocal, InnerExtents))
+		{
+			return 1.0f;
+		}
+		else if (!BoxContainsPoint(SamplePosition, WorldToLocal, OuterExtents))
+		{
+			return 0.0f;
+		}
+
+		const FVector3f LocalP = TransformPosition(SamplePosition, WorldToLocal);
+		float Inf = 0.0f;
+		Inf = FMath::Max(Inf, LocalP.X > InnerExtents.X ? InverseLerp(LocalP.X, OuterExtents.X, InnerExtents.X) : 0.0f);
+		Inf = FMath::Max(Inf, LocalP.Y > InnerExtents.Y ? InverseLerp(LocalP.Y, OuterExtents.Y, InnerExtents.Y) : 0.0f);
+		Inf = FMath::Max(Inf, LocalP.Z > InnerExtents.Z ? InverseLerp(LocalP.Z, OuterExtents.Z, InnerExtents.Z) : 0.0f);
+		Inf = FMath::Max(Inf, LocalP.X < -InnerExtents.X ? InverseLerp(LocalP.X, -OuterExtents.X, -InnerExtents.X) : 0.0f);
+		Inf = FMath::Max(Inf, LocalP.Y < -InnerExtents.Y ? InverseLerp(LocalP.Y, -OuterExtents.Y, -InnerExtents.Y) : 0.0f);
+		Inf = FMath::Max(Inf, LocalP.Z < -InnerExtents.Z ? InverseLerp(LocalP.Z, -OuterExtents.Z, -InnerExtents.Z) : 0.0f);
+
+		return FMath::Pow(Inf, Falloff);
+	}
+
+	static float GetInfluence(const FVector3f& SamplePosition, const FVolumeTableData& Volume)
+	{
+		const float Falloff = Volume.VolumeUseFalloff != 0 ? Volume.VolumeFalloff : 0.0f;
+		if (Volume.VolumeShape == (int32)EBoidVolumeShape::Sphere)
+		{
+			return GetSphericalInfluence(SamplePosition, Volume.VolumeWorldToLocal, Volume.VolumeInnerRadius, Volume.VolumeOuterRadius, Falloff);
+		}
+		else if (Volume.VolumeShape == (int32)EBoidVolumeShape::Box)
+		{
+			return GetBoxInfluence(SamplePosition, Volume.VolumeWorldToLocal, Volume.VolumeInnerExtents, Volume.VolumeOuterExtents, Falloff);
+		}
+		return 0.0f;
+	}
+
+	static FVector3f GetClosestInnerPoint(const FVector3f& SamplePosition, const FVolumeTableData& Volume)
+	{
+		const FVector3f LocalP = TransformPosition(SamplePosition, Volume.VolumeWorldToLocal);
+
+		if (Volume.VolumeShape == (int32)EBoidVolumeShape::Sphere)
+		{
+			return TransformPosition(SafeNormalize(LocalP) * Volume.VolumeInnerRadius, Volume.VolumeLocalToWorld);
+		}
+		else if (Volume.VolumeShape == (int32)EBoidVolumeShape::Box)
+		{
+			return TransformPosition(ClampVector(LocalP, -Volume.VolumeInnerExtents, Volume.VolumeInnerExtents), Volume.VolumeLocalToWorld);
+		}
+		return SamplePosition;
+	}
+
+	static void GetClosestInnerAndOuterPoints(const FVector3f& SamplePosition, const FVolumeTableData& Volume, FVector3f& OutInner, FVector3f& OutOuter)
+	{
+		OutInner = SamplePosition;
+		OutOuter = SamplePosition;
+
+		const FVector3f LocalP = TransformPosition(SamplePosition, Volume.VolumeWorldToLocal);
+
+		if (Volume.VolumeShape == (int32)EBoidVolumeShape::Sphere)
+		{
+			OutInner = TransformPosition(SafeNormalize(LocalP) * Volume.VolumeInnerRadius, Volume.VolumeLocalToWorld);
+			OutOuter = TransformPosition(SafeNormalize(LocalP) * Volume.VolumeOuterRadius, Volume.VolumeLocalToWorld);
+		}
+		else if (Volume.VolumeShape == (int32)EBoidVolumeShape::Box)
+		{
+			OutInner = TransformPosition(ClampVector(LocalP, -Volume.VolumeInnerExtents, Volume.VolumeInnerExtents), Volume.VolumeLocalToWorld);
+			OutOuter = TransformPosition(ClampVector(LocalP, -Volume.VolumeOuterExtents, Volume.VolumeOuterExtents), Volume.VolumeLocalToWorld);
+		}
+	}
+
+	static void NormalizeAverage(FVector3f& Steer, float Count)
+	{
+		if (Count > 0)
+		{
+			Steer /= Count;
+			Steer = Normalize(Steer);
+		}
+	}
+}
+
+void FBoidsReferenceStep::Step(
+	const FBoidsStepParams& Params,
+	TConstArrayView<FBoidTableData> InBoids,
+	TConstArrayView<FVolumeTableData> Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	TConstArrayView<FGroupTableData> Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses,
+	const FBoidsCellList& Cells,
+	TArrayView<FBoidTableData> OutBoids)
+{
+	check(InBoids.Num() == OutBoids.Num());
+	check(InBoids.GetData() != OutBoids.GetData());
+
+	for (int32 BoidIndex = 0; BoidIndex < InBoids.Num(); ++BoidIndex)
+	{
+		StepBoid(Params, BoidIndex, InBoids, Volumes, VolumeGrid, Groups, GroupResponses, Cells, OutBoids[BoidIndex]);
+	}
+}
+
+void FBoidsReferenceStep::StepBoid(
+	const FBoidsStepParams& Params,
+	int32 BoidIndex,
+	TConstArrayView<FBoidTableData> InBoids,
+	TConstArrayView<FVolumeTableData> Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	TConstArrayView<FGroupTableData> Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses,
+	const FBoidsCellList& Cells,
+	FBoidTableData& OutBoid)
+{
+	FBoidsNeighbourSums Sums;
+	AccumulateNeighbours(Params, BoidIndex, InBoids, Groups, GroupResponses, Cells, Sums);
+	FinishBoid(Params, BoidIndex, InBoids, Volumes, VolumeGrid, Groups, Sums, OutBoid);
+}
+
+void FBoidsReferenceStep::AccumulateNeighbours(
+	const FBoidsStepParams& Params,
+	int32 BoidIndex,
+	TConstArrayView<FBoidTableData> InBoids,
+	TConstArrayView<FGroupTableData> Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses,
+	const FBoidsCellList& Cells,
+	FBoidsNeighbourSums& OutSums)
+{
+	const FVector3f Position = InBoids[BoidIndex].Position;
+	const FGroupTableData& GroupData = Groups[InBoids[BoidIndex].Group];
+	const uint32* ResponseRow = GroupResponses.GetRow(InBoids[BoidIndex].Group);
+	const uint32 NeighbourCheckLimit = Params.GetNeighbourCheckLimit();
+
+	// 邻居：周围 3x3x3 个单元，每个单元最多 MaxNeighbourChecks 条（完整邻居模式下不限）
+	const FIntVector CellIndex = BoidsShader::GetCellVector(Position, Params.CellSize);
+	for (int32 I = -1; I <= 1; ++I)
+	{
+		for (int32 J = -1; J <= 1; ++J)
+		{
+			for (int32 K = -1; K <= 1; ++K)
+			{
+				const uint32 FlatNeighbourIndex = BoidsShader::GetFlatCellIndex(CellIndex + FIntVector(I, J, K));
+				const uint32 NeighbourIter = Cells.CellOffsetList[FlatNeighbourIndex];
+				const uint32 CellCount = FMath::Min(Cells.CellBoidCount[FlatNeighbourIndex], NeighbourCheckLimit);
+
+				for (uint32 W = NeighbourIter; W < NeighbourIter + CellCount; ++W)
+				{
+					const FBoidTableData& Other = InBoids[Cells.SortedCellList[W]];
+					if (FBoidsGroupResponseMatrix::GetFromRow(ResponseRow, Other.Group) != (uint32)EBoidGroupResponse::Flock)
+					{
+						continue;
+					}
+
+					const float D = Length(Position - Other.Position);
+
+					// 位置完全重合（包括自己）时跳过
+					if (D > 1.0f)
+					{
+						if (D < GroupData.GroupSeparationRadius)
+						{
+							OutSums.Separation += Position - Other.Position;
+							OutSums.SeparationCnt++;
+						}
+
+						if (D < GroupData.GroupCohesionRadius)
+						{
+							OutSums.Cohesion += Other.Position - Position;
+							OutSums.CohesionCnt++;
+						}
+
+						if (D < GroupData.GroupAlignmentRadius)
+						{
+							OutSums.Alignment += Other.Heading;
+							OutSums.AlignmentCnt++;
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+void FBoidsReferenceStep::FinishBoid(
+	const FBoidsStepParams& Params,
+	int32 BoidIndex,
+	TConstArrayView<FBoidTableData> InBoids,
+	TConstArrayView<FVolumeTableData> Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	TConstArrayView<FGroupTableData> Groups,
+	const FBoidsNeighbourSums& Sums,
+	FBoidTableData& OutBoid)
+{
+	OutBoid = InBoids[BoidIndex];
+	const FVector3f Heading = OutBoid.Heading;
+	const FVector3f Position = OutBoid.Position;
+	const int32 Group = OutBoid.Group;
+	const FGroupTableData& GroupData = Groups[Group];
+
+	FVector3f SteerCohesion = Sums.Cohesion;
+	FVector3f SteerSeparation = Sums.Separation;
+	FVector3f SteerAlignment = Sums.Alignment;
+	FVector3f SteerGoal(0.0f);
+	FVector3f SteerFlee(0.0f);
+	FVector3f SteerRest(0.0f);
+
+	const float CohesionCnt = Sums.CohesionCnt;
+	const float SeparationCnt = Sums.SeparationCnt;
+	const float AlignmentCnt = Sums.AlignmentCnt;
+	float GoalCnt = 0.0f;
+	float FleeCnt = 0.0f;
+	float RestCnt = 0.0f;
+
+	// 影响体积
+	float ClosestClampedDist = 100000000.0f;
+	FVector3f BestInnerPoint = Position;
+	FVector3f BestOuterPoint = Position;
+	int32 BestVolumeIndex = 0;
+	bool bIsInsideRestrictionVolume = false;
+	const bool bHasRestrictionVolumes = (VolumeGrid.RestrictionGroupsMask & (1 << Group)) != 0;
+
+	OutBoid.Action = 0;
+	OutBoid.NumVolumesAffecting = 0;
+
+	// 只有外包围盒与鱼所在格子重叠的体积才可能有影响
+	for (const uint32 V : VolumeGrid.GetCellVolumes(Position))
+	{
+		const FVolumeTableData& Volume = Volumes[V];
+		if ((Volume.VolumeInfluencesGroups & (1 << Group)) == 0)
+		{
+			continue;
+		}
+
+		const float Inf = GetInfluence(Position, Volume);
+
+		if (Inf > 0.0f && OutBoid.NumVolumesAffecting < BoidsShader::MaxVolumes)
+		{
+			OutBoid.VolumesAffectingIndices[OutBoid.NumVolumesAffecting] = V;
+			OutBoid.NumVolumesAffecting += 1;
+		}
+
+		if (Volume.VolumeType == (int32)EBoidVolumeType::Goal)
+		{
+			if (Inf > 0.0f)
+			{
+				SteerGoal += SafeNormalize(TransformPosition(FVector3f(0.0f), Volume.VolumeLocalToWorld) - Position) * Inf;
+				OutBoid.Action |= BoidsShader::ActionGoaling;
+				GoalCnt++;
+			}
+		}
+		else if (Volume.VolumeType == (int32)EBoidVolumeType::Flee)
+		{
+			if (Inf > 0.0f)
+			{
+				SteerFlee += SafeNormalize(Position - TransformPosition(FVector3f(0.0f), Volume.VolumeLocalToWorld)) * Inf;
+				OutBoid.Action |= BoidsShader::ActionFleeing;
+				FleeCnt++;
+			}
+		}
+		else if (Volume.VolumeType == (int32)EBoidVolumeType::Restriction)
+		{
+			const float RestInf = 1.0f - Inf;
+
+			if (RestInf > 0.0f && RestInf < 1.0f)
+			{
+				const FVector3f ClosestInnerPoint = GetClosestInnerPoint(Position, Volume);
+				SteerRest += SafeNormalize(ClosestInnerPoint - Position) * RestInf;
+				RestCnt++;
+				bIsInsideRestrictionVolume = true;
+			}
+			else if (RestInf <= 0.0f)
+			{
+				bIsInsideRestrictionVolume = true;
+			}
+		}
+	}
+
+	// 在所有限制体积之外：最近的限制体积可能在任何位置，遍历完整的限制体积列表
+	if (!bIsInsideRestrictionVolume && bHasRestrictionVolumes)
+	{
+		for (const uint32 V : VolumeGrid.GetRestrictionVolumes())
+		{
+			const FVolumeTableData& Volume = Volumes[V];
+			if ((Volume.VolumeInfluencesGroups & (1 << Group)) == 0)
+			{
+				continue;
+			}
+
+			FVector3f ClosestInnerPoint;
+			FVector3f ClosestOuterPoint;
+			GetClosestInnerAndOuterPoints(Position, Volume, ClosestInnerPoint, ClosestOuterPoint);
+
+			const float Dist = Length(Position - ClosestOuterPoint);
+			if (Dist < ClosestClampedDist)
+			{
+				ClosestClampedDist = Dist;
+				BestInnerPoint = ClosestInnerPoint;
+				BestOuterPoint = ClosestOuterPoint;
+				BestVolumeIndex = V;
+			}
+		}
+	}
+
+	NormalizeAverage(SteerAlignment, AlignmentCnt);
+	NormalizeAverage(SteerCohesion, CohesionCnt);
+	NormalizeAverage(SteerSeparation, SeparationCnt);
+	NormalizeAverage(SteerGoal, GoalCnt);
+	NormalizeAverage(SteerFlee, FleeCnt);
+	NormalizeAverage(SteerRest, RestCnt);
+
+	const FVector3f SteerNonVertical = SafeNormalize(FVector3f(Heading.X, Heading.Y, 0.0f)) * GroupData.GroupNonVerticalMovementFactor;
+
+	SteerAlignment *= GroupData.GroupAlignment;
+	SteerCohesion *= GroupData.GroupCohesion;
+	SteerSeparation *= GroupData.GroupSeparation;
+	SteerGoal *= GroupData.GroupGoal;
+	SteerFlee *= GroupData.GroupFlee;
+	SteerRest *= GroupData.GroupRestriction;
+
+	FVector3f NewHeading = Heading + SteerAlignment + SteerCohesion + SteerSeparation + SteerGoal + SteerFlee + SteerRest + SteerNonVertical;
+	NewHeading = SafeNormalize(NewHeading);
+
+	// 在所有限制体积之外：拉回最近的外边界并加速转向
+	float Turning = OutBoid.Turning;
+	FVector3f NewPosition = Position;
+	if (!bIsInsideRestrictionVolume && bHasRestrictionVolumes)
+	{
+		NewHeading = SafeNormalize(BestInnerPoint - Position);
+		Turning *= 5.0f;
+		NewPosition = BestOuterPoint;
+
+		if (OutBoid.NumVolumesAffecting < BoidsShader::MaxVolumes)
+		{
+			OutBoid.VolumesAffectingIndices[OutBoid.NumVolumesAffecting] = BestVolumeIndex;
+			OutBoid.NumVolumesAffecting += 1;
+		}
+	}
+
+	OutBoid.Heading = SafeNormalize(Slerp(Heading, NewHeading, Params.DeltaSeconds, Turning));
+	OutBoid.Position = NewPosition + (OutBoid.Heading * Params.DeltaSeconds * OutBoid.Speed);
+}
@@ -0,0 +1,200 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsSIMDStep.h"
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsVolumeGrid.h"
+#include "Types/BoidsTypes.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	constexpr int32 LaneCount = 4;
+
+	// 每个并行任务处理的鱼数量
+	constexpr int32 BoidsPerTask = 512;
+
+	static float HorizontalSum(const VectorRegister4Float& V)
+	{
+		alignas(16) float Lanes[LaneCount];
+		VectorStoreAligned(V, Lanes);
+		return (Lanes[0] + Lanes[1]) + (Lanes[2] + Lanes[3]);
+	}
+
+	/** 4 路邻居累加器 */
+	struct FNeighbourAccumulator
+	{
+		VectorRegister4Float SeparationX = VectorZeroFloat();
+		VectorRegister4Float SeparationY = VectorZeroFloat();
+		VectorRegister4Float SeparationZ = VectorZeroFloat();
+		VectorRegister4Float CohesionX = VectorZeroFloat();
+		VectorRegister4Float CohesionY = VectorZeroFloat();
+		VectorRegister4Float CohesionZ = VectorZeroFloat();
+		VectorRegister4Float AlignmentX = VectorZeroFloat();
+		VectorRegister4Float AlignmentY = VectorZeroFloat();
+		VectorRegister4Float AlignmentZ = VectorZeroFloat();
+		VectorRegister4Float SeparationCnt = VectorZeroFloat();
+		VectorRegister4Float CohesionCnt = VectorZeroFloat();
+		VectorRegister4Float AlignmentCnt = VectorZeroFloat();
+
+		void Resolve(FBoidsNeighbourSums& OutSums) const
+		{
+			OutSums.Separation = FVector3f(HorizontalSum(SeparationX), HorizontalSum(SeparationY), HorizontalSum(SeparationZ));
+			OutSums.Cohesion = FVector3f(HorizontalSum(CohesionX), HorizontalSum(CohesionY), HorizontalSum(CohesionZ));
+			OutSums.Alignment = FVector3f(HorizontalSum(AlignmentX), HorizontalSum(AlignmentY), HorizontalSum(AlignmentZ));
+			OutSums.SeparationCnt = HorizontalSum(SeparationCnt);
+			OutSums.CohesionCnt = HorizontalSum(CohesionCnt);
+			OutSums.AlignmentCnt = HorizontalSum(AlignmentCnt);
+		}
+	};
+}
+
+void FBoidsSIMDStep::GatherSortedStreams(TConstArrayView<FBoidTableData> InBoids, const FBoidsCellList& Cells, const FBoidsGroupResponseMatrix& GroupResponses)
+{
+	const int32 NumBoids = InBoids.Num();
+	const int32 NumPadded = NumBoids + LaneCount;
+
+	SortedPositionX.SetNumUninitialized(NumPadded);
+	SortedPositionY.SetNumUninitialized(NumPadded);
+	SortedPositionZ.SetNumUninitialized(NumPadded);
+	SortedHeadingX.SetNumUninitialized(NumPadded);
+	SortedHeadingY.SetNumUninitialized(NumPadded);
+	SortedHeadingZ.SetNumUninitialized(NumPadded);
+	SortedGroup.SetNumUninitialized(NumPadded);
+
+	ParallelFor(FMath::DivideAndRoundUp(NumBoids, BoidsPerTask), [&](int32 TaskIndex)
+	{
+		const int32 Begin = TaskIndex * BoidsPerTask;
+		const int32 End = FMath::Min(Begin + BoidsPerTask, NumBoids);
+		for (int32 W = Begin; W < End; ++W)
+		{
+			const FBoidTableData& Boid = InBoids[Cells.SortedCellList[W]];
+			SortedPositionX[W] = Boid.Position.X;
+			SortedPositionY[W] = Boid.Position.Y;
+			SortedPositionZ[W] = Boid.Position.Z;
+			SortedHeadingX[W] = Boid.Heading.X;
+			SortedHeadingY[W] = Boid.Heading.Y;
+			SortedHeadingZ[W] = Boid.Heading.Z;
+			SortedGroup[W] = Boid.Group;
+		}
+	});
+
+	// 填充元素总会被通道掩码排除，只需要是合法的分组索引
+	for (int32 W = NumBoids; W < NumPadded; ++W)
+	{
+		SortedPositionX[W] = SortedPositionY[W] = SortedPositionZ[W] = 0.f;
+		SortedHeadingX[W] = SortedHeadingY[W] = SortedHeadingZ[W] = 0.f;
+		SortedGroup[W] = 0;
+	}
+
+	FlockTable.SetNumUninitialized(BoidsShader::MaxGroups * BoidsShader::MaxGroups);
+	for (int32 Group = 0; Group < BoidsShader::MaxGroups; ++Group)
+	{
+		for (int32 Other = 0; Other < BoidsShader::MaxGroups; ++Other)
+		{
+			const bool bFlock = GroupResponses.Get(Group, Other) == (uint32)EBoidGroupResponse::Flock;
+			FlockTable[Group * BoidsShader::MaxGroups + Other] = bFlock ? -1 : 0;
+		}
+	}
+}
+
+void FBoidsSIMDStep::Step(
+	const FBoidsStepParams& Params,
+	TConstArrayView<FBoidTableData> InBoids,
+	TConstArrayView<FVolumeTableData> Volumes,
+	const FBoidsVolumeGrid& VolumeGrid,
+	TConstArrayView<FGroupTableData> Groups,
+	const FBoidsGroupResponseMatrix& GroupResponses,
+	const FBoidsCellList& Cells,
+	TArrayView<FBoidTableData> OutBoids)
+{
+	check(InBoids.Num() == OutBoids.Num());
+	check(InBoids.GetData() != OutBoids.GetData());
+
+	const int32 NumBoids = InBoids.Num();
+	if (NumBoids == 0)
+	{
+		return;
+	}
+
+	GatherSortedStreams(InBoids, Cells, GroupResponses);
+
+	const uint32 MaxNeighbourChecks = Params.GetNeighbourCheckLimit();
+	const VectorRegister4Float LaneIndices = MakeVectorRegisterFloat(0.f, 1.f, 2.f, 3.f);
+	const VectorRegister4Float One = VectorOneFloat();
+
+	ParallelFor(FMath::DivideAndRoundUp(NumBoids, BoidsPerTask), [&](int32 TaskIndex)
+	{
+		const int32 Begin = TaskIndex * BoidsPerTask;
+		const int32 End = FMath::Min(Begin + BoidsPerTask, NumBoids);
+		for (int32 BoidIndex = Begin; BoidIndex < End; ++BoidIndex)
+		{
+			const FBoidTableData& Boid = InBoids[BoidIndex];
+			const FGroupTableData& GroupData = Groups[Boid.Group];
+			const int32* FlockRow = FlockTable.GetData() + Boid.Group * BoidsShader::MaxGroups;
+
+			const VectorRegister4Float PositionX = VectorSetFloat1(Boid.Position.X);
+			const VectorRegister4Float PositionY = VectorSetFloat1(Boid.Position.Y);
+			const VectorRegister4Float PositionZ = VectorSetFloat1(Boid.Position.Z);
+			const VectorRegister4Float SeparationRadius = VectorSetFloat1(GroupData.GroupSeparationRadius);
+			const VectorRegister4Float CohesionRadius = VectorSetFloat1(GroupData.GroupCohesionRadius);
+			const VectorRegister4Float AlignmentRadius = VectorSetFloat1(GroupData.GroupAlignmentRadius);
+
+			FNeighbourAccumulator Accumulator;
+
+			const FIntVector CellIndex = BoidsShader::GetCellVector(Boid.Position, Params.CellSize);
+			for (int32 I = -1; I <= 1; ++I)
+			{
+				for (int32 J = -1; J <= 1; ++J)
+				{
+					for (int32 K = -1; K <= 1; ++K)
+					{
+						const uint32 FlatNeighbourIndex = BoidsShader::GetFlatCellIndex(CellIndex + FIntVector(I, J, K));
+						const uint32 NeighbourBegin = Cells.CellOffsetList[FlatNeighbourIndex];
+						const uint32 NeighbourEnd = NeighbourBegin + FMath::Min(Cells.CellBoidCount[FlatNeighbourIndex], MaxNeighbourChecks);
+
+						for (uint32 W = NeighbourBegin; W < NeighbourEnd; W += LaneCount)
+						{
+							// 超出本单元的通道（以及末尾填充）被掩码排除
+							const VectorRegister4Float LaneMask = VectorCompareGT(VectorSetFloat1((float)(NeighbourEnd - W)), LaneIndices);
+							const VectorRegister4Float FlockMask = VectorCastIntToFloat(MakeVectorRegisterInt(
+								FlockRow[SortedGroup[W]], FlockRow[SortedGroup[W + 1]], FlockRow[SortedGroup[W + 2]], FlockRow[SortedGroup[W + 3]]));
+
+							// Delta = Position - Other.Position
+							const VectorRegister4Float DeltaX = VectorSubtract(PositionX, VectorLoad(&SortedPositionX[W]));
+							const VectorRegister4Float DeltaY = VectorSubtract(PositionY, VectorLoad(&SortedPositionY[W]));
+							const VectorRegister4Float DeltaZ = VectorSubtract(PositionZ, VectorLoad(&SortedPositionZ[W]));
+							const VectorRegister4Float Distance = VectorSqrt(VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiplyAdd(DeltaY, DeltaY, VectorMultiply(DeltaZ, DeltaZ))));
+
+							// 位置完全重合（包括自己）时跳过
+							const VectorRegister4Float Valid = VectorBitwiseAnd(VectorBitwiseAnd(LaneMask, FlockMask), VectorCompareGT(Distance, One));
+
+							const VectorRegister4Float SeparationMask = VectorBitwiseAnd(Valid, VectorCompareLT(Distance, SeparationRadius));
+							Accumulator.SeparationX = VectorAdd(Accumulator.SeparationX, VectorBitwiseAnd(SeparationMask, DeltaX));
+							Accumulator.SeparationY = VectorAdd(Accumulator.SeparationY, VectorBitwiseAnd(SeparationMask, DeltaY));
+							Accumulator.SeparationZ = VectorAdd(Accumulator.SeparationZ, VectorBitwiseAnd(SeparationMask, DeltaZ));
+							Accumulator.SeparationCnt = VectorAdd(Accumulator.SeparationCnt, VectorBitwiseAnd(SeparationMask, One));
+
+							// 聚合累加 Other.Position - Position，即减去 Delta
+							const VectorRegister4Float CohesionMask = VectorBitwiseAnd(Valid, VectorCompareLT(Distance, CohesionRadius));
+							Accumulator.CohesionX = VectorSubtract(Accumulator.CohesionX, VectorBitwiseAnd(CohesionMask, DeltaX));
+							Accumulator.CohesionY = VectorSubtract(Accumulator.CohesionY, VectorBitwiseAnd(CohesionMask, DeltaY));
+							Accumulator.CohesionZ = VectorSubtract(Accumulator.CohesionZ, VectorBitwiseAnd(CohesionMask, DeltaZ));
+							Accumulator.CohesionCnt = VectorAdd(Accumulator.CohesionCnt, VectorBitwiseAnd(CohesionMask, One));
+
+							const VectorRegister4Float AlignmentMask = VectorBitwiseAnd(Valid, VectorCompareLT(Distance, AlignmentRadius));
+							Accumulator.AlignmentX = VectorAdd(Accumulator.AlignmentX, VectorBitwiseAnd(AlignmentMask, VectorLoad(&SortedHeadingX[W])));
+							Accumulator.AlignmentY = VectorAdd(Accumulator.AlignmentY, VectorBitwiseAnd(AlignmentMask, VectorLoad(&SortedHeadingY[W])));
+							Accumulator.AlignmentZ = VectorAdd(Accumulator.AlignmentZ, VectorBitwiseAnd(AlignmentMask, VectorLoad(&SortedHeadingZ[W])));
+							Accumulator.AlignmentCnt = VectorAdd(Accumulator.AlignmentCnt, VectorBitwiseAnd(AlignmentMask, One));
+						}
+					}
+				}
+			}
+
+			FBoidsNeighbourSums Sums;
+			Accumulator.Resolve(Sums);
+			FBoidsReferenceStep::FinishBoid(Params, BoidIndex, InBoids, Volumes, VolumeGrid, Groups, Sums, OutBoids[BoidIndex]);
+		}
+	});
+}
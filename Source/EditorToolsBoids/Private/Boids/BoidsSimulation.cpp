@@ -0,0 +1,286 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsSimulation.h"
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsSIMDStep.h"
+#include "Boids/BoidsComputeShader.h"
+#include "Boids/BoidsGPUState.h"
+#include "Types/BoidsTypes.h"
+#include "EditorToolsBoids.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "RenderingThread.h"
+#include "RHI.h"
+
+namespace
+{
+	static TAutoConsoleVariable<int32> CVarBoidsUseGPU(
+		TEXT("r.EditorTools.Boids.UseGPU"),
+		1,
+		TEXT("鱼群模拟是否使用计算着色器。0：始终在 CPU 上计算"),
+		ECVF_Default);
+
+	static TAutoConsoleVariable<int32> CVarBoidsCPUKernel(
+		TEXT("r.EditorTools.Boids.CPUKernel"),
+		1,
+		TEXT("CPU 模式下使用的内核。0：单线程参考实现（与着色器逐句对应）；1：多线程 SIMD 内核"),
+		ECVF_Default);
+}
+
+FBoidsSimulation::FBoidsSimulation()
+	: StepIndex(0)
+	, Generation(0)
+	, bUploadPending(true)
+	, bUsingGPU(false)
+	, bReadbackEnabled(true)
+{
+	SetGroups(TConstArrayView<FBoidGroupSettings>());
+}
+
+FBoidsSimulation::~FBoidsSimulation()
+{
+	if (GPUState.IsValid())
+	{
+		// GPU 状态持有 RHI 资源，必须在渲染线程释放
+		ENQUEUE_RENDER_COMMAND(ReleaseBoidsGPUState)(
+			[State = MoveTemp(GPUState)](FRHICommandListImmediate& RHICmdList) mutable
+			{
+				State.Reset();
+			});
+	}
+}
+
+bool FBoidsSimulation::CanUseGPU()
+{
+	return CVarBoidsUseGPU.GetValueOnGameThread() != 0
+		&& FApp::CanEverRender()
+		&& !GUsingNullRHI
+		&& GDynamicRHI != nullptr
+		&& GMaxRHIFeatureLevel >= ERHIFeatureLevel::SM5;
+}
+
+void FBoidsSimulation::SetBoids(TArray<FBoidTableData>&& InBoids)
+{
+	for (FBoidTableData& Boid : InBoids)
+	{
+		Boid.Group = FMath::Clamp(Boid.Group, 0, BoidsShader::MaxGroups - 1);
+		Boid.NumVolumesAffecting = FMath::Clamp(Boid.NumVolumesAffecting, 0, BoidsShader::MaxVolumes);
+	}
+
+	Boids = MoveTemp(InBoids);
+	OutBoids.Reset();
+	++Generation;
+	bUploadPending = true;
+}
+
+void FBoidsSimulation::AddBoids(TArray<FBoidTableData>&& NewBoids)
+{
+	if (NewBoids.Num() == 0)
+	{
+		return;
+	}
+
+	if (bUsingGPU)
+	{
+		SyncBoidsFromGPU();
+	}
+
+	TArray<FBoidTableData> AllBoids = MoveTemp(Boids);
+	AllBoids.Append(MoveTemp(NewBoids));
+	SetBoids(MoveTemp(AllBoids));
+}
+
+FGroupTableData FBoidsSimulation::MakeGroupTableData(const FBoidGroupSettings& Settings)
+{
+	FGroupTableData Data;
+	FMemory::Memzero(Data);
+	Data.GroupAlignment = Settings.Alignment;
+	Data.GroupCohesion = Settings.Cohesion;
+	Data.GroupSeparation = Settings.Separation;
+	Data.GroupGoal = Settings.Goal;
+	Data.GroupFlee = Settings.Flee;
+	Data.GroupRestriction = Settings.Restriction;
+	Data.GroupSeparationRadius = Settings.SeparationRadius;
+	Data.GroupCohesionRadius = Settings.CohesionRadius;
+	Data.GroupAlignmentRadius = Settings.AlignmentRadius;
+	Data.GroupNonVerticalMovementFactor = Settings.NonVerticalMovementFactor;
+	return Data;
+}
+
+FBoidsGroupResponseMatrix FBoidsSimulation::MakeGroupResponseMatrix(TConstArrayView<FBoidGroupSettings> Settings)
+{
+	static_assert((uint32)EBoidGroupResponse::Flock < (1u << BoidsShader::GroupResponseBits), "EBoidGroupResponse 放不进响应矩阵");
+
+	FBoidsGroupResponseMatrix Matrix;
+	const int32 NumGroups = FMath::Min(Settings.Num(), BoidsShader::MaxGroups);
+	for (int32 GroupIndex = 0; GroupIndex < NumGroups; ++GroupIndex)
+	{
+		const TArray<EBoidGroupResponse>& Responses = Settings[GroupIndex].ResponseToGroups;
+		const int32 NumResponses = FMath::Min(Responses.Num(), BoidsShader::MaxGroups);
+		for (int32 OtherIndex = 0; OtherIndex < NumResponses; ++OtherIndex)
+		{
+			Matrix.Set(GroupIndex, OtherIndex, (uint32)Responses[OtherIndex]);
+		}
+	}
+	return Matrix;
+}
+
+FVolumeTableData FBoidsSimulation::MakeVolumeTableData(const FBoidVolumeSettings& Settings)
+{
+	FVolumeTableData Data;
+	FMemory::Memzero(Data);
+	Data.VolumeType = (int32)Settings.Type;
+	Data.VolumeShape = (int32)Settings.Shape;
+	Data.VolumeUseFalloff = Settings.bUseFalloff ? 1 : 0;
+	Data.VolumeFalloff = Settings.Falloff;
+	Data.VolumeInnerExtents = FVector3f(Settings.InnerExtents);
+	Data.VolumeInnerRadius = Settings.InnerRadius;
+	Data.VolumeOuterExtents = FVector3f(Settings.OuterExtents);
+	Data.VolumeOuterRadius = Settings.OuterRadius;
+	Data.VolumeWorldToLocal = FMatrix44f(Settings.Transform.ToInverseMatrixWithScale());
+	Data.VolumeLocalToWorld = FMatrix44f(Settings.Transform.ToMatrixWithScale());
+	Data.VolumePosition = FVector3f(Settings.Transform.GetLocation());
+	Data.VolumeInfluencesGroups = Settings.InfluencedGroupsMask;
+	Data.VolumeRotation = FVector3f(Settings.Transform.Rotator().Euler());
+	return Data;
+}
+
+void FBoidsSimulation::SetGroups(TConstArrayView<FBoidGroupSettings> Settings)
+{
+	if (Settings.Num() > BoidsShader::MaxGroups)
+	{
+		UE_LOG(LogEditorToolsBoids, Warning, TEXT("鱼群分组数量 %d 超过上限 %d，多出的分组被忽略"), Settings.Num(), BoidsShader::MaxGroups);
+	}
+
+	// 始终填满 MaxGroups 个分组，着色器按鱼的分组索引直接访问，不需要额外的边界检查
+	const FGroupTableData DefaultGroup = MakeGroupTableData(FBoidGroupSettings());
+	Groups.SetNumUninitialized(BoidsShader::MaxGroups);
+	for (int32 GroupIndex = 0; GroupIndex < BoidsShader::MaxGroups; ++GroupIndex)
+	{
+		Groups[GroupIndex] = Settings.IsValidIndex(GroupIndex) ? MakeGroupTableData(Settings[GroupIndex]) : DefaultGroup;
+	}
+	GroupResponses = MakeGroupResponseMatrix(Settings);
+}
+
+void FBoidsSimulation::SetVolumes(TConstArrayView<FBoidVolumeSettings> Settings)
+{
+	Volumes.Reset(Settings.Num());
+	for (const FBoidVolumeSettings& Volume : Settings)
+	{
+		Volumes.Add(MakeVolumeTableData(Volume));
+	}
+	VolumeGrid.Build(Volumes);
+}
+
+void FBoidsSimulation::Step(const FBoidsStepParams& Params)
+{
+	const bool bUseGPU = CanUseGPU();
+	if (bUseGPU != bUsingGPU)
+	{
+		// 切回 CPU 时从 GPU 上的最新状态继续，而不是最近一次（可能已经过时的）回读结果
+		if (bUsingGPU)
+		{
+			SyncBoidsFromGPU();
+		}
+
+		// 切到 GPU 时需要把 CPU 侧状态重新上传；版本递增，切换前还没取走的回读结果会被丢弃
+		++Generation;
+		bUploadPending = true;
+		bUsingGPU = bUseGPU;
+	}
+
+	if (bUsingGPU)
+	{
+		StepGPU(Params);
+	}
+	else
+	{
+		StepCPU(Params);
+	}
+
+	++StepIndex;
+}
+
+void FBoidsSimulation::StepCPU(const FBoidsStepParams& Params)
+{
+	if (Boids.Num() == 0)
+	{
+		return;
+	}
+
+	CellListBuilder.Build(Boids, Params.CellSize, GetShuffleSeed(Params), Cells);
+
+	OutBoids.SetNumUninitialized(Boids.Num());
+	if (CVarBoidsCPUKernel.GetValueOnGameThread() != 0)
+	{
+		SIMDStep.Step(Params, Boids, Volumes, VolumeGrid, Groups, GroupResponses, Cells, OutBoids);
+	}
+	else
+	{
+		FBoidsReferenceStep::Step(Params, Boids, Volumes, VolumeGrid, Groups, GroupResponses, Cells, OutBoids);
+	}
+	Swap(Boids, OutBoids);
+}
+
+void FBoidsSimulation::StepGPU(const FBoidsStepParams& Params)
+{
+	if (!GPUState.IsValid())
+	{
+		GPUState = MakeShared<FBoidsGPUState, ESPMode::ThreadSafe>();
+	}
+
+	// 取回最近完成的 GPU 结果（比 GPU 上的状态晚几帧），只供游戏逻辑查询，模拟本身不依赖它
+	if (!bUploadPending && bReadbackEnabled)
+	{
+		GPUState->ConsumeReadback(Generation, Boids);
+	}
+
+	FBoidsGPUStepInputs Inputs;
+	Inputs.Params = Params;
+	Inputs.NumBoids = Boids.Num();
+	Inputs.Generation = Generation;
+	Inputs.ShuffleSeed = GetShuffleSeed(Params);
+	Inputs.bReadback = bReadbackEnabled;
+	if (bUploadPending)
+	{
+		Inputs.UploadBoids = Boids;
+		bUploadPending = false;
+	}
+	Inputs.Volumes = Volumes;
+	Inputs.VolumeGrid = VolumeGrid;
+	Inputs.Groups = Groups;
+	Inputs.GroupResponses = GroupResponses;
+
+	ENQUEUE_RENDER_COMMAND(BoidsSimulationStep)(
+		[State = GPUState, Inputs = MoveTemp(Inputs)](FRHICommandListImmediate& RHICmdList) mutable
+		{
+			State->Step_RenderThread(RHICmdList, Inputs);
+		});
+}
+
+void FBoidsSimulation::SyncBoidsFromGPU()
+{
+	// 待上传时 CPU 侧就是最新状态
+	if (!GPUState.IsValid() || bUploadPending)
+	{
+		return;
+	}
+
+	TArray<FBoidTableData> GPUBoids;
+	bool bHasGPUBoids = false;
+	ENQUEUE_RENDER_COMMAND(BoidsSimulationSync)(
+		[State = GPUState, SyncGeneration = Generation, &GPUBoids, &bHasGPUBoids](FRHICommandListImmediate& RHICmdList)
+		{
+			bHasGPUBoids = State->ReadBoidsBlocking_RenderThread(RHICmdList, SyncGeneration, GPUBoids);
+		});
+	FlushRenderingCommands();
+
+	if (bHasGPUBoids)
+	{
+		Boids = MoveTemp(GPUBoids);
+	}
+	else
+	{
+		UE_LOG(LogEditorToolsBoids, Warning, TEXT("GPU 上没有当前版本的鱼群状态，继续使用 CPU 侧的副本（%d 条鱼）"), Boids.Num());
+	}
+}
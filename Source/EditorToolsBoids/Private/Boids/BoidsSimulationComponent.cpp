@@ -0,0 +1,112 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsSimulationComponent.h"
+#include "Boids/BoidsSimulationSubsystem.h"
+#include "Engine/World.h"
+#include "Math/RandomStream.h"
+
+UBoidsSimulationComponent::UBoidsSimulationComponent()
+	: CellSize(300.f)
+	, MaxNeighbourChecks(BoidsShader::DefaultMaxNeighbourChecks)
+	, bFullNeighbourEvaluation(false)
+	, CalculationsPerThread(1)
+	, bReadBackToCPU(true)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	bAutoActivate = true;
+}
+
+void UBoidsSimulationComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	RefreshSettings();
+
+	if (UBoidsSimulationSubsystem* Subsystem = UWorld::GetSubsystem<UBoidsSimulationSubsystem>(GetWorld()))
+	{
+		Subsystem->RegisterComponent(this);
+	}
+}
+
+void UBoidsSimulationComponent::OnUnregister()
+{
+	if (UBoidsSimulationSubsystem* Subsystem = UWorld::GetSubsystem<UBoidsSimulationSubsystem>(GetWorld()))
+	{
+		Subsystem->UnregisterComponent(this);
+	}
+
+	Super::OnUnregister();
+}
+
+void UBoidsSimulationComponent::SpawnBoids(int32 Count, int32 Group, FBox Bounds, float Speed, float Turning, float Scale, int32 MeshIndex, int32 RandomSeed)
+{
+	if (Count <= 0 || !Bounds.IsValid)
+	{
+		return;
+	}
+
+	FRandomStream Random(RandomSeed);
+
+	TArray<FBoidTableData> NewBoids;
+	NewBoids.Reserve(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FBoidTableData& Boid = NewBoids.AddZeroed_GetRef();
+		Boid.Position = FVector3f(Random.RandPointInBox(Bounds));
+		Boid.Heading = FVector3f(Random.GetUnitVector());
+		Boid.Scale = Scale;
+		Boid.Turning = Turning;
+		Boid.Speed = Speed;
+		Boid.Group = Group;
+		Boid.MeshIndex = MeshIndex;
+		Boid.Health = 1.f;
+		Boid.MaxHealth = 1.f;
+	}
+
+	Simulation.AddBoids(MoveTemp(NewBoids));
+}
+
+void UBoidsSimulationComponent::ClearBoids()
+{
+	Simulation.SetBoids(TArray<FBoidTableData>());
+}
+
+void UBoidsSimulationComponent::RefreshSettings()
+{
+	Simulation.SetGroups(Groups);
+	Simulation.SetVolumes(Volumes);
+}
+
+int32 UBoidsSimulationComponent::GetBoidCount() const
+{
+	return Simulation.GetNumBoids();
+}
+
+FTransform UBoidsSimulationComponent::GetBoidTransform(int32 BoidIndex) const
+{
+	TConstArrayView<FBoidTableData> Boids = Simulation.GetBoids();
+	if (!Boids.IsValidIndex(BoidIndex))
+	{
+		return FTransform::Identity;
+	}
+
+	const FBoidTableData& Boid = Boids[BoidIndex];
+	return FTransform(FRotationMatrix::MakeFromX(FVector(Boid.Heading)).ToQuat(), FVector(Boid.Position), FVector(Boid.Scale));
+}
+
+bool UBoidsSimulationComponent::IsSimulatingOnGPU() const
+{
+	return Simulation.IsUsingGPU();
+}
+
+void UBoidsSimulationComponent::StepSimulation(float DeltaSeconds)
+{
+	FBoidsStepParams Params;
+	Params.DeltaSeconds = DeltaSeconds;
+	Params.CellSize = FMath::Max(CellSize, 1.f);
+	Params.MaxNeighbourChecks = FMath::Max(MaxNeighbourChecks, 1);
+	Params.bFullNeighbourEvaluation = bFullNeighbourEvaluation;
+	Params.CalculationsPerThread = FMath::Max(CalculationsPerThread, 1);
+	Simulation.SetReadbackEnabled(bReadBackToCPU);
+	Simulation.Step(Params);
+}
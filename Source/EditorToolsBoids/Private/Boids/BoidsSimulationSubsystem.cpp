@@ -0,0 +1,46 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsSimulationSubsystem.h"
+#include "Boids/BoidsSimulationComponent.h"
+
+void UBoidsSimulationSubsystem::RegisterComponent(UBoidsSimulationComponent* Component)
+{
+	Components.AddUnique(Component);
+}
+
+void UBoidsSimulationSubsystem::UnregisterComponent(UBoidsSimulationComponent* Component)
+{
+	Components.Remove(Component);
+}
+
+void UBoidsSimulationSubsystem::Deinitialize()
+{
+	Components.Reset();
+
+	Super::Deinitialize();
+}
+
+void UBoidsSimulationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	for (int32 Index = Components.Num() - 1; Index >= 0; --Index)
+	{
+		UBoidsSimulationComponent* Component = Components[Index].Get();
+		if (!Component)
+		{
+			Components.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (Component->IsActive())
+		{
+			Component->StepSimulation(DeltaTime);
+		}
+	}
+}
+
+TStatId UBoidsSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBoidsSimulationSubsystem, STATGROUP_Tickables);
+}
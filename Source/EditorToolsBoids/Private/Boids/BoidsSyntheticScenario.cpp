@@ -0,0 +1,82 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsSyntheticScenario.h"
+#include "Boids/BoidsSimulation.h"
+#include "Types/BoidsTypes.h"
+#include "Math/RandomStream.h"
+
+FBoidsSyntheticScenario FBoidsSyntheticScenario::Make(int32 NumBoids, float BoidsPerCell, int32 NumGroups, int32 NumVolumes, int32 RandomSeed)
+{
+	NumBoids = FMath::Max(NumBoids, 0);
+	NumGroups = FMath::Clamp(NumGroups, 1, BoidsShader::MaxGroups);
+
+	FBoidsSyntheticScenario Scenario;
+	Scenario.Params.DeltaSeconds = 1.f / 60.f;
+	Scenario.Params.CellSize = 300.f;
+
+	// 边长 = 单元大小 * (单元数)^(1/3)，单元数 = 鱼数 / 密度
+	const double NumCells = FMath::Max(1.0, NumBoids / (double)FMath::Max(BoidsPerCell, 0.01f));
+	const double HalfExtent = 0.5 * Scenario.Params.CellSize * FMath::Pow(NumCells, 1.0 / 3.0);
+	Scenario.Bounds = FBox(FVector(-HalfExtent), FVector(HalfExtent));
+
+	FRandomStream Random(RandomSeed);
+	Scenario.Boids.SetNumZeroed(NumBoids);
+	for (int32 Index = 0; Index < NumBoids; ++Index)
+	{
+		FBoidTableData& Boid = Scenario.Boids[Index];
+		Boid.Position = FVector3f(Random.RandPointInBox(Scenario.Bounds));
+		Boid.Heading = FVector3f(Random.GetUnitVector());
+		Boid.Scale = 1.f;
+		Boid.Turning = 90.f;
+		Boid.Speed = Random.FRandRange(200.f, 400.f);
+		Boid.Group = Index % NumGroups;
+		Boid.Health = 1.f;
+		Boid.MaxHealth = 1.f;
+	}
+
+	TArray<FBoidGroupSettings> GroupSettings;
+	GroupSettings.SetNum(NumGroups);
+	for (FBoidGroupSettings& Group : GroupSettings)
+	{
+		Group.ResponseToGroups.Init(EBoidGroupResponse::Flock, NumGroups);
+	}
+
+	// 与 FBoidsSimulation::SetGroups 相同：始终填满 MaxGroups 个分组
+	const FGroupTableData DefaultGroup = FBoidsSimulation::MakeGroupTableData(FBoidGroupSettings());
+	Scenario.Groups.SetNumUninitialized(BoidsShader::MaxGroups);
+	for (int32 Index = 0; Index < BoidsShader::MaxGroups; ++Index)
+	{
+		Scenario.Groups[Index] = GroupSettings.IsValidIndex(Index) ? FBoidsSimulation::MakeGroupTableData(GroupSettings[Index]) : DefaultGroup;
+	}
+	Scenario.GroupResponses = FBoidsSimulation::MakeGroupResponseMatrix(GroupSettings);
+
+	FBoidVolumeSettings Goal;
+	Goal.Type = EBoidVolumeType::Goal;
+	Goal.Shape = EBoidVolumeShape::Sphere;
+	Goal.InnerRadius = HalfExtent * 0.25;
+	Goal.OuterRadius = HalfExtent * 0.5;
+	Scenario.Volumes.Add(FBoidsSimulation::MakeVolumeTableData(Goal));
+
+	FBoidVolumeSettings Restriction;
+	Restriction.Type = EBoidVolumeType::Restriction;
+	Restriction.Shape = EBoidVolumeShape::Box;
+	Restriction.InnerExtents = FVector(HalfExtent);
+	Restriction.OuterExtents = FVector(HalfExtent * 1.1);
+	Scenario.Volumes.Add(FBoidsSimulation::MakeVolumeTableData(Restriction));
+
+	// 其余体积：场景内随机的小球体，每个单元大小的几倍
+	for (int32 Index = Scenario.Volumes.Num(); Index < NumVolumes; ++Index)
+	{
+		FBoidVolumeSettings Extra;
+		Extra.Type = Random.FRand() < 0.5f ? EBoidVolumeType::Goal : EBoidVolumeType::Flee;
+		Extra.Shape = EBoidVolumeShape::Sphere;
+		Extra.Transform.SetLocation(Random.RandPointInBox(Scenario.Bounds));
+		Extra.OuterRadius = Scenario.Params.CellSize * Random.FRandRange(1.f, 4.f);
+		Extra.InnerRadius = Extra.OuterRadius * 0.5f;
+		Scenario.Volumes.Add(FBoidsSimulation::MakeVolumeTableData(Extra));
+	}
+
+	Scenario.VolumeGrid.Build(Scenario.Volumes);
+
+	return Scenario;
+}
@@ -0,0 +1,160 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsVolumeGrid.h"
+#include "Types/BoidsTypes.h"
+
+namespace
+{
+	// 格子总数上限，体积再多网格也不会超过这个大小
+	constexpr int32 MaxGridCells = 4096;
+
+	// 单轴格子数上限
+	constexpr int32 MaxGridDim = 64;
+
+	// 包围盒向外扩一点，避免变换的浮点误差把边界上的鱼漏掉
+	constexpr float BoundsPadding = 1.0f;
+
+	/** 体积外边界的世界空间包围盒 */
+	static FBox3f GetOuterBounds(const FVolumeTableData& Volume)
+	{
+		FVector3f LocalExtents;
+		if (Volume.VolumeShape == (int32)EBoidVolumeShape::Sphere)
+		{
+			LocalExtents = FVector3f(Volume.VolumeOuterRadius);
+		}
+		else if (Volume.VolumeShape == (int32)EBoidVolumeShape::Box)
+		{
+			LocalExtents = Volume.VolumeOuterExtents;
+		}
+		else
+		{
+			// 未知形状没有影响
+			return FBox3f(ForceInit);
+		}
+
+		return FBox3f(-LocalExtents, LocalExtents).TransformBy(Volume.VolumeLocalToWorld).ExpandBy(BoundsPadding);
+	}
+}
+
+void FBoidsVolumeGrid::Build(TConstArrayView<FVolumeTableData> Volumes)
+{
+	Min = FVector3f::ZeroVector;
+	InvCellSize = FVector3f::ZeroVector;
+	Dims = FIntVector::ZeroValue;
+	CellRanges.Reset();
+	VolumeIndices.Reset();
+	RestrictionGroupsMask = 0;
+
+	TArray<FBox3f, TInlineAllocator<64>> VolumeBounds;
+	VolumeBounds.SetNumUninitialized(Volumes.Num());
+	FBox3f GridBounds(ForceInit);
+	for (int32 V = 0; V < Volumes.Num(); ++V)
+	{
+		VolumeBounds[V] = GetOuterBounds(Volumes[V]);
+		if (VolumeBounds[V].IsValid)
+		{
+			GridBounds += VolumeBounds[V];
+		}
+	}
+
+	if (GridBounds.IsValid)
+	{
+		// 格子尽量接近立方体，总数不超过 MaxGridCells
+		const FVector3f Size = GridBounds.GetSize().ComponentMax(FVector3f(1.0f));
+		const float CellSize = FMath::Max(FMath::Pow(Size.X * Size.Y * Size.Z / MaxGridCells, 1.0f / 3.0f), 1.0f);
+		Dims = FIntVector(
+			FMath::Clamp(FMath::CeilToInt32(Size.X / CellSize), 1, MaxGridDim),
+			FMath::Clamp(FMath::CeilToInt32(Size.Y / CellSize), 1, MaxGridDim),
+			FMath::Clamp(FMath::CeilToInt32(Size.Z / CellSize), 1, MaxGridDim));
+		while (Dims.X * Dims.Y * Dims.Z > MaxGridCells)
+		{
+			Dims = FIntVector(FMath::Max(Dims.X - 1, 1), FMath::Max(Dims.Y - 1, 1), FMath::Max(Dims.Z - 1, 1));
+		}
+
+		Min = GridBounds.Min;
+		InvCellSize = FVector3f((float)Dims.X / Size.X, (float)Dims.Y / Size.Y, (float)Dims.Z / Size.Z);
+
+		// 先统计每个格子的体积数，再按体积升序填表，两次遍历的格子范围完全相同
+		const int32 NumCells = Dims.X * Dims.Y * Dims.Z;
+		CellRanges.SetNumZeroed(NumCells);
+
+		auto ForEachOverlappedCell = [this](const FBox3f& Bounds, auto&& Func)
+		{
+			const FVector3f LocalMin = (Bounds.Min - Min) * InvCellSize;
+			const FVector3f LocalMax = (Bounds.Max - Min) * InvCellSize;
+			const FIntVector CellMin(
+				FMath::Clamp(FMath::FloorToInt32(LocalMin.X), 0, Dims.X - 1),
+				FMath::Clamp(FMath::FloorToInt32(LocalMin.Y), 0, Dims.Y - 1),
+				FMath::Clamp(FMath::FloorToInt32(LocalMin.Z), 0, Dims.Z - 1));
+			const FIntVector CellMax(
+				FMath::Clamp(FMath::FloorToInt32(LocalMax.X), 0, Dims.X - 1),
+				FMath::Clamp(FMath::FloorToInt32(LocalMax.Y), 0, Dims.Y - 1),
+				FMath::Clamp(FMath::FloorToInt32(LocalMax.Z), 0, Dims.Z - 1));
+
+			for (int32 Z = CellMin.Z; Z <= CellMax.Z; ++Z)
+			{
+				for (int32 Y = CellMin.Y; Y <= CellMax.Y; ++Y)
+				{
+					for (int32 X = CellMin.X; X <= CellMax.X; ++X)
+					{
+						Func((Z * Dims.Y + Y) * Dims.X + X);
+					}
+				}
+			}
+		};
+
+		for (const FBox3f& Bounds : VolumeBounds)
+		{
+			if (Bounds.IsValid)
+			{
+				ForEachOverlappedCell(Bounds, [this](int32 Cell) { ++CellRanges[Cell].Y; });
+			}
+		}
+
+		uint32 Offset = 0;
+		for (FUintVector2& Range : CellRanges)
+		{
+			Range.X = Offset;
+			Offset += Range.Y;
+			Range.Y = 0;
+		}
+
+		VolumeIndices.SetNumUninitialized(Offset);
+		for (int32 V = 0; V < Volumes.Num(); ++V)
+		{
+			if (VolumeBounds[V].IsValid)
+			{
+				ForEachOverlappedCell(VolumeBounds[V], [this, V](int32 Cell)
+				{
+					FUintVector2& Range = CellRanges[Cell];
+					VolumeIndices[Range.X + Range.Y++] = V;
+				});
+			}
+		}
+	}
+
+	// 限制体积列表包含所有限制体积（包括未知形状的），与原来逐个遍历时参与最近点比较的集合相同
+	RestrictionOffset = VolumeIndices.Num();
+	for (int32 V = 0; V < Volumes.Num(); ++V)
+	{
+		if (Volumes[V].VolumeType == (int32)EBoidVolumeType::Restriction)
+		{
+			VolumeIndices.Add(V);
+			RestrictionGroupsMask |= Volumes[V].VolumeInfluencesGroups;
+		}
+	}
+	RestrictionCount = VolumeIndices.Num() - RestrictionOffset;
+}
+
+TConstArrayView<uint32> FBoidsVolumeGrid::GetCellVolumes(const FVector3f& Position) const
+{
+	const FVector3f Local = (Position - Min) * InvCellSize;
+	const FIntVector Cell(FMath::FloorToInt32(Local.X), FMath::FloorToInt32(Local.Y), FMath::FloorToInt32(Local.Z));
+	if (Cell.X < 0 || Cell.Y < 0 || Cell.Z < 0 || Cell.X >= Dims.X || Cell.Y >= Dims.Y || Cell.Z >= Dims.Z)
+	{
+		return TConstArrayView<uint32>();
+	}
+
+	const FUintVector2& Range = CellRanges[(Cell.Z * Dims.Y + Cell.Y) * Dims.X + Cell.X];
+	return TConstArrayView<uint32>(VolumeIndices.GetData() + Range.X, Range.Y);
+}
@@ -0,0 +1,32 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "EditorToolsBoids.h"
+
+#include "Interfaces/IPluginManager.h"
+#include "Misc/Paths.h"
+#include "ShaderCore.h"
+
+IMPLEMENT_MODULE(FEditorToolsBoidsModule, EditorToolsBoids)
+DEFINE_LOG_CATEGORY(LogEditorToolsBoids);
+
+void FEditorToolsBoidsModule::StartupModule()
+{
+	// 插件带 Shaders 目录时引擎会自动映射 /Plugin/EditorTools，这里只做兜底
+	static const FString VirtualShaderDirectory = TEXT("/Plugin/EditorTools");
+	if (!AllShaderSourceDirectoryMappings().Contains(VirtualShaderDirectory))
+	{
+		TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("EditorTools"));
+		if (Plugin.IsValid())
+		{
+			AddShaderSourceDirectoryMapping(VirtualShaderDirectory, FPaths::Combine(Plugin->GetBaseDir(), TEXT("Shaders")));
+		}
+		else
+		{
+			UE_LOG(LogEditorToolsBoids, Error, TEXT("无法找到 EditorTools 插件，鱼群着色器目录未映射"));
+		}
+	}
+}
+
+void FEditorToolsBoidsModule::ShutdownModule()
+{
+}
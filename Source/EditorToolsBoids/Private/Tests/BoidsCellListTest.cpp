@@ -0,0 +1,81 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsCellList.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 并行构建器与串行计数排序的比较
+namespace
+{
+	// 超过 16 位索引上限，并且足够分成多块并行统计
+	constexpr int32 CellListTestBoids = 200000;
+
+	/** 串行计数排序，桶内排名为 N 的鱼放到 (N + ShuffleSeed) % Count 的位置 */
+	static void BuildSerial(TConstArrayView<FBoidTableData> Boids, float CellSize, uint32 ShuffleSeed, FBoidsCellList& OutCells)
+	{
+		TArray<uint32> BoidCells;
+		BoidCells.SetNumUninitialized(Boids.Num());
+		OutCells.CellBoidCount.SetNumZeroed(BoidsShader::TotalCells);
+		for (int32 BoidIndex = 0; BoidIndex < Boids.Num(); ++BoidIndex)
+		{
+			BoidCells[BoidIndex] = BoidsShader::GetFlatCellIndex(BoidsShader::GetCellVector(Boids[BoidIndex].Position, CellSize));
+			++OutCells.CellBoidCount[BoidCells[BoidIndex]];
+		}
+
+		OutCells.CellOffsetList.SetNumUninitialized(BoidsShader::TotalCells);
+		uint32 Offset = 0;
+		for (int32 Cell = 0; Cell < BoidsShader::TotalCells; ++Cell)
+		{
+			OutCells.CellOffsetList[Cell] = Offset;
+			Offset += OutCells.CellBoidCount[Cell];
+		}
+
+		TArray<uint32> Cursors;
+		Cursors.SetNumZeroed(BoidsShader::TotalCells);
+		OutCells.SortedCellList.SetNumUninitialized(Boids.Num());
+		for (int32 BoidIndex = 0; BoidIndex < Boids.Num(); ++BoidIndex)
+		{
+			const uint32 Cell = BoidCells[BoidIndex];
+			const uint32 Slot = (Cursors[Cell]++ + ShuffleSeed) % OutCells.CellBoidCount[Cell];
+			OutCells.SortedCellList[OutCells.CellOffsetList[Cell] + Slot] = (uint32)BoidIndex;
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsCellListBuilderTest, "EditorTools.Boids.CellList.MatchesSerial", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsCellListBuilderTest::RunTest(const FString& Parameters)
+{
+	const float CellSize = 300.f;
+
+	FRandomStream Random(CellListTestBoids);
+	const FBox SpawnBounds(FVector(-20000.f), FVector(20000.f));
+	TArray<FBoidTableData> Boids;
+	Boids.SetNumZeroed(CellListTestBoids);
+	for (FBoidTableData& Boid : Boids)
+	{
+		Boid.Position = FVector3f(Random.RandPointInBox(SpawnBounds));
+	}
+
+	// 同一个构建器连续构建，确认复用的中间缓冲区不会残留上一帧的结果
+	FBoidsCellListBuilder Builder;
+	for (const uint32 ShuffleSeed : { 0u, 7u })
+	{
+		FBoidsCellList Expected;
+		BuildSerial(Boids, CellSize, ShuffleSeed, Expected);
+
+		FBoidsCellList Actual;
+		Builder.Build(Boids, CellSize, ShuffleSeed, Actual);
+
+		const FString Context = FString::Printf(TEXT("shuffle seed %u"), ShuffleSeed);
+		TestTrue(*(TEXT("CellBoidCount matches, ") + Context), Expected.CellBoidCount == Actual.CellBoidCount);
+		TestTrue(*(TEXT("CellOffsetList matches, ") + Context), Expected.CellOffsetList == Actual.CellOffsetList);
+		TestTrue(*(TEXT("SortedCellList matches, ") + Context), Expected.SortedCellList == Actual.SortedCellList);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsComputeShader.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsSimulation.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 用合成数据比较 GPU 单元表和 CPU 构建器的结果
+namespace
+{
+	static void CopyReadback(FRHIGPUBufferReadback& Readback, int32 NumElements, TArray<uint32>& OutData)
+	{
+		const uint32 NumBytes = NumElements * sizeof(uint32);
+		OutData.SetNumUninitialized(NumElements);
+		FMemory::Memcpy(OutData.GetData(), Readback.Lock(NumBytes), NumBytes);
+		Readback.Unlock();
+	}
+
+	constexpr int32 GPUCellListTestBoids = 100000;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsGPUCellListTest, "EditorTools.Boids.GPUCellList", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsGPUCellListTest::RunTest(const FString& Parameters)
+{
+	if (!FBoidsSimulation::CanUseGPU())
+	{
+		AddInfo(TEXT("当前 RHI 不支持鱼群计算着色器（-nullrhi 或特性等级低于 SM5），跳过 GPU 单元表校验"));
+		return true;
+	}
+
+	const int32 NumBoids = GPUCellListTestBoids;
+	const float CellSize = 300.f;
+	const uint32 ShuffleSeed = 7;
+
+	// 合成鱼群：位置覆盖负坐标，让哈希经过取模后取绝对值的分支
+	FRandomStream Random(NumBoids);
+	const FBox SpawnBounds(FVector(-20000.f), FVector(20000.f));
+	TArray<FBoidTableData> Boids;
+	Boids.SetNumZeroed(NumBoids);
+	for (FBoidTableData& Boid : Boids)
+	{
+		Boid.Position = FVector3f(Random.RandPointInBox(SpawnBounds));
+	}
+
+	FBoidsCellList Expected;
+	Expected.Build(Boids, CellSize, ShuffleSeed);
+
+	FBoidsCellList Actual;
+	ENQUEUE_RENDER_COMMAND(BoidsGPUCellListTest)(
+		[&Boids, &Actual, NumBoids, CellSize, ShuffleSeed](FRHICommandListImmediate& RHICmdList)
+		{
+			FRHIGPUBufferReadback SortedReadback(TEXT("Boids.Test.SortedCellList"));
+			FRHIGPUBufferReadback OffsetReadback(TEXT("Boids.Test.CellOffsetList"));
+			FRHIGPUBufferReadback CountReadback(TEXT("Boids.Test.CellBoidCount"));
+			{
+				FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("BoidsTestCellList"));
+				FRDGBufferRef BoidBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("Boids.BoidData"), sizeof(FBoidTableData), NumBoids, Boids.GetData(), NumBoids * sizeof(FBoidTableData), ERDGInitialDataFlags::NoCopy);
+				const FBoidsCellListRDG Cells = AddBuildCellListPasses(GraphBuilder, BoidBuffer, NumBoids, CellSize, ShuffleSeed);
+				AddEnqueueCopyPass(GraphBuilder, &SortedReadback, Cells.SortedCellList, NumBoids * sizeof(uint32));
+				AddEnqueueCopyPass(GraphBuilder, &OffsetReadback, Cells.CellOffsetList, BoidsShader::TotalCells * sizeof(uint32));
+				AddEnqueueCopyPass(GraphBuilder, &CountReadback, Cells.CellBoidCount, BoidsShader::TotalCells * sizeof(uint32));
+				GraphBuilder.Execute();
+			}
+
+			// 测试中直接等 GPU 完成
+			RHICmdList.SubmitCommandsAndFlushGPU();
+			RHICmdList.BlockUntilGPUIdle();
+
+			CopyReadback(SortedReadback, NumBoids, Actual.SortedCellList);
+			CopyReadback(OffsetReadback, BoidsShader::TotalCells, Actual.CellOffsetList);
+			CopyReadback(CountReadback, BoidsShader::TotalCells, Actual.CellBoidCount);
+		});
+	FlushRenderingCommands();
+
+	int32 NumMismatchedCells = 0;
+	for (int32 Cell = 0; Cell < BoidsShader::TotalCells; ++Cell)
+	{
+		// 空单元的偏移不会被读取，两边不要求一致
+		if (Expected.CellBoidCount[Cell] != Actual.CellBoidCount[Cell]
+			|| (Expected.CellBoidCount[Cell] > 0 && Expected.CellOffsetList[Cell] != Actual.CellOffsetList[Cell]))
+		{
+			++NumMismatchedCells;
+		}
+	}
+
+	int32 NumMismatchedBoids = 0;
+	for (int32 Index = 0; Index < NumBoids; ++Index)
+	{
+		if (Expected.SortedCellList[Index] != Actual.SortedCellList[Index])
+		{
+			++NumMismatchedBoids;
+		}
+	}
+
+	TestEqual(TEXT("Cells with mismatched offset or count"), NumMismatchedCells, 0);
+	TestEqual(TEXT("Boids with mismatched sorted position"), NumMismatchedBoids, 0);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,108 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsComputeShader.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsSimulation.h"
+#include "Boids/BoidsSyntheticScenario.h"
+#include "Misc/AutomationTest.h"
+#include "RenderGraphBuilder.h"
+#include "RenderGraphUtils.h"
+#include "RenderingThread.h"
+#include "RHIGPUReadback.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// 用同一份输入分别跑一步 GPU 模拟和 CPU 参考实现，比较结果
+namespace
+{
+	constexpr int32 GPUStepTestBoids = 16384;
+
+	// GPU 的 sqrt/normalize 精度由驱动决定，恰好落在半径阈值上的邻居可能一边算入一边不算，允许极少数这样的离群值
+	constexpr float GPUStepHeadingTolerance = 1e-3f;
+	constexpr float GPUStepPositionTolerance = 1e-2f;
+	constexpr int32 GPUStepMaxOutliersPerMille = 1;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsGPUStepTest, "EditorTools.Boids.ReferenceStep.MatchesGPU", EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FBoidsGPUStepTest::RunTest(const FString& Parameters)
+{
+	if (!FBoidsSimulation::CanUseGPU())
+	{
+		AddInfo(TEXT("当前 RHI 不支持鱼群计算着色器（-nullrhi 或特性等级低于 SM5），跳过 GPU 与参考实现的比较"));
+		return true;
+	}
+
+	// 截断模式走按鱼调度的内核并轮转单元表，完整邻居模式走分块内核
+	const FBoidsSyntheticScenario Scenario = FBoidsSyntheticScenario::Make(GPUStepTestBoids, 8.f, 2, 6);
+	const int32 NumBoids = Scenario.Boids.Num();
+
+	for (const bool bFullNeighbourEvaluation : { false, true })
+	{
+		FBoidsStepParams Params = Scenario.Params;
+		Params.bFullNeighbourEvaluation = bFullNeighbourEvaluation;
+		const uint32 ShuffleSeed = bFullNeighbourEvaluation ? 0 : 7;
+
+		FBoidsCellList Cells;
+		Cells.Build(Scenario.Boids, Params.CellSize, ShuffleSeed);
+
+		TArray<FBoidTableData> Expected;
+		Expected.SetNumZeroed(NumBoids);
+		FBoidsReferenceStep::Step(Params, Scenario.Boids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, Expected);
+
+		TArray<FBoidTableData> Actual;
+		ENQUEUE_RENDER_COMMAND(BoidsGPUStepTest)(
+			[&Scenario, &Params, &Actual, NumBoids, ShuffleSeed](FRHICommandListImmediate& RHICmdList)
+			{
+				FRHIGPUBufferReadback Readback(TEXT("Boids.Test.OutBoidData"));
+				{
+					FRDGBuilder GraphBuilder(RHICmdList, RDG_EVENT_NAME("BoidsTestStep"));
+					FRDGBufferRef InBoidBuffer = CreateStructuredBuffer(GraphBuilder, TEXT("Boids.BoidData"), sizeof(FBoidTableData), NumBoids, Scenario.Boids.GetData(), NumBoids * sizeof(FBoidTableData), ERDGInitialDataFlags::NoCopy);
+					FRDGBufferRef OutBoidBuffer = GraphBuilder.CreateBuffer(FRDGBufferDesc::CreateStructuredDesc(sizeof(FBoidTableData), NumBoids), TEXT("Boids.OutBoidData"));
+					AddBoidsStepPasses(GraphBuilder, InBoidBuffer, OutBoidBuffer, NumBoids, Params, ShuffleSeed, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses);
+					AddEnqueueCopyPass(GraphBuilder, &Readback, OutBoidBuffer, NumBoids * sizeof(FBoidTableData));
+					GraphBuilder.Execute();
+				}
+
+				// 测试中直接等 GPU 完成
+				RHICmdList.SubmitCommandsAndFlushGPU();
+				RHICmdList.BlockUntilGPUIdle();
+
+				const uint32 NumBytes = NumBoids * sizeof(FBoidTableData);
+				Actual.SetNumUninitialized(NumBoids);
+				FMemory::Memcpy(Actual.GetData(), Readback.Lock(NumBytes), NumBytes);
+				Readback.Unlock();
+			});
+		FlushRenderingCommands();
+
+		const TCHAR* ModeName = bFullNeighbourEvaluation ? TEXT("full") : TEXT("truncated");
+		int32 NumOutliers = 0;
+		for (int32 Index = 0; Index < NumBoids; ++Index)
+		{
+			const FBoidTableData& A = Expected[Index];
+			const FBoidTableData& B = Actual[Index];
+			const bool bMatches = A.Heading.Equals(B.Heading, GPUStepHeadingTolerance)
+				&& A.Position.Equals(B.Position, GPUStepPositionTolerance)
+				&& A.Action == B.Action
+				&& A.NumVolumesAffecting == B.NumVolumesAffecting
+				&& A.Speed == B.Speed
+				&& A.Group == B.Group;
+			if (!bMatches)
+			{
+				if (NumOutliers == 0)
+				{
+					AddInfo(FString::Printf(TEXT("%s 模式第一个不一致的鱼 %d：参考朝向 %s 位置 %s，GPU 朝向 %s 位置 %s"),
+						ModeName, Index, *A.Heading.ToString(), *A.Position.ToString(), *B.Heading.ToString(), *B.Position.ToString()));
+				}
+				++NumOutliers;
+			}
+		}
+
+		TestTrue(FString::Printf(TEXT("Boids outside tolerance (%s, %d of %d)"), ModeName, NumOutliers, NumBoids), NumOutliers * 1000 <= NumBoids * GPUStepMaxOutliersPerMille);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,235 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Boids/BoidsReferenceStep.h"
+#include "Boids/BoidsSIMDStep.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsVolumeGrid.h"
+#include "Boids/BoidsSyntheticScenario.h"
+#include "Types/BoidsTypes.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// CPU 参考实现只依赖纯数据，-nullrhi 下同样可以运行
+namespace
+{
+	constexpr EAutomationTestFlags BoidsReferenceTestFlags = EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter;
+
+	/** 只有分离生效的分组，其余权重和半径为 0 */
+	static FGroupTableData MakeSeparationOnlyGroup(float SeparationRadius)
+	{
+		FGroupTableData Group;
+		FMemory::Memzero(Group);
+		Group.GroupSeparation = 1.0f;
+		Group.GroupSeparationRadius = SeparationRadius;
+		return Group;
+	}
+
+	static FBoidTableData MakeBoid(const FVector3f& Position, const FVector3f& Heading, float Speed, float Turning)
+	{
+		FBoidTableData Boid;
+		FMemory::Memzero(Boid);
+		Boid.Position = Position;
+		Boid.Heading = Heading;
+		Boid.Speed = Speed;
+		Boid.Turning = Turning;
+		Boid.Scale = 1.0f;
+		return Boid;
+	}
+
+	/** 单个分组、没有体积的最小场景走一步 */
+	static TArray<FBoidTableData> StepWithoutVolumes(const FBoidsStepParams& Params, const TArray<FBoidTableData>& Boids, const FGroupTableData& GroupData)
+	{
+		TArray<FGroupTableData> Groups;
+		Groups.Init(GroupData, BoidsShader::MaxGroups);
+
+		FBoidsGroupResponseMatrix GroupResponses;
+		GroupResponses.Set(0, 0, (uint32)EBoidGroupResponse::Flock);
+
+		FBoidsVolumeGrid VolumeGrid;
+		VolumeGrid.Build(TConstArrayView<FVolumeTableData>());
+
+		FBoidsCellList Cells;
+		Cells.Build(Boids, Params.CellSize, 0);
+
+		TArray<FBoidTableData> OutBoids;
+		OutBoids.SetNumZeroed(Boids.Num());
+		FBoidsReferenceStep::Step(Params, Boids, TConstArrayView<FVolumeTableData>(), VolumeGrid, Groups, GroupResponses, Cells, OutBoids);
+		return OutBoids;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsReferenceStepStraightLineTest, "EditorTools.Boids.ReferenceStep.StraightLine", BoidsReferenceTestFlags)
+
+bool FBoidsReferenceStepStraightLineTest::RunTest(const FString& Parameters)
+{
+	// 没有邻居和体积：朝向不变，沿朝向移动 Speed * DeltaSeconds
+	FBoidsStepParams Params;
+	Params.DeltaSeconds = 0.1f;
+
+	const TArray<FBoidTableData> Boids = { MakeBoid(FVector3f(100.0f, 200.0f, 300.0f), FVector3f(1.0f, 0.0f, 0.0f), 100.0f, 90.0f) };
+	const TArray<FBoidTableData> OutBoids = StepWithoutVolumes(Params, Boids, MakeSeparationOnlyGroup(50.0f));
+
+	TestEqual(TEXT("Position"), FVector(OutBoids[0].Position), FVector(110.0, 200.0, 300.0), 1e-4f);
+	TestEqual(TEXT("Heading"), FVector(OutBoids[0].Heading), FVector(1.0, 0.0, 0.0), 1e-6f);
+	TestEqual(TEXT("Speed"), OutBoids[0].Speed, 100.0f);
+	TestEqual(TEXT("Action"), OutBoids[0].Action, 0);
+	TestEqual(TEXT("NumVolumesAffecting"), OutBoids[0].NumVolumesAffecting, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsReferenceStepSeparationTest, "EditorTools.Boids.ReferenceStep.Separation", BoidsReferenceTestFlags)
+
+bool FBoidsReferenceStepSeparationTest::RunTest(const FString& Parameters)
+{
+	// 两条鱼沿 +Y 并排游动，分离半径内互相推开：
+	// 目标朝向为 normalize((0,1,0) ± (1,0,0))，每步最多转 DeltaSeconds * Turning / 360 弧度
+	FBoidsStepParams Params;
+	Params.DeltaSeconds = 0.1f;
+	const float Speed = 100.0f;
+	const float Turning = 90.0f;
+
+	const TArray<FBoidTableData> Boids = {
+		MakeBoid(FVector3f(0.0f, 0.0f, 0.0f), FVector3f(0.0f, 1.0f, 0.0f), Speed, Turning),
+		MakeBoid(FVector3f(50.0f, 0.0f, 0.0f), FVector3f(0.0f, 1.0f, 0.0f), Speed, Turning),
+	};
+	const TArray<FBoidTableData> OutBoids = StepWithoutVolumes(Params, Boids, MakeSeparationOnlyGroup(100.0f));
+
+	const float Theta = Params.DeltaSeconds * Turning / 360.0f;
+	const FVector3f ExpectedHeadingA(-FMath::Sin(Theta), FMath::Cos(Theta), 0.0f);
+	const FVector3f ExpectedHeadingB(FMath::Sin(Theta), FMath::Cos(Theta), 0.0f);
+
+	TestEqual(TEXT("Heading A"), FVector(OutBoids[0].Heading), FVector(ExpectedHeadingA), 1e-5f);
+	TestEqual(TEXT("Heading B"), FVector(OutBoids[1].Heading), FVector(ExpectedHeadingB), 1e-5f);
+	TestEqual(TEXT("Position A"), FVector(OutBoids[0].Position), FVector(ExpectedHeadingA * Params.DeltaSeconds * Speed), 1e-4f);
+	TestEqual(TEXT("Position B"), FVector(OutBoids[1].Position), FVector(FVector3f(50.0f, 0.0f, 0.0f) + ExpectedHeadingB * Params.DeltaSeconds * Speed), 1e-4f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsReferenceStepInvariantsTest, "EditorTools.Boids.ReferenceStep.Invariants", BoidsReferenceTestFlags)
+
+bool FBoidsReferenceStepInvariantsTest::RunTest(const FString& Parameters)
+{
+	const int32 NumSteps = 60;
+	// 合成场景：体积 1 是包住场景的限制盒，外边界为场景半边长的 1.1 倍
+	FBoidsSyntheticScenario Scenario = FBoidsSyntheticScenario::Make(512, 8.0f, 2, 6, 3);
+	const FBoidsStepParams& Params = Scenario.Params;
+	const FVector3f OuterExtents = Scenario.Volumes[1].VolumeOuterExtents;
+
+	float MaxSpeed = 0.0f;
+	for (const FBoidTableData& Boid : Scenario.Boids)
+	{
+		MaxSpeed = FMath::Max(MaxSpeed, Boid.Speed);
+	}
+	const FVector3f AllowedExtents = OuterExtents + FVector3f(MaxSpeed * Params.DeltaSeconds + 1.0f);
+
+	TArray<FBoidTableData> InBoids = Scenario.Boids;
+	TArray<FBoidTableData> OutBoids;
+	OutBoids.SetNumZeroed(InBoids.Num());
+	FBoidsCellList Cells;
+
+	for (int32 Step = 0; Step < NumSteps; ++Step)
+	{
+		Cells.Build(InBoids, Params.CellSize, Step);
+		FBoidsReferenceStep::Step(Params, InBoids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, OutBoids);
+
+		// 相同输入必须得到逐字节相同的结果
+		if (Step == 0)
+		{
+			TArray<FBoidTableData> Repeat;
+			Repeat.SetNumZeroed(InBoids.Num());
+			FBoidsReferenceStep::Step(Params, InBoids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, Repeat);
+			TestTrue(TEXT("Deterministic"), FMemory::Memcmp(Repeat.GetData(), OutBoids.GetData(), OutBoids.Num() * sizeof(FBoidTableData)) == 0);
+		}
+
+		for (int32 Index = 0; Index < OutBoids.Num(); ++Index)
+		{
+			const FBoidTableData& Before = InBoids[Index];
+			const FBoidTableData& After = OutBoids[Index];
+			const FString Context = FString::Printf(TEXT("step %d boid %d"), Step, Index);
+
+			if (!TestEqual(*(TEXT("Heading is unit length, ") + Context), After.Heading.Size(), 1.0f, 1e-4f)
+				|| !TestEqual(*(TEXT("Speed is unchanged, ") + Context), After.Speed, Before.Speed)
+				|| !TestEqual(*(TEXT("Group is unchanged, ") + Context), After.Group, Before.Group))
+			{
+				return false;
+			}
+
+			// 在限制盒外边界内的鱼不会被拉回，每步正好移动 Speed * DeltaSeconds
+			const bool bStartedInsideOuter = FMath::Abs(Before.Position.X) <= OuterExtents.X
+				&& FMath::Abs(Before.Position.Y) <= OuterExtents.Y
+				&& FMath::Abs(Before.Position.Z) <= OuterExtents.Z;
+			if (bStartedInsideOuter
+				&& !TestEqual(*(TEXT("Step length is Speed * DeltaSeconds, ") + Context), (After.Position - Before.Position).Size(), Before.Speed * Params.DeltaSeconds, 1e-2f))
+			{
+				return false;
+			}
+
+			// 越出外边界的鱼会被拉回外边界，所以任何时候都不会超出外边界一步以上
+			const bool bInsideAllowed = FMath::Abs(After.Position.X) <= AllowedExtents.X
+				&& FMath::Abs(After.Position.Y) <= AllowedExtents.Y
+				&& FMath::Abs(After.Position.Z) <= AllowedExtents.Z;
+			if (!TestTrue(*(TEXT("Stays inside the restriction volume, ") + Context), bInsideAllowed)
+				|| !TestTrue(*(TEXT("NumVolumesAffecting in range, ") + Context), After.NumVolumesAffecting >= 0 && After.NumVolumesAffecting <= BoidsShader::MaxVolumes))
+			{
+				return false;
+			}
+		}
+
+		Swap(InBoids, OutBoids);
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBoidsSIMDStepTest, "EditorTools.Boids.ReferenceStep.MatchesSIMD", BoidsReferenceTestFlags)
+
+bool FBoidsSIMDStepTest::RunTest(const FString& Parameters)
+{
+	// SIMD 内核按 4 路部分和累加邻居，只要求在浮点误差范围内一致；
+	// 恰好落在半径阈值上的邻居可能一边算入一边不算，允许极少数离群值
+	const float HeadingTolerance = 1e-4f;
+	const float PositionTolerance = 1e-3f;
+	const int32 MaxOutliersPerMille = 1;
+
+	FBoidsSyntheticScenario Scenario = FBoidsSyntheticScenario::Make(20000, 8.0f, 2, 6, 5);
+	FBoidsSIMDStep SIMDStep;
+
+	for (const bool bFullNeighbourEvaluation : { false, true })
+	{
+		FBoidsStepParams Params = Scenario.Params;
+		Params.bFullNeighbourEvaluation = bFullNeighbourEvaluation;
+
+		FBoidsCellList Cells;
+		Cells.Build(Scenario.Boids, Params.CellSize, 0);
+
+		TArray<FBoidTableData> Expected;
+		Expected.SetNumZeroed(Scenario.Boids.Num());
+		FBoidsReferenceStep::Step(Params, Scenario.Boids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, Expected);
+
+		TArray<FBoidTableData> Actual;
+		Actual.SetNumZeroed(Scenario.Boids.Num());
+		SIMDStep.Step(Params, Scenario.Boids, Scenario.Volumes, Scenario.VolumeGrid, Scenario.Groups, Scenario.GroupResponses, Cells, Actual);
+
+		int32 NumOutliers = 0;
+		for (int32 Index = 0; Index < Expected.Num(); ++Index)
+		{
+			const FBoidTableData& A = Expected[Index];
+			const FBoidTableData& B = Actual[Index];
+			if (!A.Heading.Equals(B.Heading, HeadingTolerance)
+				|| !A.Position.Equals(B.Position, PositionTolerance)
+				|| A.Action != B.Action
+				|| A.NumVolumesAffecting != B.NumVolumesAffecting)
+			{
+				++NumOutliers;
+			}
+		}
+
+		TestTrue(FString::Printf(TEXT("Boids outside tolerance (%s, %d of %d)"), bFullNeighbourEvaluation ? TEXT("full") : TEXT("truncated"), NumOutliers, Expected.Num()),
+			NumOutliers * 1000 <= Expected.Num() * MaxOutliersPerMille);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
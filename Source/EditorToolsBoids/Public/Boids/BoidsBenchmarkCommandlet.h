@@ -0,0 +1,28 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BoidsBenchmarkCommandlet.generated.h"
+
+/**
+ * 鱼群模拟基准测试，用合成鱼群比较不同硬件和版本的吞吐量
+ * 鱼数量从 MinBoids 按 Multiplier 倍增到 MaxBoids，每个规模依次测试 CPU 参考实现、SIMD 内核和（可用时）GPU，
+ * 结果写成 CSV：每条鱼每步的纳秒数、每条鱼检查的邻居数、内存占用。
+ * 用 -nullrhi 无界面运行时只测试 CPU 路径。
+ *
+ * UnrealEditor-Cmd <Project> -run=BoidsBenchmark -nullrhi [-Steps=10] [-MinBoids=1000] [-MaxBoids=1000000] [-Multiplier=10]
+ *     [-Groups=2] [-Volumes=2] [-Density=8] [-Kernels=Reference,SIMD,GPU] [-FullNeighbours] [-Output=<csv>]
+ */
+UCLASS()
+class EDITORTOOLSBOIDS_API UBoidsBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBoidsBenchmarkCommandlet();
+
+	//~ Begin UCommandlet Interface
+	virtual int32 Main(const FString& Params) override;
+	//~ End UCommandlet Interface
+};
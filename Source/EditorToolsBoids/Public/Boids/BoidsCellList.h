@@ -0,0 +1,63 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+
+/**
+ * 着色器邻居查询使用的空间哈希单元表
+ * 按 GetFlatCellIndex 分桶做计数排序：CellBoidCount 是每个桶的鱼数量，CellOffsetList 是桶在 SortedCellList 中的起始位置，
+ * SortedCellList 存放完整的 32 位鱼索引。
+ */
+struct EDITORTOOLSBOIDS_API FBoidsCellList
+{
+	TArray<uint32> SortedCellList;
+	TArray<uint32> CellOffsetList;
+	TArray<uint32> CellBoidCount;
+
+	/** 用临时构建器重新构建单元表，逐帧构建时应复用 FBoidsCellListBuilder */
+	void Build(TConstArrayView<FBoidTableData> Boids, float CellSize, uint32 ShuffleSeed);
+
+	/** 桶内的 SortedCellList 区间 */
+	TConstArrayView<uint32> GetCell(uint32 FlatCellIndex) const
+	{
+		return TConstArrayView<uint32>(SortedCellList.GetData() + CellOffsetList[FlatCellIndex], CellBoidCount[FlatCellIndex]);
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return SortedCellList.GetAllocatedSize() + CellOffsetList.GetAllocatedSize() + CellBoidCount.GetAllocatedSize();
+	}
+};
+
+/**
+ * 多线程单元表构建器
+ * 鱼群按块并行统计每块的桶直方图，按桶并行求出各块在桶内的起点和全局前缀和，最后各块并行散射。
+ * 块内和块间都保持原始顺序，所以结果与块的数量无关，和串行计数排序完全一致。
+ * 构建器保留中间缓冲区，逐帧复用不会重新分配。
+ */
+class EDITORTOOLSBOIDS_API FBoidsCellListBuilder
+{
+public:
+	/**
+	 * 构建单元表
+	 * 着色器每个单元只检查前 MaxNeighbourChecks 条鱼，ShuffleSeed 用来逐帧轮转桶内顺序，让不同邻居轮流参与计算
+	 */
+	void Build(TConstArrayView<FBoidTableData> Boids, float CellSize, uint32 ShuffleSeed, FBoidsCellList& OutCells);
+
+	/** 中间缓冲区占用的内存 */
+	SIZE_T GetAllocatedSize() const
+	{
+		return BoidCells.GetAllocatedSize() + ChunkCellCounts.GetAllocatedSize() + CellBlockSums.GetAllocatedSize();
+	}
+
+private:
+	/** 每条鱼所在的桶 */
+	TArray<uint32> BoidCells;
+
+	/** NumChunks * TotalCells 的块直方图，前缀和阶段原地改写为块在桶内的起点 */
+	TArray<uint32> ChunkCellCounts;
+
+	/** 每段桶的数量和，用于两级前缀和 */
+	TArray<uint32> CellBlockSums;
+};
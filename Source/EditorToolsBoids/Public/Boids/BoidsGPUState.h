@@ -0,0 +1,126 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RenderGraphResources.h"
+#include "Boids/BoidsShaderTypes.h"
+#include "Boids/BoidsVolumeGrid.h"
+
+class FRDGBuilder;
+class FRHIGPUBufferReadback;
+
+/**
+ * GPU 上的双缓冲鱼群状态（只在渲染线程访问）
+ * 两块池化缓冲区轮流作为读缓冲区（SRV）和写缓冲区（UAV）：每步读取上一步的结果、写入另一块，
+ * 步骤结束后交换。同一步内没有线程会读到其他线程写入的数据，所以步骤内不需要屏障，
+ * 结果与线程调度顺序无关，CalculationsPerThread 取任意值都得到相同结果。
+ */
+class EDITORTOOLSBOIDS_API FBoidsDoubleBufferedState
+{
+public:
+	/** 一步模拟使用的读写缓冲区 */
+	struct FStepBuffers
+	{
+		FRDGBufferRef Read = nullptr;
+		FRDGBufferRef Write = nullptr;
+	};
+
+	/** 缓冲区里是否有指定版本的状态 */
+	bool HasState(uint32 Generation, int32 NumBoids) const;
+
+	/** 把鱼群状态上传到读缓冲区，必要时重新分配两块缓冲区；数据在图执行前必须保持有效 */
+	void Upload(FRDGBuilder& GraphBuilder, const TArray<FBoidTableData>& Boids, uint32 Generation);
+
+	/** 在图中注册本步的读写缓冲区 */
+	FStepBuffers BeginStep(FRDGBuilder& GraphBuilder) const;
+
+	/** 交换读写缓冲区，写缓冲区成为下一步的输入 */
+	void EndStep();
+
+	/** 最近一步的结果（下一步的读缓冲区），没有状态时为空 */
+	const TRefCountPtr<FRDGPooledBuffer>& GetCurrentBuffer() const { return Buffers[ReadIndex]; }
+
+	int32 GetNumBoids() const { return NumBoids; }
+
+	void Release();
+
+private:
+	TRefCountPtr<FRDGPooledBuffer> Buffers[2];
+	int32 ReadIndex = 0;
+	int32 NumBoids = 0;
+	uint32 Generation = 0;
+};
+
+/** 游戏线程提交给渲染线程的一步模拟输入 */
+struct FBoidsGPUStepInputs
+{
+	FBoidsStepParams Params;
+	int32 NumBoids = 0;
+
+	/** 状态版本，游戏线程重新设置鱼群后递增，旧版本的回读结果会被丢弃 */
+	uint32 Generation = 0;
+
+	/** 非空时用它覆盖 GPU 上的鱼群状态 */
+	TArray<FBoidTableData> UploadBoids;
+
+	/** 单元表的轮转种子 */
+	uint32 ShuffleSeed = 0;
+
+	/** 是否把结果回读给游戏线程 */
+	bool bReadback = true;
+
+	TArray<FVolumeTableData> Volumes;
+	FBoidsVolumeGrid VolumeGrid;
+	TArray<FGroupTableData> Groups;
+	FBoidsGroupResponseMatrix GroupResponses;
+};
+
+/**
+ * 渲染线程持有的鱼群 GPU 状态
+ * 鱼群数据常驻在池化缓冲区里，单元表也在 GPU 上构建，每步只上传体积/分组表；
+ * 需要时结果通过异步回读送回游戏线程，不会阻塞渲染线程。
+ */
+class EDITORTOOLSBOIDS_API FBoidsGPUState
+{
+public:
+	FBoidsGPUState();
+	~FBoidsGPUState();
+
+	/** 渲染线程：调度一步模拟 */
+	void Step_RenderThread(FRHICommandListImmediate& RHICmdList, FBoidsGPUStepInputs& Inputs);
+
+	/**
+	 * 游戏线程：取走最近一次完成的回读结果
+	 * @return 没有新结果或结果属于旧版本时返回 false
+	 */
+	bool ConsumeReadback(uint32 Generation, TArray<FBoidTableData>& OutBoids);
+
+	/**
+	 * 渲染线程：最近一步的鱼群状态缓冲区（FBoidTableData 结构化缓冲区），供渲染直接读取
+	 * @return 还没有状态时返回空
+	 */
+	TRefCountPtr<FRDGPooledBuffer> GetBoidBuffer_RenderThread(int32& OutNumBoids) const;
+
+	/**
+	 * 渲染线程：阻塞读回 GPU 上当前的鱼群状态
+	 * 会等待 GPU 空闲，只用于追加鱼群、切换到 CPU 模拟这类偶发操作
+	 * @return GPU 上没有指定版本的状态时返回 false
+	 */
+	bool ReadBoidsBlocking_RenderThread(FRHICommandListImmediate& RHICmdList, uint32 Generation, TArray<FBoidTableData>& OutBoids);
+
+private:
+	void PollReadback_RenderThread();
+
+	// 以下成员只在渲染线程访问
+	FBoidsDoubleBufferedState BoidState;
+	TUniquePtr<FRHIGPUBufferReadback> Readback;
+	int32 ReadbackNumBoids = 0;
+	uint32 ReadbackGeneration = 0;
+	bool bReadbackInFlight = false;
+
+	// 回读结果，游戏线程和渲染线程共享
+	FCriticalSection ResultLock;
+	TArray<FBoidTableData> ResultBoids;
+	uint32 ResultGeneration = 0;
+	bool bHasResult = false;
+};
@@ -0,0 +1,75 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+
+struct FBoidsCellList;
+struct FBoidsVolumeGrid;
+
+/** 一条鱼的邻居累加结果（分离/聚合/对齐的向量和与数量） */
+struct FBoidsNeighbourSums
+{
+	FVector3f Cohesion = FVector3f::ZeroVector;
+	FVector3f Separation = FVector3f::ZeroVector;
+	FVector3f Alignment = FVector3f::ZeroVector;
+	float CohesionCnt = 0.0f;
+	float SeparationCnt = 0.0f;
+	float AlignmentCnt = 0.0f;
+};
+
+/**
+ * ComputeFishShader.usf 中 MainComputeShader 的 CPU 参考实现
+ * 逐条语句对应着色器（运算顺序、截断方式、哈希都相同），用于无 GPU（-nullrhi、专用服务器）时驱动模拟，
+ * 以及校验 GPU 结果。GPU 的超越函数精度由驱动决定，所以两边只能保证在浮点误差范围内一致。
+ */
+class EDITORTOOLSBOIDS_API FBoidsReferenceStep
+{
+public:
+	/**
+	 * 计算一步：读取 InBoids，写入 OutBoids（两者不能是同一块内存）
+	 * @param Cells 由 InBoids 构建的单元表
+	 */
+	static void Step(
+		const FBoidsStepParams& Params,
+		TConstArrayView<FBoidTableData> InBoids,
+		TConstArrayView<FVolumeTableData> Volumes,
+		const FBoidsVolumeGrid& VolumeGrid,
+		TConstArrayView<FGroupTableData> Groups,
+		const FBoidsGroupResponseMatrix& GroupResponses,
+		const FBoidsCellList& Cells,
+		TArrayView<FBoidTableData> OutBoids);
+
+	/** 计算单条鱼，等价于着色器的一次线程迭代 */
+	static void StepBoid(
+		const FBoidsStepParams& Params,
+		int32 BoidIndex,
+		TConstArrayView<FBoidTableData> InBoids,
+		TConstArrayView<FVolumeTableData> Volumes,
+		const FBoidsVolumeGrid& VolumeGrid,
+		TConstArrayView<FGroupTableData> Groups,
+		const FBoidsGroupResponseMatrix& GroupResponses,
+		const FBoidsCellList& Cells,
+		FBoidTableData& OutBoid);
+
+	/** 着色器的邻居循环部分 */
+	static void AccumulateNeighbours(
+		const FBoidsStepParams& Params,
+		int32 BoidIndex,
+		TConstArrayView<FBoidTableData> InBoids,
+		TConstArrayView<FGroupTableData> Groups,
+		const FBoidsGroupResponseMatrix& GroupResponses,
+		const FBoidsCellList& Cells,
+		FBoidsNeighbourSums& OutSums);
+
+	/** 着色器的影响体积、转向和积分部分，邻居结果由调用者提供（其它 CPU 内核复用） */
+	static void FinishBoid(
+		const FBoidsStepParams& Params,
+		int32 BoidIndex,
+		TConstArrayView<FBoidTableData> InBoids,
+		TConstArrayView<FVolumeTableData> Volumes,
+		const FBoidsVolumeGrid& VolumeGrid,
+		TConstArrayView<FGroupTableData> Groups,
+		const FBoidsNeighbourSums& Sums,
+		FBoidTableData& OutBoid);
+};
@@ -0,0 +1,53 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+
+struct FBoidsCellList;
+struct FBoidsVolumeGrid;
+
+/**
+ * MainComputeShader 的多线程 SIMD CPU 内核（没有 GPU 的专用服务器使用）
+ * 邻居数据按单元表顺序重排成结构数组（位置、朝向、分组各一条流），每个单元的候选邻居在内存中连续，
+ * 用 VectorRegister4Float 一次比较 4 个邻居；鱼按批次并行。影响体积、转向和积分复用 FBoidsReferenceStep::FinishBoid。
+ * 邻居按 4 路部分和累加，结果与参考实现在浮点误差范围内一致，但不逐位相同，校验时使用 FBoidsReferenceStep。
+ */
+class EDITORTOOLSBOIDS_API FBoidsSIMDStep
+{
+public:
+	/** 计算一步：读取 InBoids，写入 OutBoids（两者不能是同一块内存） */
+	void Step(
+		const FBoidsStepParams& Params,
+		TConstArrayView<FBoidTableData> InBoids,
+		TConstArrayView<FVolumeTableData> Volumes,
+		const FBoidsVolumeGrid& VolumeGrid,
+		TConstArrayView<FGroupTableData> Groups,
+		const FBoidsGroupResponseMatrix& GroupResponses,
+		const FBoidsCellList& Cells,
+		TArrayView<FBoidTableData> OutBoids);
+
+	/** 重排后的数据流占用的内存 */
+	SIZE_T GetAllocatedSize() const
+	{
+		return SortedPositionX.GetAllocatedSize() + SortedPositionY.GetAllocatedSize() + SortedPositionZ.GetAllocatedSize()
+			+ SortedHeadingX.GetAllocatedSize() + SortedHeadingY.GetAllocatedSize() + SortedHeadingZ.GetAllocatedSize()
+			+ SortedGroup.GetAllocatedSize() + FlockTable.GetAllocatedSize();
+	}
+
+private:
+	/** 按 SortedCellList 顺序把邻居需要的字段拆成结构数组 */
+	void GatherSortedStreams(TConstArrayView<FBoidTableData> InBoids, const FBoidsCellList& Cells, const FBoidsGroupResponseMatrix& GroupResponses);
+
+	// 按 SortedCellList 顺序排列，末尾多留一组（4 个）填充元素，整组加载不会越界
+	TArray<float> SortedPositionX;
+	TArray<float> SortedPositionY;
+	TArray<float> SortedPositionZ;
+	TArray<float> SortedHeadingX;
+	TArray<float> SortedHeadingY;
+	TArray<float> SortedHeadingZ;
+	TArray<int32> SortedGroup;
+
+	/** 由响应矩阵展开：FlockTable[自己的分组 * MaxGroups + 对方分组]，对方参与计算时为全 1 位掩码（-1），否则为 0 */
+	TArray<int32> FlockTable;
+};
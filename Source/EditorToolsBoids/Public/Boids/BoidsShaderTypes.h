@@ -0,0 +1,188 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * ComputeFishShader.usf 中结构化缓冲区的 C++ 镜像
+ * 结构化缓冲区按 4 字节紧密排列：float3 占 12 字节，bool 占 4 字节，float4x4 按行主序占 64 字节。
+ * 修改任一结构体时必须同步修改着色器，下面的 static_assert 会在布局不一致时报错。
+ */
+namespace BoidsShader
+{
+	/** 单条鱼最多记录的影响体积数（MAX_VOLUMES） */
+	constexpr int32 MaxVolumes = 16;
+
+	/** 鱼群分组上限（MAX_GROUPS），体积用 int 位掩码标记影响的分组，所以不能超过 32 */
+	constexpr int32 MaxGroups = 32;
+
+	/** 空间哈希桶数量（TOTAL_CELLS） */
+	constexpr int32 TotalCells = 65536;
+
+	/** 计算着色器线程组大小（THREADGROUPSIZE_X） */
+	constexpr int32 ThreadGroupSize = 256;
+
+	/** 默认每个单元最多检查的邻居数（MAX_NEIGHBOUR_COUNT） */
+	constexpr int32 DefaultMaxNeighbourChecks = 10;
+
+	/** 完整邻居模式下分块内核的线程组大小和共享内存分块大小（NEIGHBOUR_TILE_SIZE） */
+	constexpr int32 NeighbourTileSize = 64;
+
+	/** 分块内核每个哈希桶一个线程组，按二维调度避开单维 65535 的上限（TILED_DISPATCH_WIDTH） */
+	constexpr int32 TiledDispatchWidth = 256;
+
+	/** 分组响应矩阵中每对分组占的位数（GROUP_RESPONSE_BITS），EBoidGroupResponse 的取值必须能放下 */
+	constexpr int32 GroupResponseBits = 2;
+
+	/** 每个 uint 存放的响应数 */
+	constexpr int32 GroupResponsesPerWord = 32 / GroupResponseBits;
+
+	/** 响应矩阵一行（一个分组对所有分组的响应）占的 uint 数（GROUP_RESPONSE_WORDS_PER_ROW） */
+	constexpr int32 GroupResponseWordsPerRow = MaxGroups / GroupResponsesPerWord;
+
+	/** BoidTableData.Action 位 */
+	constexpr int32 ActionGoaling = 1 << 0;
+	constexpr int32 ActionFleeing = 1 << 1;
+
+	static_assert(MaxGroups <= 32, "VolumeInfluencesGroups 是 32 位掩码");
+	static_assert(MaxGroups % GroupResponsesPerWord == 0, "响应矩阵的每一行必须占整数个 uint");
+	static_assert(GroupResponseWordsPerRow == 2, "着色器把响应矩阵的一行读成 uint2");
+	static_assert(TiledDispatchWidth * TiledDispatchWidth == TotalCells, "分块内核的二维调度必须正好覆盖所有哈希桶");
+}
+
+struct FBoidTableData
+{
+	FVector3f Position;
+	float Scale;
+	FVector3f Heading;
+	float Turning;
+	float Speed;
+	int32 Group;
+	int32 MeshIndex;
+	float Health;
+	float MaxHealth;
+	// 第 0 位：趋向目标；第 1 位：逃离
+	int32 Action;
+	// HLSL 的 bool 在结构化缓冲区中占 4 字节
+	uint32 bIsPendingDelete;
+	int32 NumVolumesAffecting;
+	int32 VolumesAffectingIndices[BoidsShader::MaxVolumes];
+};
+
+struct FVolumeTableData
+{
+	int32 VolumeType;
+	int32 VolumeShape;
+	int32 VolumeUseFalloff;
+	float VolumeFalloff;
+	FVector3f VolumeInnerExtents;
+	float VolumeInnerRadius;
+	FVector3f VolumeOuterExtents;
+	float VolumeOuterRadius;
+	FMatrix44f VolumeWorldToLocal;
+	FMatrix44f VolumeLocalToWorld;
+	FVector3f VolumePosition;
+	int32 VolumeInfluencesGroups;
+	FVector3f VolumeRotation;
+	float Padding;
+};
+
+struct FGroupTableData
+{
+	float GroupAlignment;
+	float GroupCohesion;
+	float GroupSeparation;
+	float GroupGoal;
+	float GroupFlee;
+	float GroupRestriction;
+	float GroupSeparationRadius;
+	float GroupCohesionRadius;
+	float GroupAlignmentRadius;
+	float GroupNonVerticalMovementFactor;
+	float Padding[2];
+};
+
+/**
+ * 分组响应矩阵（对应着色器的 GroupResponseMatrix）
+ * 每对分组占 GroupResponseBits 位，行是自己的分组，列是对方分组；一行正好两个 uint，整个矩阵 256 字节。
+ * 邻居循环开始前把自己的那一行读进寄存器，循环中不再访问分组表。
+ */
+struct FBoidsGroupResponseMatrix
+{
+	uint32 Words[BoidsShader::MaxGroups * BoidsShader::GroupResponseWordsPerRow] = {};
+
+	FORCEINLINE void Set(int32 Group, int32 OtherGroup, uint32 Response)
+	{
+		constexpr uint32 Mask = (1u << BoidsShader::GroupResponseBits) - 1;
+		const uint32 Shift = (OtherGroup % BoidsShader::GroupResponsesPerWord) * BoidsShader::GroupResponseBits;
+		uint32& Word = Words[Group * BoidsShader::GroupResponseWordsPerRow + OtherGroup / BoidsShader::GroupResponsesPerWord];
+		Word = (Word & ~(Mask << Shift)) | ((Response & Mask) << Shift);
+	}
+
+	FORCEINLINE uint32 Get(int32 Group, int32 OtherGroup) const
+	{
+		return GetFromRow(GetRow(Group), OtherGroup);
+	}
+
+	FORCEINLINE const uint32* GetRow(int32 Group) const
+	{
+		return Words + Group * BoidsShader::GroupResponseWordsPerRow;
+	}
+
+	/** 与着色器的 GetGroupResponse 相同 */
+	static FORCEINLINE uint32 GetFromRow(const uint32* Row, int32 OtherGroup)
+	{
+		constexpr uint32 Mask = (1u << BoidsShader::GroupResponseBits) - 1;
+		const uint32 Shift = (OtherGroup % BoidsShader::GroupResponsesPerWord) * BoidsShader::GroupResponseBits;
+		return (Row[OtherGroup / BoidsShader::GroupResponsesPerWord] >> Shift) & Mask;
+	}
+};
+
+static_assert(sizeof(FBoidTableData) == 64 + 4 * BoidsShader::MaxVolumes, "FBoidTableData 与 BoidTableData 布局不一致");
+static_assert(STRUCT_OFFSET(FBoidTableData, VolumesAffectingIndices) == 64, "FBoidTableData 与 BoidTableData 布局不一致");
+static_assert(sizeof(FVolumeTableData) == 208, "FVolumeTableData 与 VolumeTableData 布局不一致");
+static_assert(STRUCT_OFFSET(FVolumeTableData, VolumeWorldToLocal) == 48, "FVolumeTableData 与 VolumeTableData 布局不一致");
+static_assert(STRUCT_OFFSET(FVolumeTableData, VolumePosition) == 176, "FVolumeTableData 与 VolumeTableData 布局不一致");
+static_assert(sizeof(FGroupTableData) == 48, "FGroupTableData 与 GroupTableData 布局不一致");
+static_assert(sizeof(FBoidsGroupResponseMatrix) == 4 * BoidsShader::MaxGroups * BoidsShader::GroupResponseWordsPerRow, "FBoidsGroupResponseMatrix 与 GroupResponseMatrix 布局不一致");
+
+/** 单步模拟的标量参数（对应着色器的全局参数） */
+struct FBoidsStepParams
+{
+	float DeltaSeconds = 0.f;
+	float CellSize = 200.f;
+	int32 MaxNeighbourChecks = BoidsShader::DefaultMaxNeighbourChecks;
+	int32 CalculationsPerThread = 1;
+
+	/**
+	 * 完整邻居模式：不截断 MaxNeighbourChecks、不轮转单元表，每条鱼检查 27 个单元内的全部邻居。
+	 * 结果与步数无关、可复现，代价随密度增长；GPU 上改用共享内存分块的内核。
+	 */
+	bool bFullNeighbourEvaluation = false;
+
+	/** 每个单元实际检查的邻居上限 */
+	uint32 GetNeighbourCheckLimit() const
+	{
+		return bFullNeighbourEvaluation ? MAX_uint32 : (uint32)FMath::Max(MaxNeighbourChecks, 0);
+	}
+};
+
+namespace BoidsShader
+{
+	/** 与着色器 int3(position / CellSize) 相同：向零截断 */
+	FORCEINLINE FIntVector GetCellVector(const FVector3f& Position, float CellSize)
+	{
+		return FIntVector((int32)(Position.X / CellSize), (int32)(Position.Y / CellSize), (int32)(Position.Z / CellSize));
+	}
+
+	/** 与着色器 GetFlatCellIndex 相同的质数异或哈希：按 32 位无符号回绕相乘，再按有符号取模后取绝对值 */
+	FORCEINLINE uint32 GetFlatCellIndex(const FIntVector& Cell)
+	{
+		const uint32 P1 = 73856093u;
+		const uint32 P2 = 19349663u;
+		const uint32 P3 = 83492791u;
+		int32 N = (int32)((P1 * (uint32)Cell.X) ^ (P2 * (uint32)Cell.Y) ^ (P3 * (uint32)Cell.Z));
+		N %= TotalCells;
+		return (uint32)FMath::Abs(N);
+	}
+}
@@ -0,0 +1,105 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+#include "Boids/BoidsCellList.h"
+#include "Boids/BoidsSIMDStep.h"
+#include "Boids/BoidsVolumeGrid.h"
+
+struct FBoidGroupSettings;
+struct FBoidVolumeSettings;
+class FBoidsGPUState;
+
+/**
+ * 一群鱼的模拟状态（游戏线程对象）
+ * 有可用的 SM5 RHI 时每步调度 ComputeFishShader，鱼群状态和单元表都在 GPU 上，CPU 侧的副本来自可选的异步回读（延迟若干帧）；
+ * 否则（-nullrhi、专用服务器、r.EditorTools.Boids.UseGPU=0）在 CPU 上计算，默认使用 FBoidsSIMDStep，
+ * r.EditorTools.Boids.CPUKernel=0 时使用 FBoidsReferenceStep。
+ */
+class EDITORTOOLSBOIDS_API FBoidsSimulation
+{
+public:
+	UE_NONCOPYABLE(FBoidsSimulation);
+
+	FBoidsSimulation();
+	~FBoidsSimulation();
+
+	/** 替换全部鱼群状态；分组索引会被限制在 [0, MaxGroups) */
+	void SetBoids(TArray<FBoidTableData>&& InBoids);
+
+	/**
+	 * 在现有鱼群后追加新的鱼
+	 * GPU 模式下 CPU 侧的副本可能落后若干帧（关闭回读时不再更新），所以先阻塞读回 GPU 上的最新状态再追加
+	 */
+	void AddBoids(TArray<FBoidTableData>&& NewBoids);
+
+	/** 设置分组参数，未设置的分组使用默认参数且忽略所有分组 */
+	void SetGroups(TConstArrayView<FBoidGroupSettings> Settings);
+
+	/** 设置影响体积（世界空间） */
+	void SetVolumes(TConstArrayView<FBoidVolumeSettings> Settings);
+
+	/** 推进一步 */
+	void Step(const FBoidsStepParams& Params);
+
+	/** 当前鱼群状态；GPU 模式下是最近一次回读的结果，关闭回读后不再更新 */
+	TConstArrayView<FBoidTableData> GetBoids() const { return Boids; }
+
+	int32 GetNumBoids() const { return Boids.Num(); }
+
+	/** 最近一步是否在 GPU 上计算 */
+	bool IsUsingGPU() const { return bUsingGPU; }
+
+	/** GPU 模式下是否把结果回读到 CPU；只在 GPU 上渲染的鱼群可以关闭以节省带宽 */
+	void SetReadbackEnabled(bool bEnabled) { bReadbackEnabled = bEnabled; }
+	bool IsReadbackEnabled() const { return bReadbackEnabled; }
+
+	/**
+	 * GPU 状态，渲染线程通过 FBoidsGPUState::GetBoidBuffer_RenderThread 直接读取鱼群缓冲区
+	 * 没有在 GPU 上模拟时为空
+	 */
+	TSharedPtr<FBoidsGPUState, ESPMode::ThreadSafe> GetGPUState() const { return bUsingGPU ? GPUState : TSharedPtr<FBoidsGPUState, ESPMode::ThreadSafe>(); }
+
+	/** 当前进程能否使用 GPU 路径 */
+	static bool CanUseGPU();
+
+	static FGroupTableData MakeGroupTableData(const FBoidGroupSettings& Settings);
+
+	/** 打包所有分组的 ResponseToGroups，未设置的分组和响应为 Ignore */
+	static FBoidsGroupResponseMatrix MakeGroupResponseMatrix(TConstArrayView<FBoidGroupSettings> Settings);
+	static FVolumeTableData MakeVolumeTableData(const FBoidVolumeSettings& Settings);
+
+private:
+	void StepCPU(const FBoidsStepParams& Params);
+	void StepGPU(const FBoidsStepParams& Params);
+
+	/** 用 GPU 上的最新状态覆盖 CPU 侧的副本（阻塞等待 GPU） */
+	void SyncBoidsFromGPU();
+
+	/** 单元表轮转种子：截断模式逐步轮转，完整邻居模式固定为 0 以保证结果可复现 */
+	uint32 GetShuffleSeed(const FBoidsStepParams& Params) const { return Params.bFullNeighbourEvaluation ? 0u : StepIndex; }
+
+	TArray<FBoidTableData> Boids;
+	TArray<FBoidTableData> OutBoids;
+	TArray<FVolumeTableData> Volumes;
+	FBoidsVolumeGrid VolumeGrid;
+	TArray<FGroupTableData> Groups;
+	FBoidsGroupResponseMatrix GroupResponses;
+	FBoidsCellList Cells;
+	FBoidsCellListBuilder CellListBuilder;
+	FBoidsSIMDStep SIMDStep;
+
+	/** 用作单元表的轮转种子 */
+	uint32 StepIndex;
+
+	/** 鱼群状态版本，SetBoids 时递增 */
+	uint32 Generation;
+
+	/** 下一次 GPU 步需要上传 CPU 侧的状态 */
+	bool bUploadPending;
+	bool bUsingGPU;
+	bool bReadbackEnabled;
+
+	TSharedPtr<FBoidsGPUState, ESPMode::ThreadSafe> GPUState;
+};
@@ -0,0 +1,93 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Types/BoidsTypes.h"
+#include "Boids/BoidsSimulation.h"
+#include "BoidsSimulationComponent.generated.h"
+
+/**
+ * 一群鱼的模拟组件
+ * 组件本身不逐帧 Tick，由 UBoidsSimulationSubsystem 统一推进；鱼不对应任何 Actor 或组件。
+ */
+UCLASS(ClassGroup = (EditorTools), meta = (BlueprintSpawnableComponent))
+class EDITORTOOLSBOIDS_API UBoidsSimulationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UBoidsSimulationComponent();
+
+	// 分组参数，按分组索引
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	TArray<FBoidGroupSettings> Groups;
+
+	// 影响体积（世界空间）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	TArray<FBoidVolumeSettings> Volumes;
+
+	// 空间哈希单元大小（厘米），应不小于最大的邻居半径
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (ClampMin = "1.0"))
+	float CellSize;
+
+	// 每个单元最多检查的邻居数
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (ClampMin = "1", EditCondition = "!bFullNeighbourEvaluation"))
+	int32 MaxNeighbourChecks;
+
+	// 检查周围单元内的全部邻居（不截断、不轮转），结果可复现，但开销随密度增长
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	bool bFullNeighbourEvaluation;
+
+	// GPU 上每个线程计算的鱼数量
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (ClampMin = "1"))
+	int32 CalculationsPerThread;
+
+	// GPU 模式下是否把鱼群状态回读到 CPU（GetBoidTransform 依赖它）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	bool bReadBackToCPU;
+
+	/**
+	 * 在包围盒内随机生成鱼，追加到现有鱼群之后
+	 * @param Count 数量
+	 * @param Group 分组索引
+	 * @param Bounds 世界空间包围盒
+	 * @param Speed 速度（厘米/秒）
+	 * @param Turning 转向速度（度/秒）
+	 * @param RandomSeed 随机种子，相同种子生成相同的鱼群
+	 */
+	UFUNCTION(BlueprintCallable, Category = "EditorTools|Boids")
+	void SpawnBoids(int32 Count, int32 Group, FBox Bounds, float Speed = 300.f, float Turning = 90.f, float Scale = 1.f, int32 MeshIndex = 0, int32 RandomSeed = 0);
+
+	/** 清空鱼群 */
+	UFUNCTION(BlueprintCallable, Category = "EditorTools|Boids")
+	void ClearBoids();
+
+	/** 修改 Groups/Volumes 后调用，使新参数生效 */
+	UFUNCTION(BlueprintCallable, Category = "EditorTools|Boids")
+	void RefreshSettings();
+
+	UFUNCTION(BlueprintPure, Category = "EditorTools|Boids")
+	int32 GetBoidCount() const;
+
+	/** 鱼的世界变换（X 轴朝向运动方向）；GPU 模式下是最近一次回读的结果 */
+	UFUNCTION(BlueprintPure, Category = "EditorTools|Boids")
+	FTransform GetBoidTransform(int32 BoidIndex) const;
+
+	/** 最近一步是否在 GPU 上计算 */
+	UFUNCTION(BlueprintPure, Category = "EditorTools|Boids")
+	bool IsSimulatingOnGPU() const;
+
+	/** 推进一步（由子系统调用） */
+	void StepSimulation(float DeltaSeconds);
+
+	FBoidsSimulation& GetSimulation() { return Simulation; }
+	const FBoidsSimulation& GetSimulation() const { return Simulation; }
+
+protected:
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+
+private:
+	FBoidsSimulation Simulation;
+};
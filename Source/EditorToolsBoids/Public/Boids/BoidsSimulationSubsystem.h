@@ -0,0 +1,29 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BoidsSimulationSubsystem.generated.h"
+
+class UBoidsSimulationComponent;
+
+/**
+ * 统一推进世界中所有鱼群模拟组件
+ */
+UCLASS()
+class EDITORTOOLSBOIDS_API UBoidsSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterComponent(UBoidsSimulationComponent* Component);
+	void UnregisterComponent(UBoidsSimulationComponent* Component);
+
+	// UTickableWorldSubsystem
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+private:
+	TArray<TWeakObjectPtr<UBoidsSimulationComponent>> Components;
+};
@@ -0,0 +1,35 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+#include "Boids/BoidsVolumeGrid.h"
+
+/**
+ * 基准测试和校验用的合成鱼群场景
+ * 鱼在立方体内均匀分布，立方体边长按目标密度（每个单元的平均鱼数）随数量缩放，
+ * 所以不同规模下每条鱼的邻居数大致相同；包含一个包住整个场景的限制体积、一个中心趋向体积，
+ * 其余体积是随机放置的趋向/逃离球体。
+ * 相同参数生成完全相同的场景。
+ */
+struct EDITORTOOLSBOIDS_API FBoidsSyntheticScenario
+{
+	TArray<FBoidTableData> Boids;
+	TArray<FVolumeTableData> Volumes;
+	FBoidsVolumeGrid VolumeGrid;
+	TArray<FGroupTableData> Groups;
+	FBoidsGroupResponseMatrix GroupResponses;
+	FBoidsStepParams Params;
+
+	/** 场景包围盒（世界空间） */
+	FBox Bounds;
+
+	/**
+	 * @param NumBoids 鱼数量
+	 * @param BoidsPerCell 每个单元的平均鱼数
+	 * @param NumGroups 分组数量，各分组互相成群
+	 * @param NumVolumes 体积数量（至少 2）
+	 * @param RandomSeed 随机种子
+	 */
+	static FBoidsSyntheticScenario Make(int32 NumBoids, float BoidsPerCell = 8.f, int32 NumGroups = 2, int32 NumVolumes = 2, int32 RandomSeed = 0);
+};
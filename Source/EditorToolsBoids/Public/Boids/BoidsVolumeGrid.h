@@ -0,0 +1,53 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Boids/BoidsShaderTypes.h"
+
+/**
+ * 影响体积的均匀网格，与体积表一起上传给着色器
+ * 网格覆盖所有体积外边界的包围盒，每个格子按升序列出外包围盒与它重叠的体积。
+ * 趋向/逃离体积和鱼所在的限制体积只在外边界内才有影响，所以只需要检查鱼所在格子的列表；
+ * 鱼在所有限制体积之外时要找最近的一个，这时遍历单独的限制体积列表。
+ * 列表保持体积原来的顺序，结果与逐个遍历全部体积完全相同。
+ */
+struct EDITORTOOLSBOIDS_API FBoidsVolumeGrid
+{
+	/** 网格最小角（世界空间） */
+	FVector3f Min = FVector3f::ZeroVector;
+
+	/** 1 / 格子大小 */
+	FVector3f InvCellSize = FVector3f::ZeroVector;
+
+	/** 每个轴的格子数，没有体积时为 0 */
+	FIntVector Dims = FIntVector::ZeroValue;
+
+	/** 每个格子在 VolumeIndices 中的 (起点, 数量) */
+	TArray<FUintVector2> CellRanges;
+
+	/** 各格子的体积列表，末尾是全部限制体积的列表 */
+	TArray<uint32> VolumeIndices;
+
+	/** 限制体积列表在 VolumeIndices 中的区间 */
+	uint32 RestrictionOffset = 0;
+	uint32 RestrictionCount = 0;
+
+	/** 受任一限制体积影响的分组位掩码 */
+	int32 RestrictionGroupsMask = 0;
+
+	/** 按体积表重建网格 */
+	void Build(TConstArrayView<FVolumeTableData> Volumes);
+
+	/** 与着色器 GetVolumeGridCell 相同：位置所在格子的体积列表，网格外为空 */
+	TConstArrayView<uint32> GetCellVolumes(const FVector3f& Position) const;
+
+	TConstArrayView<uint32> GetRestrictionVolumes() const
+	{
+		return TConstArrayView<uint32>(VolumeIndices.GetData() + RestrictionOffset, RestrictionCount);
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return CellRanges.GetAllocatedSize() + VolumeIndices.GetAllocatedSize();
+	}
+};
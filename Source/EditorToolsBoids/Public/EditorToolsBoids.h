@@ -0,0 +1,21 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Modules/ModuleManager.h"
+
+/**
+ * 鱼群（Boids）模拟运行时模块
+ * 全局着色器必须在引擎初始化前注册，所以独立于编辑器模块并在 PostConfigInit 阶段加载
+ */
+class FEditorToolsBoidsModule : public IModuleInterface
+{
+public:
+
+	/** IModuleInterface implementation */
+	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
+};
+
+DECLARE_LOG_CATEGORY_EXTERN(LogEditorToolsBoids, Log, All);
@@ -0,0 +1,155 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BoidsTypes.generated.h"
+
+/**
+ * 影响体积类型（数值与着色器中的 VolumeType 一致）
+ */
+UENUM(BlueprintType)
+enum class EBoidVolumeType : uint8
+{
+	Goal = 0		UMETA(DisplayName = "Goal"),
+	Flee = 1		UMETA(DisplayName = "Flee"),
+	Restriction = 2	UMETA(DisplayName = "Restriction"),
+};
+
+/**
+ * 影响体积形状（数值与着色器中的 VolumeShape 一致）
+ */
+UENUM(BlueprintType)
+enum class EBoidVolumeShape : uint8
+{
+	Sphere = 0	UMETA(DisplayName = "Sphere"),
+	Box = 1		UMETA(DisplayName = "Box"),
+};
+
+/**
+ * 分组之间的响应方式（数值与着色器中的 GroupResponseMatrix 一致，最多 2 位）
+ */
+UENUM(BlueprintType)
+enum class EBoidGroupResponse : uint8
+{
+	// 忽略对方
+	Ignore = 0	UMETA(DisplayName = "Ignore"),
+	// 与对方计算分离/聚合/对齐
+	Flock = 1	UMETA(DisplayName = "Flock"),
+};
+
+/**
+ * 鱼群分组参数
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLSBOIDS_API FBoidGroupSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Alignment;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Cohesion;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Separation;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Goal;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Flee;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float Restriction;
+
+	// 分离半径（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float SeparationRadius;
+
+	// 聚合半径（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float CohesionRadius;
+
+	// 对齐半径（厘米）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float AlignmentRadius;
+
+	// 保持水平运动的倾向
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	float NonVerticalMovementFactor;
+
+	// 对各分组的响应，按分组索引；缺省视为 Ignore
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	TArray<EBoidGroupResponse> ResponseToGroups;
+
+	FBoidGroupSettings()
+		: Alignment(1.f)
+		, Cohesion(1.f)
+		, Separation(1.5f)
+		, Goal(1.f)
+		, Flee(2.f)
+		, Restriction(2.f)
+		, SeparationRadius(100.f)
+		, CohesionRadius(300.f)
+		, AlignmentRadius(200.f)
+		, NonVerticalMovementFactor(0.1f)
+	{
+	}
+};
+
+/**
+ * 鱼群影响体积（趋向/逃离/限制区域）
+ */
+USTRUCT(BlueprintType)
+struct EDITORTOOLSBOIDS_API FBoidVolumeSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	EBoidVolumeType Type;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	EBoidVolumeShape Shape;
+
+	// 体积的世界变换（缩放参与计算）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	FTransform Transform;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (EditCondition = "Shape == EBoidVolumeShape::Sphere"))
+	float InnerRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (EditCondition = "Shape == EBoidVolumeShape::Sphere"))
+	float OuterRadius;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (EditCondition = "Shape == EBoidVolumeShape::Box"))
+	FVector InnerExtents;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (EditCondition = "Shape == EBoidVolumeShape::Box"))
+	FVector OuterExtents;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	bool bUseFalloff;
+
+	// 内外边界之间的衰减指数
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids", meta = (EditCondition = "bUseFalloff"))
+	float Falloff;
+
+	// 受影响的分组位掩码（第 N 位对应分组 N）
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Boids")
+	int32 InfluencedGroupsMask;
+
+	FBoidVolumeSettings()
+		: Type(EBoidVolumeType::Goal)
+		, Shape(EBoidVolumeShape::Sphere)
+		, Transform(FTransform::Identity)
+		, InnerRadius(500.f)
+		, OuterRadius(1000.f)
+		, InnerExtents(500.f)
+		, OuterExtents(1000.f)
+		, bUseFalloff(false)
+		, Falloff(1.f)
+		, InfluencedGroupsMask(-1)
+	{
+	}
+};
@@ -0,0 +1,33 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class EditorToolsBoidsNiagara : ModuleRules
+{
+	public EditorToolsBoidsNiagara(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"Niagara",
+				"NiagaraCore",
+			}
+			);
+
+		PrivateDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"EditorToolsBoids",
+				"NiagaraShader",
+				"RenderCore",
+				"RHI",
+				"VectorVM",
+			}
+		);
+	}
+}
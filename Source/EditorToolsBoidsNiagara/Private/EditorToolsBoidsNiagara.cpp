@@ -0,0 +1,6 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// 鱼群的 Niagara 渲染支持；依赖 Niagara 插件，所以不能放进 PostConfigInit 阶段加载的 EditorToolsBoids
+IMPLEMENT_MODULE(FDefaultModuleImpl, EditorToolsBoidsNiagara)
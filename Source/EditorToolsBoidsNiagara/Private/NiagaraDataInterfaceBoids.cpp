@@ -0,0 +1,296 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+
+#include "NiagaraDataInterfaceBoids.h"
+#include "Boids/BoidsGPUState.h"
+#include "Boids/BoidsSimulationComponent.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+#include "NiagaraCompileHashVisitor.h"
+#include "NiagaraGpuComputeDispatchInterface.h"
+#include "NiagaraShaderParametersBuilder.h"
+#include "NiagaraSystemInstance.h"
+#include "NiagaraTypes.h"
+#include "RenderGraphBuilder.h"
+#include "RenderingThread.h"
+#include "SystemTextures.h"
+#include "VectorVM.h"
+
+#define LOCTEXT_NAMESPACE "NiagaraDataInterfaceBoids"
+
+namespace
+{
+	static const TCHAR* TemplateShaderFilePath = TEXT("/Plugin/EditorTools/Private/NiagaraDataInterfaceBoids.ush");
+
+	static const FName GetNumBoidsName(TEXT("GetNumBoids"));
+	static const FName GetBoidName(TEXT("GetBoid"));
+
+	/** 游戏线程的每实例数据 */
+	struct FNDIBoidsInstanceData
+	{
+		TWeakObjectPtr<UBoidsSimulationComponent> Component;
+		TSharedPtr<FBoidsGPUState, ESPMode::ThreadSafe> GPUState;
+		int32 NumBoids = 0;
+		FVector3f LWCTileOffset = FVector3f::ZeroVector;
+	};
+
+	/** 传给渲染线程的每实例数据 */
+	struct FNDIBoidsInstanceData_RT
+	{
+		TSharedPtr<FBoidsGPUState, ESPMode::ThreadSafe> GPUState;
+		FVector3f LWCTileOffset = FVector3f::ZeroVector;
+	};
+
+	struct FNDIBoidsProxy : public FNiagaraDataInterfaceProxy
+	{
+		virtual int32 PerInstanceDataPassedToRenderThreadSize() const override { return sizeof(FNDIBoidsInstanceData_RT); }
+
+		virtual void ConsumePerInstanceDataFromGameThread(void* PerInstanceData, const FNiagaraSystemInstanceID& Instance) override
+		{
+			FNDIBoidsInstanceData_RT* SourceData = static_cast<FNDIBoidsInstanceData_RT*>(PerInstanceData);
+			SystemInstancesToInstanceData.FindOrAdd(Instance) = MoveTemp(*SourceData);
+			SourceData->~FNDIBoidsInstanceData_RT();
+		}
+
+		TMap<FNiagaraSystemInstanceID, FNDIBoidsInstanceData_RT> SystemInstancesToInstanceData;
+	};
+
+	static UBoidsSimulationComponent* FindBoidsComponent(FNiagaraSystemInstance* SystemInstance, FName ComponentTag)
+	{
+		USceneComponent* AttachComponent = SystemInstance ? SystemInstance->GetAttachComponent() : nullptr;
+		AActor* Owner = AttachComponent ? AttachComponent->GetOwner() : nullptr;
+		if (Owner == nullptr)
+		{
+			return nullptr;
+		}
+
+		TInlineComponentArray<UBoidsSimulationComponent*> Components(Owner);
+		for (UBoidsSimulationComponent* Component : Components)
+		{
+			if (ComponentTag.IsNone() || Component->ComponentHasTag(ComponentTag))
+			{
+				return Component;
+			}
+		}
+		return nullptr;
+	}
+}
+
+UNiagaraDataInterfaceBoids::UNiagaraDataInterfaceBoids(FObjectInitializer const& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	Proxy.Reset(new FNDIBoidsProxy());
+}
+
+void UNiagaraDataInterfaceBoids::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		ENiagaraTypeRegistryFlags Flags = ENiagaraTypeRegistryFlags::AllowAnyVariable | ENiagaraTypeRegistryFlags::AllowParameter;
+		FNiagaraTypeRegistry::Register(FNiagaraTypeDefinition(GetClass()), Flags);
+	}
+}
+
+bool UNiagaraDataInterfaceBoids::InitPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
+{
+	FNDIBoidsInstanceData* InstanceData = new (PerInstanceData) FNDIBoidsInstanceData();
+	InstanceData->Component = FindBoidsComponent(SystemInstance, SourceComponentTag);
+	return true;
+}
+
+void UNiagaraDataInterfaceBoids::DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance)
+{
+	static_cast<FNDIBoidsInstanceData*>(PerInstanceData)->~FNDIBoidsInstanceData();
+
+	ENQUEUE_RENDER_COMMAND(RemoveBoidsDataInterfaceInstance)(
+		[RT_Proxy = GetProxyAs<FNDIBoidsProxy>(), InstanceID = SystemInstance->GetId()](FRHICommandListImmediate& RHICmdList)
+		{
+			RT_Proxy->SystemInstancesToInstanceData.Remove(InstanceID);
+		});
+}
+
+int32 UNiagaraDataInterfaceBoids::PerInstanceDataSize() const
+{
+	return sizeof(FNDIBoidsInstanceData);
+}
+
+bool UNiagaraDataInterfaceBoids::PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds)
+{
+	FNDIBoidsInstanceData* InstanceData = static_cast<FNDIBoidsInstanceData*>(PerInstanceData);
+
+	// 组件可能在系统之后才注册
+	if (!InstanceData->Component.IsValid())
+	{
+		InstanceData->Component = FindBoidsComponent(SystemInstance, SourceComponentTag);
+	}
+
+	UBoidsSimulationComponent* Component = InstanceData->Component.Get();
+	InstanceData->GPUState = Component ? Component->GetSimulation().GetGPUState() : nullptr;
+	InstanceData->NumBoids = InstanceData->GPUState.IsValid() ? Component->GetBoidCount() : 0;
+
+	// 鱼群位置是世界坐标，Niagara 的世界空间位置相对于系统所在的大世界分块
+	InstanceData->LWCTileOffset = SystemInstance->GetLWCTile() * FLargeWorldRenderScalar::GetTileSize();
+	return false;
+}
+
+void UNiagaraDataInterfaceBoids::ProvidePerInstanceDataForRenderThread(void* DataForRenderThread, void* PerInstanceData, const FNiagaraSystemInstanceID& SystemInstance)
+{
+	const FNDIBoidsInstanceData* InstanceData = static_cast<const FNDIBoidsInstanceData*>(PerInstanceData);
+	FNDIBoidsInstanceData_RT* RenderThreadData = new (DataForRenderThread) FNDIBoidsInstanceData_RT();
+	RenderThreadData->GPUState = InstanceData->GPUState;
+	RenderThreadData->LWCTileOffset = InstanceData->LWCTileOffset;
+}
+
+void UNiagaraDataInterfaceBoids::GetVMExternalFunction(const FVMExternalFunctionBindingInfo& BindingInfo, void* InstanceData, FVMExternalFunction& OutFunc)
+{
+	// GetBoid 只在 GPU 上可用，鱼群状态不回到 CPU
+	if (BindingInfo.Name == GetNumBoidsName)
+	{
+		OutFunc = FVMExternalFunction::CreateUObject(this, &UNiagaraDataInterfaceBoids::VMGetNumBoids);
+	}
+}
+
+void UNiagaraDataInterfaceBoids::VMGetNumBoids(FVectorVMExternalFunctionContext& Context)
+{
+	VectorVM::FUserPtrHandler<FNDIBoidsInstanceData> InstanceData(Context);
+	FNDIOutputParam<int32> OutNumBoids(Context);
+
+	for (int32 Index = 0; Index < Context.GetNumInstances(); ++Index)
+	{
+		OutNumBoids.SetAndAdvance(InstanceData->NumBoids);
+	}
+}
+
+bool UNiagaraDataInterfaceBoids::Equals(const UNiagaraDataInterface* Other) const
+{
+	if (!Super::Equals(Other))
+	{
+		return false;
+	}
+
+	return CastChecked<const UNiagaraDataInterfaceBoids>(Other)->SourceComponentTag == SourceComponentTag;
+}
+
+bool UNiagaraDataInterfaceBoids::CopyToInternal(UNiagaraDataInterface* Destination) const
+{
+	if (!Super::CopyToInternal(Destination))
+	{
+		return false;
+	}
+
+	CastChecked<UNiagaraDataInterfaceBoids>(Destination)->SourceComponentTag = SourceComponentTag;
+	return true;
+}
+
+#if WITH_EDITORONLY_DATA
+void UNiagaraDataInterfaceBoids::GetFunctionsInternal(TArray<FNiagaraFunctionSignature>& OutFunctions) const
+{
+	FNiagaraFunctionSignature DefaultSignature;
+	DefaultSignature.bMemberFunction = true;
+	DefaultSignature.bRequiresContext = false;
+	DefaultSignature.Inputs.Add(FNiagaraVariable(FNiagaraTypeDefinition(GetClass()), TEXT("Boids")));
+
+	{
+		FNiagaraFunctionSignature& Signature = OutFunctions.Add_GetRef(DefaultSignature);
+		Signature.Name = GetNumBoidsName;
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("NumBoids")));
+		Signature.SetDescription(LOCTEXT("GetNumBoidsDesc", "鱼群数量；没有在 GPU 上模拟时为 0"));
+	}
+
+	{
+		FNiagaraFunctionSignature& Signature = OutFunctions.Add_GetRef(DefaultSignature);
+		Signature.Name = GetBoidName;
+		Signature.bSupportsCPU = false;
+		Signature.Inputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("Index")));
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetBoolDef(), TEXT("Valid")));
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetPositionDef(), TEXT("Position")));
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetQuatDef(), TEXT("Orientation")));
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetFloatDef(), TEXT("Scale")));
+		Signature.Outputs.Add(FNiagaraVariable(FNiagaraTypeDefinition::GetIntDef(), TEXT("MeshIndex")));
+		Signature.SetDescription(LOCTEXT("GetBoidDesc", "读取一条鱼的世界空间位置、朝向（网格 +X 指向前进方向）、缩放和网格索引"));
+	}
+}
+
+void UNiagaraDataInterfaceBoids::GetCommonHLSL(FString& OutHLSL)
+{
+	// 与 ComputeFishShader.usf 的 BoidTableData 布局一致
+	OutHLSL.Appendf(
+		TEXT("struct FEditorToolsNDIBoid\n")
+		TEXT("{\n")
+		TEXT("\tfloat3 Position;\n")
+		TEXT("\tfloat Scale;\n")
+		TEXT("\tfloat3 Heading;\n")
+		TEXT("\tfloat Turning;\n")
+		TEXT("\tfloat Speed;\n")
+		TEXT("\tint Group;\n")
+		TEXT("\tint MeshIndex;\n")
+		TEXT("\tfloat Health;\n")
+		TEXT("\tfloat MaxHealth;\n")
+		TEXT("\tint Action;\n")
+		TEXT("\tuint bIsPendingDelete;\n")
+		TEXT("\tint NumVolumesAffecting;\n")
+		TEXT("\tint VolumesAffectingIndices[%d];\n")
+		TEXT("};\n"),
+		BoidsShader::MaxVolumes);
+}
+
+void UNiagaraDataInterfaceBoids::GetParameterDefinitionHLSL(const FNiagaraDataInterfaceGPUParamInfo& ParamInfo, FString& OutHLSL)
+{
+	const TMap<FString, FStringFormatArg> TemplateArgs =
+	{
+		{TEXT("ParameterName"), ParamInfo.DataInterfaceHLSLSymbol},
+	};
+	AppendTemplateHLSL(OutHLSL, TemplateShaderFilePath, TemplateArgs);
+}
+
+bool UNiagaraDataInterfaceBoids::GetFunctionHLSL(const FNiagaraDataInterfaceGPUParamInfo& ParamInfo, const FNiagaraDataInterfaceGeneratedFunction& FunctionInfo, int FunctionInstanceIndex, FString& OutHLSL)
+{
+	// 函数体都在模板文件里
+	return FunctionInfo.DefinitionName == GetNumBoidsName || FunctionInfo.DefinitionName == GetBoidName;
+}
+
+bool UNiagaraDataInterfaceBoids::AppendCompileHash(FNiagaraCompileHashVisitor* InVisitor) const
+{
+	bool bSuccess = Super::AppendCompileHash(InVisitor);
+	bSuccess &= InVisitor->UpdateShaderFile(TemplateShaderFilePath);
+	bSuccess &= InVisitor->UpdateShaderParameters<FShaderParameters>();
+	bSuccess &= InVisitor->UpdatePOD(TEXT("BoidsMaxVolumes"), BoidsShader::MaxVolumes);
+	return bSuccess;
+}
+#endif
+
+void UNiagaraDataInterfaceBoids::BuildShaderParameters(FNiagaraShaderParametersBuilder& ShaderParametersBuilder) const
+{
+	ShaderParametersBuilder.AddNestedStruct<FShaderParameters>();
+}
+
+void UNiagaraDataInterfaceBoids::SetShaderParameters(const FNiagaraDataInterfaceSetShaderParametersContext& Context) const
+{
+	const FNDIBoidsProxy& DataInterfaceProxy = Context.GetProxy<FNDIBoidsProxy>();
+	const FNDIBoidsInstanceData_RT* InstanceData = DataInterfaceProxy.SystemInstancesToInstanceData.Find(Context.GetSystemInstanceID());
+	FRDGBuilder& GraphBuilder = Context.GetGraphBuilder();
+
+	int32 NumBoids = 0;
+	TRefCountPtr<FRDGPooledBuffer> BoidBuffer;
+	if (InstanceData && InstanceData->GPUState.IsValid())
+	{
+		BoidBuffer = InstanceData->GPUState->GetBoidBuffer_RenderThread(NumBoids);
+	}
+
+	FShaderParameters* ShaderParameters = Context.GetParameterNestedStruct<FShaderParameters>();
+	ShaderParameters->LWCTileOffset = InstanceData ? InstanceData->LWCTileOffset : FVector3f::ZeroVector;
+	if (BoidBuffer.IsValid())
+	{
+		// 直接绑定模拟最近一步写出的缓冲区，不做任何拷贝
+		ShaderParameters->NumBoids = NumBoids;
+		ShaderParameters->BoidData = GraphBuilder.CreateSRV(GraphBuilder.RegisterExternalBuffer(BoidBuffer));
+	}
+	else
+	{
+		ShaderParameters->NumBoids = 0;
+		ShaderParameters->BoidData = GraphBuilder.CreateSRV(GSystemTextures.GetDefaultStructuredBuffer(GraphBuilder, sizeof(FBoidTableData)));
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,66 @@
+// Copyright 2021 Justin Kiesskalt, All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NiagaraDataInterface.h"
+#include "NiagaraDataInterfaceBoids.generated.h"
+
+/**
+ * 把鱼群模拟的 GPU 状态缓冲区直接交给 Niagara GPU 粒子
+ * 数据接口绑定 FBoidsGPUState 里最新一步的结构化缓冲区，鱼的位置、朝向、缩放和 MeshIndex 都在 GPU 上读取，不经过 CPU。
+ * 用法：GPU 模拟、世界空间的发射器，每个粒子对应一条鱼（粒子索引 = 鱼索引），粒子数量取 GetNumBoids；
+ * 粒子更新里用 GetBoid 写 Position / MeshOrientation / Scale / MeshIndex，
+ * 网格渲染器里为每个 MeshIndex 配一个网格，每种网格一次绘制。
+ * 鱼群来源是 Niagara 组件所在 Actor 上的 UBoidsSimulationComponent（可以用组件标签筛选）；
+ * 鱼群没有在 GPU 上模拟时（例如 r.EditorTools.Boids.UseGPU=0）数量为 0。
+ */
+UCLASS(EditInlineNew, Category = "EditorTools", CollapseCategories, meta = (DisplayName = "Boids Simulation"))
+class EDITORTOOLSBOIDSNIAGARA_API UNiagaraDataInterfaceBoids : public UNiagaraDataInterface
+{
+	GENERATED_UCLASS_BODY()
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FShaderParameters, )
+		SHADER_PARAMETER(int32, NumBoids)
+		SHADER_PARAMETER(FVector3f, LWCTileOffset)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(StructuredBuffer<FEditorToolsNDIBoid>, BoidData)
+	END_SHADER_PARAMETER_STRUCT()
+
+public:
+	// 非空时只使用带有该标签的鱼群组件
+	UPROPERTY(EditAnywhere, Category = "Boids")
+	FName SourceComponentTag;
+
+	//UObject Interface
+	virtual void PostInitProperties() override;
+	//UObject Interface End
+
+	//UNiagaraDataInterface Interface
+	virtual bool CanExecuteOnTarget(ENiagaraSimTarget Target) const override { return true; }
+	virtual bool InitPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance) override;
+	virtual void DestroyPerInstanceData(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance) override;
+	virtual int32 PerInstanceDataSize() const override;
+	virtual bool PerInstanceTick(void* PerInstanceData, FNiagaraSystemInstance* SystemInstance, float DeltaSeconds) override;
+	virtual bool HasPreSimulateTick() const override { return true; }
+	virtual void ProvidePerInstanceDataForRenderThread(void* DataForRenderThread, void* PerInstanceData, const FNiagaraSystemInstanceID& SystemInstance) override;
+	virtual void GetVMExternalFunction(const FVMExternalFunctionBindingInfo& BindingInfo, void* InstanceData, FVMExternalFunction& OutFunc) override;
+	virtual bool Equals(const UNiagaraDataInterface* Other) const override;
+
+#if WITH_EDITORONLY_DATA
+	virtual void GetCommonHLSL(FString& OutHLSL) override;
+	virtual void GetParameterDefinitionHLSL(const FNiagaraDataInterfaceGPUParamInfo& ParamInfo, FString& OutHLSL) override;
+	virtual bool GetFunctionHLSL(const FNiagaraDataInterfaceGPUParamInfo& ParamInfo, const FNiagaraDataInterfaceGeneratedFunction& FunctionInfo, int FunctionInstanceIndex, FString& OutHLSL) override;
+	virtual bool AppendCompileHash(FNiagaraCompileHashVisitor* InVisitor) const override;
+#endif
+	virtual void BuildShaderParameters(FNiagaraShaderParametersBuilder& ShaderParametersBuilder) const override;
+	virtual void SetShaderParameters(const FNiagaraDataInterfaceSetShaderParametersContext& Context) const override;
+	//UNiagaraDataInterface Interface End
+
+protected:
+#if WITH_EDITORONLY_DATA
+	virtual void GetFunctionsInternal(TArray<FNiagaraFunctionSignature>& OutFunctions) const override;
+#endif
+	virtual bool CopyToInternal(UNiagaraDataInterface* Destination) const override;
+
+private:
+	void VMGetNumBoids(FVectorVMExternalFunctionContext& Context);
+};